@@ -0,0 +1,574 @@
+#ifndef ADC_KERNELS_HPP_
+#define ADC_KERNELS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "BaseAdc.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BP_ADC_KERNELS_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BP_ADC_KERNELS_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define BP_ADC_KERNELS_NEON 1
+#endif
+
+namespace BasePeripheral {
+	namespace Adc {
+		// Ядра обработки блоков результатов АЦП: калибровка, разделение каналов, передискретизация (усреднение),
+		// децимация CIC и FIR. Векторные реализации (AVX2, SSE2 или NEON) выбираются на этапе компиляции;
+		// эталонные скалярные реализации находятся в Kernels::Scalar и дают те же результаты для целочисленных
+		// ядер (для ядер с плавающей точкой - с точностью до порядка суммирования).
+		// Целочисленные ядра рассчитаны на результаты не шире 15 бит (АЦП до 15 разрядов), что позволяет
+		// использовать 16-битную знаковую арифметику SIMD.
+		namespace Kernels {
+			static constexpr uint32_t GainShift = 12; // Дробных бит коэффициента усиления калибровки (формат Q4.12)
+			static constexpr uint32_t FirShift = 15;  // Дробных бит коэффициентов целочисленного FIR (формат Q15)
+
+			namespace Scalar {
+				// Калибровка: out = clamp(((in - offset) * gain) >> GainShift, 0, maxValue) с округлением
+				inline void calibrate(const sample_t* in, sample_t* out, size_t count, int16_t offset, int16_t gain, sample_t maxValue) {
+					for (size_t i = 0; i < count; ++i) {
+						const int32_t product = (static_cast<int32_t>(in[i]) - offset) * gain;
+						int32_t value = (product + (1 << (GainShift - 1))) >> GainShift;
+						value = value < -32768 ? -32768 : value > 32767 ? 32767 : value;
+						out[i] = static_cast<sample_t>(value < 0 ? 0 : value > maxValue ? maxValue : value);
+					}
+				}
+
+				// Калибровка в плавающей точке: out = (in - offset) * gain
+				inline void calibrate(const sample_t* in, float* out, size_t count, float offset, float gain) {
+					for (size_t i = 0; i < count; ++i)
+						out[i] = (static_cast<float>(in[i]) - offset) * gain;
+				}
+
+				// Разделение кадров из channels результатов на отдельные массивы каналов
+				inline void deinterleave(const sample_t* in, size_t frames, uint32_t channels, sample_t* const* out) {
+					for (size_t frame = 0; frame < frames; ++frame)
+						for (uint32_t channel = 0; channel < channels; ++channel)
+							out[channel][frame] = in[frame * channels + channel];
+				}
+
+				// Суммы последовательных групп из factor результатов
+				inline void sumGroups(const sample_t* in, size_t outCount, uint32_t factor, uint32_t* sums) {
+					for (size_t i = 0; i < outCount; ++i) {
+						uint32_t sum = 0;
+						for (uint32_t k = 0; k < factor; ++k)
+							sum += in[i * factor + k];
+						sums[i] = sum;
+					}
+				}
+
+				// Скалярное произведение (целочисленное, Q15) для FIR
+				inline int32_t dot(const int16_t* a, const int16_t* b, size_t count) {
+					int32_t sum = 0;
+					for (size_t i = 0; i < count; ++i)
+						sum += static_cast<int32_t>(a[i]) * b[i];
+					return sum;
+				}
+
+				// Скалярное произведение (плавающая точка) для FIR
+				inline float dot(const float* a, const float* b, size_t count) {
+					float sum = 0.0f;
+					for (size_t i = 0; i < count; ++i)
+						sum += a[i] * b[i];
+					return sum;
+				}
+			}
+
+			// Калибровка смещения и усиления (целочисленная, gain в формате Q4.12). Допускается in == out
+			inline void calibrate(const sample_t* in, sample_t* out, size_t count, int16_t offset, int16_t gain, sample_t maxValue) {
+				size_t i = 0;
+#if defined(BP_ADC_KERNELS_AVX2)
+				{
+					const __m256i vOffset = _mm256_set1_epi16(offset);
+					const __m256i vGain = _mm256_set1_epi16(gain);
+					const __m256i vRound = _mm256_set1_epi32(1 << (GainShift - 1));
+					const __m256i vZero = _mm256_setzero_si256();
+					const __m256i vMax = _mm256_set1_epi16(static_cast<int16_t>(maxValue > 32767 ? 32767 : maxValue));
+					for (; i + 16 <= count; i += 16) {
+						const __m256i d = _mm256_sub_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)), vOffset);
+						const __m256i lo = _mm256_mullo_epi16(d, vGain);
+						const __m256i hi = _mm256_mulhi_epi16(d, vGain);
+						const __m256i p0 = _mm256_srai_epi32(_mm256_add_epi32(_mm256_unpacklo_epi16(lo, hi), vRound), GainShift);
+						const __m256i p1 = _mm256_srai_epi32(_mm256_add_epi32(_mm256_unpackhi_epi16(lo, hi), vRound), GainShift);
+						const __m256i packed = _mm256_min_epi16(_mm256_max_epi16(_mm256_packs_epi32(p0, p1), vZero), vMax);
+						_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+					}
+				}
+#endif
+#if defined(BP_ADC_KERNELS_SSE2)
+				{
+					const __m128i vOffset = _mm_set1_epi16(offset);
+					const __m128i vGain = _mm_set1_epi16(gain);
+					const __m128i vRound = _mm_set1_epi32(1 << (GainShift - 1));
+					const __m128i vZero = _mm_setzero_si128();
+					const __m128i vMax = _mm_set1_epi16(static_cast<int16_t>(maxValue > 32767 ? 32767 : maxValue));
+					for (; i + 8 <= count; i += 8) {
+						const __m128i d = _mm_sub_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), vOffset);
+						const __m128i lo = _mm_mullo_epi16(d, vGain);
+						const __m128i hi = _mm_mulhi_epi16(d, vGain);
+						const __m128i p0 = _mm_srai_epi32(_mm_add_epi32(_mm_unpacklo_epi16(lo, hi), vRound), GainShift);
+						const __m128i p1 = _mm_srai_epi32(_mm_add_epi32(_mm_unpackhi_epi16(lo, hi), vRound), GainShift);
+						const __m128i packed = _mm_min_epi16(_mm_max_epi16(_mm_packs_epi32(p0, p1), vZero), vMax);
+						_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+					}
+				}
+#elif defined(BP_ADC_KERNELS_NEON)
+				{
+					const int16x8_t vOffset = vdupq_n_s16(offset);
+					const int16x4_t vGain = vdup_n_s16(gain);
+					const int16x8_t vZero = vdupq_n_s16(0);
+					const int16x8_t vMax = vdupq_n_s16(static_cast<int16_t>(maxValue > 32767 ? 32767 : maxValue));
+					for (; i + 8 <= count; i += 8) {
+						const int16x8_t d = vsubq_s16(vreinterpretq_s16_u16(vld1q_u16(in + i)), vOffset);
+						const int32x4_t p0 = vrshrq_n_s32(vmull_s16(vget_low_s16(d), vGain), GainShift);
+						const int32x4_t p1 = vrshrq_n_s32(vmull_s16(vget_high_s16(d), vGain), GainShift);
+						const int16x8_t packed = vminq_s16(vmaxq_s16(vcombine_s16(vqmovn_s32(p0), vqmovn_s32(p1)), vZero), vMax);
+						vst1q_u16(out + i, vreinterpretq_u16_s16(packed));
+					}
+				}
+#endif
+				Scalar::calibrate(in + i, out + i, count - i, offset, gain, maxValue);
+			}
+
+			// Калибровка смещения и усиления с преобразованием в плавающую точку
+			inline void calibrate(const sample_t* in, float* out, size_t count, float offset, float gain) {
+				size_t i = 0;
+#if defined(BP_ADC_KERNELS_AVX2)
+				{
+					const __m256 vOffset = _mm256_set1_ps(offset);
+					const __m256 vGain = _mm256_set1_ps(gain);
+					for (; i + 8 <= count; i += 8) {
+						const __m256i x = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)));
+						_mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_sub_ps(_mm256_cvtepi32_ps(x), vOffset), vGain));
+					}
+				}
+#endif
+#if defined(BP_ADC_KERNELS_SSE2)
+				{
+					const __m128 vOffset = _mm_set1_ps(offset);
+					const __m128 vGain = _mm_set1_ps(gain);
+					const __m128i vZero = _mm_setzero_si128();
+					for (; i + 8 <= count; i += 8) {
+						const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+						const __m128 f0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(x, vZero));
+						const __m128 f1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(x, vZero));
+						_mm_storeu_ps(out + i, _mm_mul_ps(_mm_sub_ps(f0, vOffset), vGain));
+						_mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_sub_ps(f1, vOffset), vGain));
+					}
+				}
+#elif defined(BP_ADC_KERNELS_NEON)
+				{
+					const float32x4_t vOffset = vdupq_n_f32(offset);
+					const float32x4_t vGain = vdupq_n_f32(gain);
+					for (; i + 8 <= count; i += 8) {
+						const uint16x8_t x = vld1q_u16(in + i);
+						const float32x4_t f0 = vcvtq_f32_u32(vmovl_u16(vget_low_u16(x)));
+						const float32x4_t f1 = vcvtq_f32_u32(vmovl_u16(vget_high_u16(x)));
+						vst1q_f32(out + i, vmulq_f32(vsubq_f32(f0, vOffset), vGain));
+						vst1q_f32(out + i + 4, vmulq_f32(vsubq_f32(f1, vOffset), vGain));
+					}
+				}
+#endif
+				Scalar::calibrate(in + i, out + i, count - i, offset, gain);
+			}
+
+			// Разделение кадров из channels результатов на отдельные массивы каналов out[0..channels).
+			// Для 2 и 4 каналов используется векторная реализация
+			inline void deinterleave(const sample_t* in, size_t frames, uint32_t channels, sample_t* const* out) {
+				size_t frame = 0;
+#if defined(BP_ADC_KERNELS_SSE2)
+				if (channels == 2 || channels == 4) {
+					// Разделение 8 пар (a, b) на 8 a и 8 b: знаковое расширение половин слов и упаковка без потерь
+					const auto split = [](__m128i x0, __m128i x1, __m128i& even, __m128i& odd) {
+						even = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(x0, 16), 16), _mm_srai_epi32(_mm_slli_epi32(x1, 16), 16));
+						odd = _mm_packs_epi32(_mm_srai_epi32(x0, 16), _mm_srai_epi32(x1, 16));
+					};
+					if (channels == 2) {
+						for (; frame + 8 <= frames; frame += 8) {
+							__m128i a, b;
+							split(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + frame * 2)),
+								_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + frame * 2 + 8)), a, b);
+							_mm_storeu_si128(reinterpret_cast<__m128i*>(out[0] + frame), a);
+							_mm_storeu_si128(reinterpret_cast<__m128i*>(out[1] + frame), b);
+						}
+					}
+					else {
+						for (; frame + 8 <= frames; frame += 8) {
+							const __m128i* src = reinterpret_cast<const __m128i*>(in + frame * 4);
+							__m128i e0, o0, e1, o1, c0, c1, c2, c3;
+							split(_mm_loadu_si128(src), _mm_loadu_si128(src + 1), e0, o0);     // каналы 0/2 и 1/3 кадров 0-3
+							split(_mm_loadu_si128(src + 2), _mm_loadu_si128(src + 3), e1, o1); // каналы 0/2 и 1/3 кадров 4-7
+							split(e0, e1, c0, c2);
+							split(o0, o1, c1, c3);
+							_mm_storeu_si128(reinterpret_cast<__m128i*>(out[0] + frame), c0);
+							_mm_storeu_si128(reinterpret_cast<__m128i*>(out[1] + frame), c1);
+							_mm_storeu_si128(reinterpret_cast<__m128i*>(out[2] + frame), c2);
+							_mm_storeu_si128(reinterpret_cast<__m128i*>(out[3] + frame), c3);
+						}
+					}
+				}
+#elif defined(BP_ADC_KERNELS_NEON)
+				if (channels == 2) {
+					for (; frame + 8 <= frames; frame += 8) {
+						const uint16x8x2_t x = vld2q_u16(in + frame * 2);
+						vst1q_u16(out[0] + frame, x.val[0]);
+						vst1q_u16(out[1] + frame, x.val[1]);
+					}
+				}
+				else if (channels == 4) {
+					for (; frame + 8 <= frames; frame += 8) {
+						const uint16x8x4_t x = vld4q_u16(in + frame * 4);
+						vst1q_u16(out[0] + frame, x.val[0]);
+						vst1q_u16(out[1] + frame, x.val[1]);
+						vst1q_u16(out[2] + frame, x.val[2]);
+						vst1q_u16(out[3] + frame, x.val[3]);
+					}
+				}
+#endif
+				if (frame == frames)
+					return;
+				sample_t* tail[32];
+				if (channels > 32) {
+					for (; frame < frames; ++frame)
+						for (uint32_t channel = 0; channel < channels; ++channel)
+							out[channel][frame] = in[frame * channels + channel];
+					return;
+				}
+				for (uint32_t channel = 0; channel < channels; ++channel)
+					tail[channel] = out[channel] + frame;
+				Scalar::deinterleave(in + frame * channels, frames - frame, channels, tail);
+			}
+
+			// Разделение блока ScanStream::Block на отдельные массивы каналов
+			template <typename Block>
+			inline void deinterleave(const Block& block, sample_t* const* out) {
+				deinterleave(block.data, Block::frames(), Block::channels(), out);
+			}
+
+			// Суммы последовательных групп из factor результатов (векторно для factor 2, 4 и кратных 8)
+			inline void sumGroups(const sample_t* in, size_t outCount, uint32_t factor, uint32_t* sums) {
+				size_t i = 0;
+#if defined(BP_ADC_KERNELS_SSE2)
+				const __m128i ones = _mm_set1_epi16(1);
+				if (factor == 2) {
+					for (; i + 4 <= outCount; i += 4)
+						_mm_storeu_si128(reinterpret_cast<__m128i*>(sums + i),
+							_mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 2)), ones));
+				}
+				else if (factor == 4) {
+					for (; i + 4 <= outCount; i += 4) {
+						const __m128 a = _mm_castsi128_ps(_mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 4)), ones));
+						const __m128 b = _mm_castsi128_ps(_mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 4 + 8)), ones));
+						const __m128i even = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+						const __m128i odd = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+						_mm_storeu_si128(reinterpret_cast<__m128i*>(sums + i), _mm_add_epi32(even, odd));
+					}
+				}
+				else if (factor % 8 == 0) {
+					for (; i < outCount; ++i) {
+						const sample_t* group = in + i * factor;
+						__m128i acc = _mm_setzero_si128();
+						for (uint32_t k = 0; k < factor; k += 8)
+							acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group + k)), ones));
+						acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+						acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+						sums[i] = static_cast<uint32_t>(_mm_cvtsi128_si32(acc));
+					}
+				}
+#elif defined(BP_ADC_KERNELS_NEON)
+				if (factor == 2) {
+					for (; i + 4 <= outCount; i += 4)
+						vst1q_u32(sums + i, vpaddlq_u16(vld1q_u16(in + i * 2)));
+				}
+				else if (factor == 4) {
+					for (; i + 4 <= outCount; i += 4) {
+						const uint32x4_t a = vpaddlq_u16(vld1q_u16(in + i * 4));
+						const uint32x4_t b = vpaddlq_u16(vld1q_u16(in + i * 4 + 8));
+						vst1q_u32(sums + i, vcombine_u32(vpadd_u32(vget_low_u32(a), vget_high_u32(a)), vpadd_u32(vget_low_u32(b), vget_high_u32(b))));
+					}
+				}
+				else if (factor % 8 == 0) {
+					for (; i < outCount; ++i) {
+						const sample_t* group = in + i * factor;
+						uint32x4_t acc = vdupq_n_u32(0);
+						for (uint32_t k = 0; k < factor; k += 8)
+							acc = vpadalq_u16(acc, vld1q_u16(group + k));
+						const uint32x2_t pair = vadd_u32(vget_low_u32(acc), vget_high_u32(acc));
+						sums[i] = vget_lane_u32(vpadd_u32(pair, pair), 0);
+					}
+				}
+#endif
+				Scalar::sumGroups(in + i * factor, outCount - i, factor, sums + i);
+			}
+
+			// Передискретизация: каждые factor результатов заменяются суммой, сдвинутой вправо на shift
+			// (shift = log2(factor) - усреднение, меньше - прирост разрядности), с насыщением до 16 бит.
+			// Входной массив содержит outCount * factor результатов одного канала. Допускается in == out
+			inline void oversample(const sample_t* in, size_t outCount, uint32_t factor, uint32_t shift, sample_t* out) {
+				uint32_t sums[64];
+				for (size_t done = 0; done < outCount;) {
+					const size_t chunk = outCount - done < 64 ? outCount - done : 64;
+					sumGroups(in + done * factor, chunk, factor, sums);
+					for (size_t i = 0; i < chunk; ++i) {
+						const uint32_t value = sums[i] >> shift;
+						out[done + i] = static_cast<sample_t>(value > 0xFFFFu ? 0xFFFFu : value);
+					}
+					done += chunk;
+				}
+			}
+
+			// Передискретизация с усреднением в плавающей точке
+			inline void oversample(const sample_t* in, size_t outCount, uint32_t factor, float* out) {
+				const float scale = 1.0f / static_cast<float>(factor);
+				uint32_t sums[64];
+				for (size_t done = 0; done < outCount;) {
+					const size_t chunk = outCount - done < 64 ? outCount - done : 64;
+					sumGroups(in + done * factor, chunk, factor, sums);
+					for (size_t i = 0; i < chunk; ++i)
+						out[done + i] = static_cast<float>(sums[i]) * scale;
+					done += chunk;
+				}
+			}
+
+			// Скалярное произведение (целочисленное): сумма a[i] * b[i] в 32 битах
+			inline int32_t dot(const int16_t* a, const int16_t* b, size_t count) {
+				size_t i = 0;
+				int32_t sum = 0;
+#if defined(BP_ADC_KERNELS_AVX2)
+				{
+					__m256i acc = _mm256_setzero_si256();
+					for (; i + 16 <= count; i += 16)
+						acc = _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+							_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i))));
+					__m128i half = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+					half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+					half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+					sum += _mm_cvtsi128_si32(half);
+				}
+#endif
+#if defined(BP_ADC_KERNELS_SSE2)
+				{
+					__m128i acc = _mm_setzero_si128();
+					for (; i + 8 <= count; i += 8)
+						acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+							_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i))));
+					acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+					acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+					sum += _mm_cvtsi128_si32(acc);
+				}
+#elif defined(BP_ADC_KERNELS_NEON)
+				{
+					int32x4_t acc = vdupq_n_s32(0);
+					for (; i + 8 <= count; i += 8) {
+						const int16x8_t x = vld1q_s16(a + i);
+						const int16x8_t y = vld1q_s16(b + i);
+						acc = vmlal_s16(acc, vget_low_s16(x), vget_low_s16(y));
+						acc = vmlal_s16(acc, vget_high_s16(x), vget_high_s16(y));
+					}
+					const int32x2_t pair = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+					sum += vget_lane_s32(vpadd_s32(pair, pair), 0);
+				}
+#endif
+				return sum + Scalar::dot(a + i, b + i, count - i);
+			}
+
+			// Скалярное произведение (плавающая точка)
+			inline float dot(const float* a, const float* b, size_t count) {
+				size_t i = 0;
+				float sum = 0.0f;
+#if defined(BP_ADC_KERNELS_AVX2)
+				{
+					__m256 acc = _mm256_setzero_ps();
+					for (; i + 8 <= count; i += 8)
+						acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+					__m128 half = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+					half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+					half = _mm_add_ss(half, _mm_shuffle_ps(half, half, _MM_SHUFFLE(1, 1, 1, 1)));
+					sum += _mm_cvtss_f32(half);
+				}
+#endif
+#if defined(BP_ADC_KERNELS_SSE2)
+				{
+					__m128 acc = _mm_setzero_ps();
+					for (; i + 4 <= count; i += 4)
+						acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+					acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+					acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(1, 1, 1, 1)));
+					sum += _mm_cvtss_f32(acc);
+				}
+#elif defined(BP_ADC_KERNELS_NEON)
+				{
+					float32x4_t acc = vdupq_n_f32(0.0f);
+					for (; i + 4 <= count; i += 4)
+						acc = vmlaq_f32(acc, vld1q_f32(a + i), vld1q_f32(b + i));
+					const float32x2_t pair = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+					sum += vget_lane_f32(vpadd_f32(pair, pair), 0);
+				}
+#endif
+				return sum + Scalar::dot(a + i, b + i, count - i);
+			}
+
+			// Дециматор CIC порядка Order для Channels чередующихся каналов с коэффициентом децимации ratio
+			// (задержка гребенчатых звеньев - 1). Интеграторы работают на частоте входа в 32-битной арифметике
+			// с переполнением (это корректно для CIC), выход имеет усиление ratio^Order и приводится сдвигом outputShift.
+			// При Channels, кратном 4, каналы обрабатываются векторно.
+			template <uint32_t Order, uint32_t Channels>
+			class CicDecimator {
+				static_assert(Order > 0 && Channels > 0, "CIC order and channels count must be positive");
+
+			public:
+				explicit CicDecimator(uint32_t ratio, uint32_t outputShift = 0) : _ratio(ratio != 0 ? ratio : 1), _shift(outputShift) { reset(); }
+
+				// Сбрасывает состояние фильтра
+				void reset() {
+					std::memset(_integrators, 0, sizeof(_integrators));
+					std::memset(_combs, 0, sizeof(_combs));
+					_phase = 0;
+				}
+
+				// Обрабатывает frames кадров и записывает выходные кадры в out. Возвращает количество выходных кадров
+				size_t process(const sample_t* in, size_t frames, int32_t* out) {
+					size_t produced = 0;
+					for (size_t frame = 0; frame < frames; ++frame, in += Channels) {
+						const bool output = ++_phase == _ratio;
+						if (output)
+							_phase = 0;
+						uint32_t channel = 0;
+#if defined(BP_ADC_KERNELS_SSE2)
+						const __m128i zero = _mm_setzero_si128();
+						for (; channel + 4 <= Channels; channel += 4) {
+							__m128i value = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + channel)), zero);
+							for (uint32_t k = 0; k < Order; ++k) {
+								__m128i* integrator = reinterpret_cast<__m128i*>(_integrators[k] + channel);
+								value = _mm_add_epi32(_mm_loadu_si128(integrator), value);
+								_mm_storeu_si128(integrator, value);
+							}
+							if (output) {
+								for (uint32_t k = 0; k < Order; ++k) {
+									__m128i* comb = reinterpret_cast<__m128i*>(_combs[k] + channel);
+									const __m128i delayed = _mm_loadu_si128(comb);
+									_mm_storeu_si128(comb, value);
+									value = _mm_sub_epi32(value, delayed);
+								}
+								_mm_storeu_si128(reinterpret_cast<__m128i*>(out + produced * Channels + channel),
+									_mm_sra_epi32(value, _mm_cvtsi32_si128(static_cast<int>(_shift))));
+							}
+						}
+#elif defined(BP_ADC_KERNELS_NEON)
+						for (; channel + 4 <= Channels; channel += 4) {
+							uint32x4_t value = vmovl_u16(vld1_u16(in + channel));
+							for (uint32_t k = 0; k < Order; ++k) {
+								value = vaddq_u32(vld1q_u32(_integrators[k] + channel), value);
+								vst1q_u32(_integrators[k] + channel, value);
+							}
+							if (output) {
+								for (uint32_t k = 0; k < Order; ++k) {
+									const uint32x4_t delayed = vld1q_u32(_combs[k] + channel);
+									vst1q_u32(_combs[k] + channel, value);
+									value = vsubq_u32(value, delayed);
+								}
+								vst1q_s32(out + produced * Channels + channel,
+									vshlq_s32(vreinterpretq_s32_u32(value), vdupq_n_s32(-static_cast<int32_t>(_shift))));
+							}
+						}
+#endif
+						for (; channel < Channels; ++channel) {
+							uint32_t value = in[channel];
+							for (uint32_t k = 0; k < Order; ++k)
+								value = _integrators[k][channel] += value;
+							if (output) {
+								for (uint32_t k = 0; k < Order; ++k) {
+									const uint32_t delayed = _combs[k][channel];
+									_combs[k][channel] = value;
+									value -= delayed;
+								}
+								out[produced * Channels + channel] = static_cast<int32_t>(value) >> _shift;
+							}
+						}
+						if (output)
+							++produced;
+					}
+					return produced;
+				}
+
+			private:
+				uint32_t _ratio;                           // Коэффициент децимации
+				uint32_t _shift;                           // Сдвиг выхода
+				uint32_t _phase;                           // Номер входного кадра внутри периода децимации
+				uint32_t _integrators[Order][Channels];    // Интеграторы
+				uint32_t _combs[Order][Channels];          // Линии задержки гребенчатых звеньев
+			};
+
+			// Дециматор FIR с Taps коэффициентами и коэффициентом децимации ratio для одного канала.
+			// T - int16_t (коэффициенты Q15, входные и выходные данные - результаты АЦП) или float.
+			// Вход обрабатывается порциями по BlockSize отсчетов через рабочий буфер, в котором окно фильтра
+			// непрерывно, поэтому каждый выходной отсчет - одно векторное скалярное произведение.
+			template <typename T, uint32_t Taps, uint32_t BlockSize = 256>
+			class FirDecimator {
+				static_assert(Taps > 0 && BlockSize > 0, "FIR taps and block size must be positive");
+
+				static constexpr uint32_t PaddedTaps = (Taps + 15u) & ~15u; // Коэффициенты, дополненные нулями до кратного 16
+				static constexpr uint32_t History = Taps - 1;               // Отсчеты предыдущей порции, нужные окну
+
+			public:
+				typedef typename std::conditional<std::is_same<T, float>::value, float, sample_t>::type Input_t;
+
+				// coefficients - Taps коэффициентов h[0..Taps) (для int16_t в формате Q15)
+				FirDecimator(const T* coefficients, uint32_t ratio) : _ratio(ratio != 0 ? ratio : 1) {
+					std::memset(_coefficients, 0, sizeof(_coefficients));
+					for (uint32_t k = 0; k < Taps; ++k)
+						_coefficients[k] = coefficients[Taps - 1 - k]; // Обратный порядок: свертка как скалярное произведение
+					reset();
+				}
+
+				// Сбрасывает состояние фильтра
+				void reset() {
+					std::memset(_window, 0, sizeof(_window));
+					_phase = 0;
+				}
+
+				// Обрабатывает count входных отсчетов и записывает выходные в out. Возвращает количество выходных отсчетов
+				size_t process(const Input_t* in, size_t count, Input_t* out) {
+					size_t produced = 0;
+					while (count != 0) {
+						const uint32_t chunk = count < BlockSize ? static_cast<uint32_t>(count) : BlockSize;
+						for (uint32_t i = 0; i < chunk; ++i)
+							_window[History + i] = static_cast<T>(in[i]);
+						for (uint32_t i = _phase; i < chunk; i += _ratio)
+							out[produced++] = output(dot(_coefficients, _window + i, PaddedTaps));
+						if (_phase >= chunk)
+							_phase -= chunk;
+						else
+							_phase = _phase + (chunk - _phase + _ratio - 1) / _ratio * _ratio - chunk;
+						std::memmove(_window, _window + chunk, History * sizeof(T));
+						in += chunk;
+						count -= chunk;
+					}
+					return produced;
+				}
+
+			private:
+				static sample_t output(int32_t acc) {
+					const int32_t value = (acc + (1 << (FirShift - 1))) >> FirShift;
+					return static_cast<sample_t>(value < 0 ? 0 : value > 0xFFFF ? 0xFFFF : value);
+				}
+				static float output(float acc) { return acc; }
+
+				uint32_t _ratio;                               // Коэффициент децимации
+				uint32_t _phase;                               // Смещение первого выходного отсчета в порции
+				T _coefficients[PaddedTaps];                   // Коэффициенты в обратном порядке
+				T _window[History + BlockSize + PaddedTaps];   // Окно: хвост предыдущей порции и текущая порция
+			};
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef ADC_STREAM_HPP_
+#define ADC_STREAM_HPP_
+
+#include "BaseAdc.hpp"
+#include "DmaStream.hpp"
+
+namespace BasePeripheral {
+	namespace Adc {
+		// Непрерывное сканирование последовательности из Channels каналов с передачей результатов через
+		// циклический канал DMA. Буфер DMA состоит из двух блоков по BlockFrames кадров (кадр - по одному
+		// результату на каждый канал последовательности, в порядке последовательности); заполненный блок
+		// передается приложению целиком, без копирования, как только DMA переходит к другой половине буфера.
+		// AdcController - наследник BaseAdc, DmaController - BaseDma или StaticDma.
+		// Последовательность АЦП должна быть задана заранее (setSequence) и иметь длину Channels.
+		template <typename AdcController, typename DmaController, uint32_t Channels, uint32_t BlockFrames>
+		class ScanStream {
+			static_assert(Channels > 0 && BlockFrames > 0, "Block must contain at least one sample");
+
+		public:
+			static constexpr uint32_t BlockSamples = Channels * BlockFrames; // Количество результатов в блоке
+			static constexpr uint32_t BufferSamples = 2 * BlockSamples;      // Размер буфера DMA
+
+			// Блок результатов: BlockFrames кадров по Channels результатов
+			struct Block {
+				const sample_t* data = nullptr; // Начало блока в буфере DMA
+				uint32_t sequence = 0;          // Порядковый номер блока с момента запуска
+
+				// Результат канала с индексом index в последовательности для кадра frame
+				sample_t at(uint32_t frame, uint32_t index) const { return data[frame * Channels + index]; }
+
+				static constexpr uint32_t frames() { return BlockFrames; }
+				static constexpr uint32_t channels() { return Channels; }
+			};
+
+			// Конструктор. buffer - буфер из BufferSamples результатов, bufferAddress - его адрес на шине DMA
+			// (совпадает с адресом buffer на контроллере, отличается в симуляторе)
+			ScanStream(AdcController& adc, DmaController& dma, Dma::channel_number_t dmaChannel,
+				sample_t* buffer, Dma::address_t bufferAddress, Dma::Priority priority = Dma::Priority::High)
+				: _adc(adc), _dma(dma), _dmaChannel(dmaChannel), _bufferAddress(bufferAddress), _priority(priority),
+				_stream(dma, dmaChannel, buffer) {}
+
+			ScanStream(const ScanStream&) = delete;
+			ScanStream& operator=(const ScanStream&) = delete;
+
+			// Настраивает канал DMA (периферия-память, циклический режим, полуслова) и запускает непрерывное сканирование
+			bool start() {
+				if (_adc.getSequenceLength() != Channels)
+					return false;
+				_dma.disableChannel(_dmaChannel);
+				const Dma::Settings settings(Dma::Direction::PeriphToMemory, Dma::Mode::Circular, _priority,
+					Dma::MemorySettings(_adc.getDataAddress(), Dma::DataAlign::HalfWord, Dma::IncrementMode::NoIncrement),
+					Dma::MemorySettings(_bufferAddress, Dma::DataAlign::HalfWord, Dma::IncrementMode::Increment));
+				if (!_dma.initChannel(_dmaChannel, settings))
+					return false;
+				if (!_adc.setConversionMode(ConversionMode::Continuous) || !_adc.setDmaMode(DmaMode::Circular))
+					return false;
+				if (!_stream.start())
+					return false;
+				return _adc.start();
+			}
+
+			// Останавливает сканирование и канал DMA
+			void stop() {
+				_adc.stop();
+				_adc.setDmaMode(DmaMode::Disabled);
+				_stream.stop();
+			}
+
+			// Получает самый старый заполненный блок. Возвращает false, если заполненных блоков нет
+			bool acquire(Block& block) const {
+				typename Stream_t::Span span;
+				if (!_stream.acquire(span))
+					return false;
+				block.data = span.data;
+				block.sequence = span.sequence;
+				return true;
+			}
+
+			// Возвращает блок, полученный acquire. Возвращает false, если блок был перезаписан во время обработки
+			bool release(const Block& block) {
+				typename Stream_t::Span span;
+				span.data = block.data;
+				span.count = BlockSamples;
+				span.sequence = block.sequence;
+				return _stream.release(span);
+			}
+
+			// Передает все заполненные блоки в handler(const Block&) и возвращает количество обработанных блоков.
+			// Блоки, которые DMA уже начал перезаписывать, не передаются и учитываются как переполнения
+			template <typename Handler>
+			uint32_t poll(Handler&& handler) {
+				uint32_t count = 0;
+				Block block;
+				while (acquire(block)) {
+					if (!isValid(block)) {
+						release(block);
+						continue;
+					}
+					handler(static_cast<const Block&>(block));
+					release(block);
+					++count;
+				}
+				return count;
+			}
+
+			// Возвращает true, если данные блока еще не перезаписываются DMA
+			bool isValid(const Block& block) const {
+				typename Stream_t::Span span;
+				span.sequence = block.sequence;
+				return _stream.isValid(span);
+			}
+
+			// Количество заполненных блоков с момента запуска
+			uint32_t produced() const { return _stream.produced(); }
+
+			// Количество переполнений (потерянных или перезаписанных во время обработки блоков)
+			uint32_t overruns() const { return _stream.overruns(); }
+
+			// Количество ошибок передачи DMA
+			uint32_t errors() const { return _stream.errors(); }
+
+		private:
+			typedef Dma::CircularStream<DmaController, sample_t, BufferSamples> Stream_t;
+
+			AdcController& _adc;             // АЦП
+			DmaController& _dma;             // Контроллер DMA
+			Dma::channel_number_t _dmaChannel; // Канал DMA
+			Dma::address_t _bufferAddress;   // Адрес буфера на шине DMA
+			Dma::Priority _priority;         // Приоритет канала DMA
+			Stream_t _stream;                // Поток половин буфера
+		};
+	}
+}
+
+#endif
@@ -1,12 +1,329 @@
-#include <iostream>
-#include <functional>
+#ifndef ADC_HPP_
+#define ADC_HPP_
+
+#include <utility>
 #include "ControllerPeripheral.hpp"
 #include "SharedMacro.hpp"
 
 namespace BasePeripheral {
 	namespace Adc {
+		// Перечисление разрядности преобразования
+		enum class Resolution : uint32_t {
+			Bits12, // 12 бит
+			Bits10, // 10 бит
+			Bits8,  // 8 бит
+			Bits6   // 6 бит
+		};
+
+		// Перечисление длительности выборки канала (в тактах АЦП)
+		enum class SampleTime : uint32_t {
+			Cycles3,   // 3 такта
+			Cycles15,  // 15 тактов
+			Cycles28,  // 28 тактов
+			Cycles56,  // 56 тактов
+			Cycles84,  // 84 такта
+			Cycles112, // 112 тактов
+			Cycles144, // 144 такта
+			Cycles480  // 480 тактов
+		};
+
+		// Перечисление режимов преобразования
+		enum class ConversionMode : uint32_t {
+			Single,     // Однократное преобразование последовательности
+			Continuous  // Непрерывное преобразование последовательности
+		};
+
+		// Перечисление фронтов внешнего запуска
+		enum class TriggerEdge : uint32_t {
+			Software, // Запуск программно (внешний запуск выключен)
+			Rising,   // Передний фронт сигнала запуска
+			Falling,  // Задний фронт сигнала запуска
+			Both      // Оба фронта сигнала запуска
+		};
+
+		// Перечисление режимов передачи результатов через DMA
+		enum class DmaMode : uint32_t {
+			Disabled, // Запросы DMA выключены
+			OneShot,  // Запросы DMA до завершения передачи DMA
+			Circular  // Непрерывные запросы DMA (для циклического канала)
+		};
+
+		// Перечисление для ошибок АЦП
+		enum class Error : error_t {
+			PeripheralDisabled,  // Переферия АЦП отключена
+			ChannelNumberError,  // Некорректный номер канала
+			SequenceLengthError  // Некорректная длина последовательности преобразования
+		};
+
+		// Источник событий ошибок АЦП (raiseError находит функцию по типу перечисления)
+		constexpr ErrorSource errorSource(Error) { return ErrorSource::Adc; }
+
+		typedef uint32_t channel_number_t;  // Номер канала АЦП
+		typedef uint32_t trigger_source_t;  // Номер источника внешнего запуска (зависит от контроллера)
+		typedef uint16_t sample_t;          // Результат преобразования (выравнивание вправо)
+		typedef uint32_t address_t;         // Адрес на шине
+
+		// Возвращает количество бит результата для разрядности
+		constexpr uint32_t resolutionBits(Resolution resolution) {
+			return 12u - 2u * static_cast<uint32_t>(resolution);
+		}
+
+		// Возвращает длительность выборки в тактах АЦП
+		constexpr uint32_t sampleTimeCycles(SampleTime sampleTime) {
+			return sampleTime == SampleTime::Cycles3 ? 3u :
+				sampleTime == SampleTime::Cycles15 ? 15u :
+				sampleTime == SampleTime::Cycles28 ? 28u :
+				sampleTime == SampleTime::Cycles56 ? 56u :
+				sampleTime == SampleTime::Cycles84 ? 84u :
+				sampleTime == SampleTime::Cycles112 ? 112u :
+				sampleTime == SampleTime::Cycles144 ? 144u : 480u;
+		}
+
+		// Структура для хранения общих настроек АЦП.
+		// Разрядность, режим преобразования, фронт и источник внешнего запуска упакованы в 16 бит.
+		struct Settings {
+			typedef uint16_t raw_t; // Тип упакованного представления настроек
+
+			static constexpr uint32_t ResolutionPos = 0;    // Позиция поля разрядности (2 бита)
+			static constexpr uint32_t ModePos = 2;          // Позиция поля режима преобразования (1 бит)
+			static constexpr uint32_t TriggerEdgePos = 3;   // Позиция поля фронта запуска (2 бита)
+			static constexpr uint32_t TriggerSourcePos = 5; // Позиция поля источника запуска (4 бита)
+
+		private:
+			raw_t _raw; // Упакованные настройки
+
+			// Возвращает значение поля шириной mask
+			constexpr uint32_t getField(uint32_t position, uint32_t mask) const {
+				return (static_cast<uint32_t>(_raw) >> position) & mask;
+			}
+
+			// Записывает значение поля шириной mask
+			constexpr void setField(uint32_t position, uint32_t mask, uint32_t value) {
+				_raw = static_cast<raw_t>((_raw & ~(mask << position)) | ((value & mask) << position));
+			}
+
+		public:
+			// Геттеры для получения настроек
+			constexpr Resolution getResolution() const { return static_cast<Resolution>(getField(ResolutionPos, 3u)); }
+			constexpr ConversionMode getConversionMode() const { return static_cast<ConversionMode>(getField(ModePos, 1u)); }
+			constexpr TriggerEdge getTriggerEdge() const { return static_cast<TriggerEdge>(getField(TriggerEdgePos, 3u)); }
+			constexpr trigger_source_t getTriggerSource() const { return getField(TriggerSourcePos, 0xFu); }
+
+			// Конструктор с параметрами по умолчанию
+			constexpr Settings(
+				Resolution resolution = Resolution::Bits12,
+				ConversionMode mode = ConversionMode::Single,
+				TriggerEdge triggerEdge = TriggerEdge::Software,
+				trigger_source_t triggerSource = 0
+			) : _raw(static_cast<raw_t>(
+				((static_cast<uint32_t>(resolution) & 3u) << ResolutionPos) |
+				((static_cast<uint32_t>(mode) & 1u) << ModePos) |
+				((static_cast<uint32_t>(triggerEdge) & 3u) << TriggerEdgePos) |
+				((triggerSource & 0xFu) << TriggerSourcePos))) {}
+
+			// Упакованное представление
+			constexpr raw_t toRaw() const { return _raw; }
+			static constexpr Settings fromRaw(raw_t raw) {
+				Settings settings;
+				settings._raw = raw;
+				return settings;
+			}
+
+			// Функции билдера для настройки параметров
+			constexpr Settings& setResolution(Resolution resolution) { setField(ResolutionPos, 3u, static_cast<uint32_t>(resolution)); return *this; }
+			constexpr Settings& setConversionMode(ConversionMode mode) { setField(ModePos, 1u, static_cast<uint32_t>(mode)); return *this; }
+			constexpr Settings& setTrigger(TriggerEdge edge, trigger_source_t source = 0) {
+				setField(TriggerEdgePos, 3u, static_cast<uint32_t>(edge));
+				setField(TriggerSourcePos, 0xFu, source);
+				return *this;
+			}
+
+			// Операторы сравнения
+			constexpr bool operator==(const Settings& other) const { return _raw == other._raw; }
+			constexpr bool operator!=(const Settings& other) const { return _raw != other._raw; }
+		};
+
+		// ChannelsCount - количество каналов АЦП, MaxSequenceLength - максимальная длина последовательности
+		// преобразования (регулярной группы). В режиме сканирования каналы последовательности преобразуются
+		// по очереди, результаты (по одному на канал) образуют кадр; в непрерывном режиме кадры идут подряд
+		// и забираются через DMA (см. ScanStream).
+		template <uint32_t ChannelsCount, uint32_t MaxSequenceLength = 16>
 		class BaseAdc : public ControllerPeripheral {
+		public:
+			static constexpr channel_number_t ChannelMaxNumber = ChannelsCount - 1;
+			static constexpr uint32_t SequenceMaxLength = MaxSequenceLength;
+
+			virtual ~BaseAdc() = default;
 
+			// Метод инициализации АЦП
+			virtual void init() override {
+				onEnableClock(); // Включение тактирования АЦП
+			}
+
+			// Метод деинициализации АЦП
+			virtual void deInit() override {
+				onStop();
+				onDisableClock(); // Отключение тактирования АЦП
+			}
+
+			// Метод для установки общих настроек АЦП
+			bool configure(const Settings& settings = Settings()) {
+				if (!isEnabled()) {
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: АЦП отключен
+					return false;
+				}
+				return onSetSettings(settings); // Применение настроек
+			}
+
+			// Метод для получения текущих общих настроек АЦП
+			Settings getSettings() const {
+				return onGetSettings();
+			}
+
+			// Методы изменения отдельных полей общих настроек
+			bool setResolution(Resolution resolution) { return configure(getSettings().setResolution(resolution)); }
+			bool setConversionMode(ConversionMode mode) { return configure(getSettings().setConversionMode(mode)); }
+			bool setTrigger(TriggerEdge edge, trigger_source_t source = 0) { return configure(getSettings().setTrigger(edge, source)); }
+
+			// Методы получения отдельных полей общих настроек
+			Resolution getResolution() const { return getSettings().getResolution(); }
+			ConversionMode getConversionMode() const { return getSettings().getConversionMode(); }
+
+			// Метод для инициализации канала (длительность выборки) с проверкой валидности входных данных
+			bool initChannel(channel_number_t channel, SampleTime sampleTime = SampleTime::Cycles3) {
+				if (!isEnabled()) {
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: АЦП отключен
+					return false;
+				}
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return false;
+				}
+				onSetSampleTime(channel, sampleTime); // Установка длительности выборки
+				return true;
+			}
+
+			// Метод для получения длительности выборки канала
+			SampleTime getSampleTime(channel_number_t channel) {
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return SampleTime::Cycles3;
+				}
+				return onGetSampleTime(channel);
+			}
+
+			// Метод для установки последовательности преобразования из length каналов
+			bool setSequence(const channel_number_t* channels, uint32_t length) {
+				if (!isEnabled()) {
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: АЦП отключен
+					return false;
+				}
+				if (channels == nullptr || length == 0 || length > MaxSequenceLength) {
+					raiseError(Error::SequenceLengthError); // Обработка ошибки: некорректная длина последовательности
+					return false;
+				}
+				for (uint32_t i = 0; i < length; ++i) {
+					if (channels[i] > ChannelMaxNumber) {
+						raiseError(Error::ChannelNumberError, channels[i]); // Обработка ошибки: некорректный номер канала
+						return false;
+					}
+				}
+				onSetSequence(channels, length); // Установка последовательности
+				return true;
+			}
+
+			// Метод для установки последовательности, заданной на этапе компиляции (номера каналов и длина
+			// проверяются static_assert)
+			template <channel_number_t... Channels>
+			bool setSequence() {
+				static_assert(sizeof...(Channels) > 0 && sizeof...(Channels) <= MaxSequenceLength, "Sequence length is out of range");
+				static_assert(((Channels <= ChannelMaxNumber) && ...), "Channel number is out of range");
+				static constexpr channel_number_t channels[] = { Channels... };
+				if (!isEnabled()) {
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: АЦП отключен
+					return false;
+				}
+				onSetSequence(channels, sizeof...(Channels));
+				return true;
+			}
+
+			// Метод для получения длины текущей последовательности
+			uint32_t getSequenceLength() const {
+				return onGetSequenceLength();
+			}
+
+			// Метод для установки режима запросов DMA
+			bool setDmaMode(DmaMode mode) {
+				if (!isEnabled()) {
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: АЦП отключен
+					return false;
+				}
+				onSetDmaMode(mode);
+				return true;
+			}
+
+			// Метод для запуска преобразования последовательности (при программном запуске) или
+			// для разрешения внешнего запуска
+			bool start() {
+				if (!isEnabled()) {
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: АЦП отключен
+					return false;
+				}
+				onStart();
+				return true;
+			}
+
+			// Метод для остановки преобразований
+			void stop() {
+				onStop();
+			}
+
+			// Метод для чтения результата последнего преобразования
+			sample_t readData() {
+				return onReadData();
+			}
+
+			// Метод для получения адреса регистра данных (источник для канала DMA)
+			address_t getDataAddress() const {
+				return onGetDataAddress();
+			}
+
+		protected:
+
+			//Виртуальный метод установки общих настроек АЦП (должен быть реализован в наследнике)
+			virtual bool onSetSettings(const Settings&) = 0;
+
+			//Виртуальный метод получения общих настроек АЦП из аппаратуры (должен быть реализован в наследнике)
+			virtual Settings onGetSettings() const = 0;
+
+			//Виртуальный метод установки длительности выборки канала АЦП (должен быть реализован в наследнике)
+			virtual void onSetSampleTime(channel_number_t, SampleTime) = 0;
+
+			//Виртуальный метод получения длительности выборки канала АЦП (должен быть реализован в наследнике)
+			virtual SampleTime onGetSampleTime(channel_number_t) const = 0;
+
+			//Виртуальный метод установки последовательности преобразования (должен быть реализован в наследнике)
+			virtual void onSetSequence(const channel_number_t* channels, uint32_t length) = 0;
+
+			//Виртуальный метод получения длины последовательности преобразования (должен быть реализован в наследнике)
+			virtual uint32_t onGetSequenceLength() const = 0;
+
+			//Виртуальный метод установки режима запросов DMA (должен быть реализован в наследнике)
+			virtual void onSetDmaMode(DmaMode) = 0;
+
+			//Виртуальный метод запуска преобразований (должен быть реализован в наследнике)
+			virtual void onStart() = 0;
+
+			//Виртуальный метод остановки преобразований (должен быть реализован в наследнике)
+			virtual void onStop() = 0;
+
+			//Виртуальный метод чтения регистра данных (должен быть реализован в наследнике)
+			virtual sample_t onReadData() = 0;
+
+			//Виртуальный метод получения адреса регистра данных (должен быть реализован в наследнике)
+			virtual address_t onGetDataAddress() const = 0;
 		};
 	}
-}
\ No newline at end of file
+}
+
+#endif
@@ -1,10 +1,12 @@
 #ifndef DMA_HPP_
 #define DMA_HPP_
 
-#include <iostream>
-#include <functional>
+#include <utility>
+#include <type_traits>
 #include "ControllerPeripheral.hpp"
+#include "Trace.hpp"
 #include "SharedMacro.hpp"
+#include "Delegate.hpp"
 
 namespace BasePeripheral {
 	namespace Dma {
@@ -45,95 +47,402 @@ namespace BasePeripheral {
 		// Перечисление для ошибок DMA
 		enum class Error : error_t {
 			PeripheralDisabled, // Переферия DMA отключена
-			ChannelNumberError  // Некорректный номер канала
+			ChannelNumberError, // Некорректный номер канала
+			ChannelBusy         // На канале уже выполняется цепочка дескрипторов
 		};
 
+		// Источник событий ошибок DMA
+		constexpr ErrorSource errorSource(Error) { return ErrorSource::Dma; }
+
 		typedef uint32_t address_t;
 
-		// Структура для хранения настроек памяти
+		struct Settings;
+
+		// Образ управляющего регистра канала DMA.
+		// Раскладка битов соответствует типичному регистру CCR: сторона периферии - настройки periphOrMemToMemSrc,
+		// сторона памяти - настройки memoryOrMemToMemDst. Адреса в образ не входят и задаются при применении.
+		// Эта же раскладка используется как упакованное представление Settings.
+		struct ChannelImage {
+			static constexpr uint32_t DirPos = 4;     // Направление: 1 - чтение из памяти (MemoryToPeriph)
+			static constexpr uint32_t CircPos = 5;    // Циклический режим
+			static constexpr uint32_t PincPos = 6;    // Инкремент адреса периферии
+			static constexpr uint32_t MincPos = 7;    // Инкремент адреса памяти
+			static constexpr uint32_t PsizePos = 8;   // Ширина данных периферии (2 бита)
+			static constexpr uint32_t MsizePos = 10;  // Ширина данных памяти (2 бита)
+			static constexpr uint32_t PlPos = 12;     // Приоритет (2 бита)
+			static constexpr uint32_t Mem2MemPos = 14; // Передача память-память
+
+			// Маска всех полей конфигурации в управляющем регистре
+			static constexpr uint32_t ConfigMask = 0x7FF0u;
+
+			uint32_t control = 0; // Значение управляющего регистра (без бита включения канала)
+
+			// Возвращает true, если значение содержит только поля конфигурации с допустимыми значениями:
+			// ширины данных из DataAlign и не более одного из битов направления DIR и MEM2MEM
+			static constexpr bool isValid(uint32_t control) {
+				return (control & ~ConfigMask) == 0 &&
+					((control >> PsizePos) & 3u) <= static_cast<uint32_t>(DataAlign::Word) &&
+					((control >> MsizePos) & 3u) <= static_cast<uint32_t>(DataAlign::Word) &&
+					(control & ((1u << DirPos) | (1u << Mem2MemPos))) != ((1u << DirPos) | (1u << Mem2MemPos));
+			}
+
+			// Строит образ из настроек канала
+			static constexpr ChannelImage fromSettings(const Settings& settings);
+
+			// Восстанавливает настройки канала из образа и адресов
+			constexpr Settings settings(address_t periphOrSrcAddr = 0, address_t memoryOrDstAddr = 0) const;
+
+			constexpr bool operator==(const ChannelImage& other) const { return control == other.control; }
+			constexpr bool operator!=(const ChannelImage& other) const { return control != other.control; }
+		};
+
+		// Структура для хранения настроек памяти.
+		// Выравнивание и режим инкрементации упакованы в один байт рядом с адресом
 		struct MemorySettings {
-			address_t _memAddr;         // Адрес памяти
-			DataAlign _dataAlign;       // Выравнивание данных
-			IncrementMode _incMode;     // Режим инкрементации адресов
+		private:
+			static constexpr uint32_t DataAlignPos = 0; // Позиция поля выравнивания (2 бита)
+			static constexpr uint32_t IncModePos = 2;   // Позиция поля режима инкрементации (1 бит)
+
+			address_t _memAddr; // Адрес памяти
+			uint8_t _flags;     // Упакованные выравнивание данных и режим инкрементации адресов
 
+		public:
 			// Геттеры для получения настроек
-			address_t getAddr() const { return _memAddr; }
-			DataAlign getDataAlign() const { return _dataAlign; }
-			IncrementMode getIncMode() const { return _incMode; }
+			constexpr address_t getAddr() const { return _memAddr; }
+			constexpr DataAlign getDataAlign() const { return static_cast<DataAlign>((_flags >> DataAlignPos) & 3u); }
+			constexpr IncrementMode getIncMode() const { return static_cast<IncrementMode>((_flags >> IncModePos) & 1u); }
 
 			// Конструктор с параметрами по умолчанию
-			MemorySettings(
+			constexpr MemorySettings(
 				address_t memAddr = 0,
 				DataAlign dataAlign = DataAlign::Byte, // Значение по умолчанию для режима
 				IncrementMode incMode = IncrementMode::NoIncrement
-			) : _memAddr(memAddr), _dataAlign(dataAlign), _incMode(incMode) {}
+			) : _memAddr(memAddr), _flags(static_cast<uint8_t>(
+				((static_cast<uint32_t>(dataAlign) & 3u) << DataAlignPos) |
+				((static_cast<uint32_t>(incMode) & 1u) << IncModePos))) {}
 
 			// Функции билдера для настройки параметров
-			MemorySettings& setAddr(address_t memAddr) { _memAddr = memAddr; return *this; }
-			MemorySettings& setDataAlign(DataAlign dataAlign) { _dataAlign = dataAlign; return *this; }
-			MemorySettings& setIncMode(IncrementMode incMode) { _incMode = incMode; return *this; }
+			constexpr MemorySettings& setAddr(address_t memAddr) { _memAddr = memAddr; return *this; }
+			constexpr MemorySettings& setDataAlign(DataAlign dataAlign) {
+				_flags = static_cast<uint8_t>((_flags & ~(3u << DataAlignPos)) | ((static_cast<uint32_t>(dataAlign) & 3u) << DataAlignPos));
+				return *this;
+			}
+			constexpr MemorySettings& setIncMode(IncrementMode incMode) {
+				_flags = static_cast<uint8_t>((_flags & ~(1u << IncModePos)) | ((static_cast<uint32_t>(incMode) & 1u) << IncModePos));
+				return *this;
+			}
 
 			// Операторы сравнения
-			bool operator==(const MemorySettings& other) const {
-				return _memAddr == other._memAddr && _dataAlign == other._dataAlign && _incMode == other._incMode;
+			constexpr bool operator==(const MemorySettings& other) const {
+				return _memAddr == other._memAddr && _flags == other._flags;
 			}
 
-			bool operator!=(const MemorySettings& other) const {
+			constexpr bool operator!=(const MemorySettings& other) const {
 				return !(*this == other);
 			}
 		};
 
-		// Структура для хранения общих настроек DMA
+		// Структура для хранения общих настроек DMA.
+		// Направление, режим, приоритет, выравнивание и инкрементация обеих сторон упакованы в одно слово
+		// с раскладкой ChannelImage; сравнение настроек - сравнение этого слова и двух адресов.
 		struct Settings {
 		private:
-			Direction _direction;                  // Направление передачи данных
-			Mode _mode;                            // Режим работы DMA
-			Priority _priority;                    // Приоритет DMA
-			MemorySettings _periphOrMemToMemSrc;   // Настройки источника данных (периферия или память)
-			MemorySettings _memoryOrMemToMemDst;   // Настройки назначения данных (память)
+			uint32_t _control;            // Упакованные настройки канала (раскладка ChannelImage)
+			address_t _periphOrSrcAddr;   // Адрес источника данных (периферия или память)
+			address_t _memoryOrDstAddr;   // Адрес назначения данных (память)
+
+			// Записывает значение поля шириной mask по позиции position
+			constexpr void setField(uint32_t position, uint32_t mask, uint32_t value) {
+				_control = (_control & ~(mask << position)) | ((value & mask) << position);
+			}
+
+			// Упаковывает направление в биты DIR/MEM2MEM
+			static constexpr uint32_t packDirection(Direction direction) {
+				return direction == Direction::MemoryToPeriph ? 1u << ChannelImage::DirPos :
+					direction == Direction::MemoryToMemory ? 1u << ChannelImage::Mem2MemPos : 0u;
+			}
+
+			// Упаковывает настройки стороны периферии или памяти
+			static constexpr uint32_t packSide(const MemorySettings& memorySettings, uint32_t incPos, uint32_t sizePos) {
+				return ((memorySettings.getIncMode() == IncrementMode::Increment ? 1u : 0u) << incPos) |
+					((static_cast<uint32_t>(memorySettings.getDataAlign()) & 3u) << sizePos);
+			}
 
 		public:
 			// Геттеры для получения настроек
-			Direction getDirection() const { return _direction; }
-			Mode getMode() const { return _mode; }
-			Priority getPriority() const { return _priority; }
-			MemorySettings getPeriphOrMemToMemSrc() const { return _periphOrMemToMemSrc; }
-			MemorySettings getMemoryOrMemToMemDst() const { return _memoryOrMemToMemDst; }
+			constexpr Direction getDirection() const {
+				return (_control & (1u << ChannelImage::Mem2MemPos)) ? Direction::MemoryToMemory :
+					(_control & (1u << ChannelImage::DirPos)) ? Direction::MemoryToPeriph : Direction::PeriphToMemory;
+			}
+			constexpr Mode getMode() const { return (_control & (1u << ChannelImage::CircPos)) ? Mode::Circular : Mode::Normal; }
+			constexpr Priority getPriority() const { return static_cast<Priority>((_control >> ChannelImage::PlPos) & 3u); }
+			constexpr MemorySettings getPeriphOrMemToMemSrc() const {
+				return MemorySettings(_periphOrSrcAddr, static_cast<DataAlign>((_control >> ChannelImage::PsizePos) & 3u),
+					(_control & (1u << ChannelImage::PincPos)) ? IncrementMode::Increment : IncrementMode::NoIncrement);
+			}
+			constexpr MemorySettings getMemoryOrMemToMemDst() const {
+				return MemorySettings(_memoryOrDstAddr, static_cast<DataAlign>((_control >> ChannelImage::MsizePos) & 3u),
+					(_control & (1u << ChannelImage::MincPos)) ? IncrementMode::Increment : IncrementMode::NoIncrement);
+			}
 
 			// Конструктор с параметрами по умолчанию
-			Settings(
+			constexpr Settings(
 				Direction direction = Direction::PeriphToMemory,
 				Mode mode = Mode::Normal,
 				Priority priority = Priority::Low,
 				MemorySettings periphOrMemToMemSrc = MemorySettings(),
 				MemorySettings memoryOrMemToMemDst = MemorySettings()
-			) : _direction(direction), _mode(mode), _priority(priority), _periphOrMemToMemSrc(periphOrMemToMemSrc), _memoryOrMemToMemDst(memoryOrMemToMemDst) {}
+			) : _control(packDirection(direction) |
+					(mode == Mode::Circular ? 1u << ChannelImage::CircPos : 0u) |
+					((static_cast<uint32_t>(priority) & 3u) << ChannelImage::PlPos) |
+					packSide(periphOrMemToMemSrc, ChannelImage::PincPos, ChannelImage::PsizePos) |
+					packSide(memoryOrMemToMemDst, ChannelImage::MincPos, ChannelImage::MsizePos)),
+				_periphOrSrcAddr(periphOrMemToMemSrc.getAddr()),
+				_memoryOrDstAddr(memoryOrMemToMemDst.getAddr()) {}
+
+			// Упакованное представление настроек: образ управляющего регистра и адреса
+			constexpr ChannelImage toImage() const {
+				ChannelImage image;
+				image.control = _control;
+				return image;
+			}
+			static constexpr Settings fromImage(const ChannelImage& image, address_t periphOrSrcAddr, address_t memoryOrDstAddr) {
+				Settings settings;
+				settings._control = image.control & ChannelImage::ConfigMask;
+				settings._periphOrSrcAddr = periphOrSrcAddr;
+				settings._memoryOrDstAddr = memoryOrDstAddr;
+				return settings;
+			}
 
 			// Функции билдера для настройки параметров
-			Settings& setDirection(Direction direction) { _direction = direction; return *this; }
-			Settings& setMode(Mode mode) { _mode = mode; return *this; }
-			Settings& setPriority(Priority priority) { _priority = priority; return *this; }
-			Settings& setPeriphOrMemToMemSrc(MemorySettings memorySettings) { _periphOrMemToMemSrc = memorySettings; return *this; }
-			Settings& setMemoryOrMemToMemDst(MemorySettings memorySettings) { _memoryOrMemToMemDst = memorySettings; return *this; }
+			constexpr Settings& setDirection(Direction direction) {
+				_control = (_control & ~((1u << ChannelImage::DirPos) | (1u << ChannelImage::Mem2MemPos))) | packDirection(direction);
+				return *this;
+			}
+			constexpr Settings& setMode(Mode mode) { setField(ChannelImage::CircPos, 1u, mode == Mode::Circular ? 1u : 0u); return *this; }
+			constexpr Settings& setPriority(Priority priority) { setField(ChannelImage::PlPos, 3u, static_cast<uint32_t>(priority)); return *this; }
+			constexpr Settings& setPeriphOrMemToMemSrc(MemorySettings memorySettings) {
+				_control = (_control & ~((1u << ChannelImage::PincPos) | (3u << ChannelImage::PsizePos))) |
+					packSide(memorySettings, ChannelImage::PincPos, ChannelImage::PsizePos);
+				_periphOrSrcAddr = memorySettings.getAddr();
+				return *this;
+			}
+			constexpr Settings& setMemoryOrMemToMemDst(MemorySettings memorySettings) {
+				_control = (_control & ~((1u << ChannelImage::MincPos) | (3u << ChannelImage::MsizePos))) |
+					packSide(memorySettings, ChannelImage::MincPos, ChannelImage::MsizePos);
+				_memoryOrDstAddr = memorySettings.getAddr();
+				return *this;
+			}
 
 			// Операторы сравнения
-			bool operator==(const Settings& other) const {
-				return _direction == other._direction &&
-					_mode == other._mode &&
-					_priority == other._priority &&
-					_periphOrMemToMemSrc == other._periphOrMemToMemSrc &&
-					_memoryOrMemToMemDst == other._memoryOrMemToMemDst;
+			constexpr bool operator==(const Settings& other) const {
+				return _control == other._control &&
+					_periphOrSrcAddr == other._periphOrSrcAddr &&
+					_memoryOrDstAddr == other._memoryOrDstAddr;
 			}
 
-			bool operator!=(const Settings& other) const {
+			constexpr bool operator!=(const Settings& other) const {
 				return !(*this == other);
 			}
 		};
 
+		constexpr ChannelImage ChannelImage::fromSettings(const Settings& settings) {
+			return settings.toImage();
+		}
+
+		constexpr Settings ChannelImage::settings(address_t periphOrSrcAddr, address_t memoryOrDstAddr) const {
+			return Settings::fromImage(*this, periphOrSrcAddr, memoryOrDstAddr);
+		}
+
 		typedef uint32_t channel_number_t;
 
-		//Максимальное количество каналов в блоке DMA
-		template <uint32_t ChannelsCount> 
+		// Непрерывная таблица настроек Count каналов в виде массивов структур (SoA):
+		// образы управляющих регистров и адреса хранятся раздельными массивами слов,
+		// поэтому сравнение и копирование таблиц выполняются пословно.
+		template <uint32_t Count>
+		class SettingsTable {
+		public:
+			// Возвращает настройки канала
+			constexpr Settings get(channel_number_t channel) const {
+				ChannelImage image;
+				image.control = _control[channel];
+				return Settings::fromImage(image, _periphOrSrcAddr[channel], _memoryOrDstAddr[channel]);
+			}
+
+			// Записывает настройки канала (каналы вне диапазона игнорируются)
+			constexpr void set(channel_number_t channel, const Settings& settings) {
+				if (channel >= Count)
+					return;
+				_control[channel] = settings.toImage().control;
+				_periphOrSrcAddr[channel] = settings.getPeriphOrMemToMemSrc().getAddr();
+				_memoryOrDstAddr[channel] = settings.getMemoryOrMemToMemDst().getAddr();
+			}
+
+			// Доступ к массивам таблицы
+			constexpr const uint32_t* control() const { return _control; }
+			constexpr const address_t* periphOrSrcAddr() const { return _periphOrSrcAddr; }
+			constexpr const address_t* memoryOrDstAddr() const { return _memoryOrDstAddr; }
+
+			// Операторы сравнения
+			constexpr bool operator==(const SettingsTable& other) const {
+				for (uint32_t i = 0; i < Count; ++i)
+					if (_control[i] != other._control[i] ||
+						_periphOrSrcAddr[i] != other._periphOrSrcAddr[i] ||
+						_memoryOrDstAddr[i] != other._memoryOrDstAddr[i])
+						return false;
+				return true;
+			}
+
+			constexpr bool operator!=(const SettingsTable& other) const {
+				return !(*this == other);
+			}
+
+		private:
+			uint32_t _control[Count] = {};          // Образы управляющих регистров
+			address_t _periphOrSrcAddr[Count] = {}; // Адреса периферии (источника)
+			address_t _memoryOrDstAddr[Count] = {}; // Адреса памяти (назначения)
+		};
+
+		// Теневая таблица настроек каналов DMA (кэш конфигурации в ОЗУ).
+		// Настройки хранятся в таблице SettingsTable, маска valid отмечает каналы, настройки которых известны таблице.
+		template <uint32_t ChannelsCount>
+		class ShadowTable {
+		public:
+			// Возвращает true, если настройки канала известны таблице
+			bool isValid(channel_number_t channel) const {
+				return channel < ChannelsCount && ((_valid[channel / 32] >> (channel % 32)) & 1u) != 0;
+			}
+
+			// Возвращает настройки канала из таблицы
+			Settings get(channel_number_t channel) const {
+				return _settings.get(channel);
+			}
+
+			// Сохраняет образ управляющего регистра и адреса канала в таблицу
+			void store(channel_number_t channel, const ChannelImage& image, address_t periphOrSrcAddr, address_t memoryOrDstAddr) {
+				store(channel, image.settings(periphOrSrcAddr, memoryOrDstAddr));
+			}
+
+			// Сохраняет настройки канала в таблицу
+			void store(channel_number_t channel, const Settings& settings) {
+				if (channel >= ChannelsCount)
+					return;
+				_settings.set(channel, settings);
+				_valid[channel / 32] |= 1u << (channel % 32);
+			}
+
+			// Изменяет настройки канала функцией function, если настройки канала известны таблице
+			template <typename Function>
+			void modify(channel_number_t channel, Function&& function) {
+				if (!isValid(channel))
+					return;
+				Settings settings = get(channel);
+				function(settings);
+				_settings.set(channel, settings);
+			}
+
+			// Помечает настройки канала (или всех каналов) как неизвестные
+			void invalidate(channel_number_t channel) {
+				if (channel < ChannelsCount)
+					_valid[channel / 32] &= ~(1u << (channel % 32));
+			}
+			void invalidate() {
+				for (uint32_t& word : _valid)
+					word = 0;
+			}
+
+		private:
+			SettingsTable<ChannelsCount> _settings;          // Настройки каналов
+			uint32_t _valid[(ChannelsCount + 31) / 32] = {};  // Маска каналов с известными настройками
+		};
+
+		// Узел цепочки дескрипторов DMA (scatter-gather): одна передача count элементов шириной width
+		// из src в dst и указатель на следующий узел (nullptr - конец цепочки, указатель на начало - кольцо).
+		// Адреса задаются в терминах источника и приемника; при запуске узла они раскладываются по сторонам
+		// канала согласно его направлению. Ширина и режимы инкрементации упакованы в один байт.
+		struct Descriptor {
+		private:
+			static constexpr uint32_t WidthPos = 0;        // Позиция поля ширины данных (2 бита)
+			static constexpr uint32_t SrcIncrementPos = 2; // Позиция флага инкремента источника
+			static constexpr uint32_t DstIncrementPos = 3; // Позиция флага инкремента приемника
+
+			address_t _src;          // Адрес источника
+			address_t _dst;          // Адрес приемника
+			uint32_t _count;         // Количество элементов данных
+			uint8_t _flags;          // Упакованные ширина данных и режимы инкрементации
+
+		public:
+			const Descriptor* next;  // Следующий узел цепочки
+
+			constexpr Descriptor(
+				address_t src = 0,
+				address_t dst = 0,
+				uint32_t count = 0,
+				DataAlign width = DataAlign::Byte,
+				IncrementMode srcIncrement = IncrementMode::Increment,
+				IncrementMode dstIncrement = IncrementMode::Increment,
+				const Descriptor* nextDescriptor = nullptr
+			) : _src(src), _dst(dst), _count(count), _flags(static_cast<uint8_t>(
+				((static_cast<uint32_t>(width) & 3u) << WidthPos) |
+				((srcIncrement == IncrementMode::Increment ? 1u : 0u) << SrcIncrementPos) |
+				((dstIncrement == IncrementMode::Increment ? 1u : 0u) << DstIncrementPos))), next(nextDescriptor) {}
+
+			// Геттеры для получения параметров узла
+			constexpr address_t getSrc() const { return _src; }
+			constexpr address_t getDst() const { return _dst; }
+			constexpr uint32_t getCount() const { return _count; }
+			constexpr DataAlign getWidth() const { return static_cast<DataAlign>((_flags >> WidthPos) & 3u); }
+			constexpr IncrementMode getSrcIncrement() const {
+				return ((_flags >> SrcIncrementPos) & 1u) ? IncrementMode::Increment : IncrementMode::NoIncrement;
+			}
+			constexpr IncrementMode getDstIncrement() const {
+				return ((_flags >> DstIncrementPos) & 1u) ? IncrementMode::Increment : IncrementMode::NoIncrement;
+			}
+
+			// Настройки сторон источника и приемника
+			constexpr MemorySettings srcSettings() const { return MemorySettings(_src, getWidth(), getSrcIncrement()); }
+			constexpr MemorySettings dstSettings() const { return MemorySettings(_dst, getWidth(), getDstIncrement()); }
+
+			// Функция билдера для связывания узлов
+			constexpr Descriptor& setNext(const Descriptor* nextDescriptor) { next = nextDescriptor; return *this; }
+		};
+
+		// События канала DMA (битовые флаги)
+		namespace Event {
+			constexpr uint32_t HalfTransfer = 1u << 0;     // Передана половина данных
+			constexpr uint32_t TransferComplete = 1u << 1; // Передача завершена
+			constexpr uint32_t TransferError = 1u << 2;    // Ошибка передачи
+			constexpr uint32_t All = HalfTransfer | TransferComplete | TransferError;
+		}
+
+		// Регистры канала DMA для частичного применения образа (битовые флаги)
+		namespace ChannelField {
+			constexpr uint32_t Control = 1u << 0;         // Управляющий регистр (образ ChannelImage)
+			constexpr uint32_t PeriphOrSrcAddr = 1u << 1; // Адрес периферии (источника для память-память)
+			constexpr uint32_t MemoryOrDstAddr = 1u << 2; // Адрес памяти (приемника для память-память)
+			constexpr uint32_t All = Control | PeriphOrSrcAddr | MemoryOrDstAddr;
+		}
+
+		typedef Delegate<void(channel_number_t, uint32_t events)> ChannelEventHandler_t; // Обработчик событий канала
+		// Результат выполнения цепочки дескрипторов
+		enum class ChainStatus : uint8_t {
+			Complete, // Выполнены все узлы
+			Error     // Ошибка передачи: цепочка прервана, канал выключен
+		};
+
+		typedef Delegate<void(channel_number_t, ChainStatus)> ChainCallback_t; // Обработчик завершения цепочки дескрипторов
+
+		// Состояние цепочки дескрипторов канала: текущий узел и обработчик завершения
+		struct ChainState {
+			const Descriptor* current = nullptr; // Выполняемый узел (nullptr - цепочка не запущена)
+			ChainCallback_t onComplete;          // Вызывается после выполнения последнего узла или ошибки передачи
+			bool hardware = false;               // Узлы обходит контроллер: advanceChain цепочку не продвигает
+		};
+
+		// ChannelsCount - максимальное количество каналов в блоке DMA.
+		// ShadowCache - включение теневой таблицы настроек: getSettings и геттеры полей обслуживаются из ОЗУ,
+		// сеттеры поддерживают таблицу в актуальном состоянии (см. resync)
+		template <uint32_t ChannelsCount, bool ShadowCache = false>
 		class BaseDma : public ControllerPeripheral {
 		public:
 			static constexpr channel_number_t ChannelMaxNumber = ChannelsCount - 1;
@@ -152,51 +461,288 @@ namespace BasePeripheral {
 
 			// Метод для инициализации канала с проверкой валидности входных данных
 			bool initChannel(channel_number_t channel, const Settings& settings = Settings()) {
+				BP_TRACE_SCOPE(DmaInitChannel, channel);
+				if (!isEnabled()) {
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: контроллер DMA отключен
+					return false;
+				}
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return false;
+				}
+				return storeSettings(channel, onSetSettings(channel, settings), settings); // Применение настроек к каналу
+			}
+
+			// Метод для инициализации канала, описанного дескриптором Channel<...> (номер канала и образ
+			// управляющего регистра вычислены на этапе компиляции)
+			template <typename ChannelDescriptor>
+			bool initChannel(address_t periphOrSrcAddr, address_t memoryOrDstAddr) {
+				BP_TRACE_SCOPE(DmaInitChannel, ChannelDescriptor::Number);
+				static_assert(ChannelDescriptor::Number <= ChannelMaxNumber, "Channel number is out of range");
+				if (!isEnabled()) {
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: контроллер DMA отключен
+					return false;
+				}
+				const bool result = onApplyChannelImage(ChannelDescriptor::Number, ChannelDescriptor::image, periphOrSrcAddr, memoryOrDstAddr);
+				if constexpr (ShadowCache) {
+					if (result)
+						shadowTable.store(ChannelDescriptor::Number, ChannelDescriptor::image, periphOrSrcAddr, memoryOrDstAddr);
+					else
+						shadowTable.invalidate(ChannelDescriptor::Number);
+				}
+				return result;
+			}
+
+			// Метод для применения образа канала: записываются только регистры, отмеченные в fields (ChannelField),
+			// остальные должны уже совпадать с образом и адресами (например, при переходе между профилями)
+			bool applyChannelImage(channel_number_t channel, const ChannelImage& image, address_t periphOrSrcAddr,
+				address_t memoryOrDstAddr, uint32_t fields = ChannelField::All) {
 				if (!isEnabled()) {
-					onError(Error::PeripheralDisabled); // Обработка ошибки: контроллер DMA отключен
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: контроллер DMA отключен
 					return false;
 				}
 				if (channel > ChannelMaxNumber) {
-					onError(Error::ChannelNumberError); // Обработка ошибки: некорректный номер канала
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
 					return false;
 				}
-				return onSetSettings(channel, settings); // Применение настроек к каналу
+				if ((fields & ChannelField::All) == 0)
+					return true;
+				const bool result = onApplyChannelFields(channel, image, periphOrSrcAddr, memoryOrDstAddr, fields & ChannelField::All);
+				if constexpr (ShadowCache) {
+					if (result)
+						shadowTable.store(channel, image, periphOrSrcAddr, memoryOrDstAddr);
+					else
+						shadowTable.invalidate(channel);
+				}
+				return result;
+			}
+
+			// Метод для получения текущих настроек канала
+			Settings getSettings(channel_number_t channel) const {
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return Settings();
+				}
+				if constexpr (ShadowCache) {
+					if (shadowTable.isValid(channel))
+						return shadowTable.get(channel);
+					const Settings settings = onGetSettings(channel);
+					shadowTable.store(channel, settings);
+					return settings;
+				}
+				return onGetSettings(channel);
+			}
+
+			// Методы получения отдельных полей настроек канала
+			Direction getDirection(channel_number_t channel) const { return getSettings(channel).getDirection(); }
+			Mode getMode(channel_number_t channel) const { return getSettings(channel).getMode(); }
+			Priority getPriority(channel_number_t channel) const { return getSettings(channel).getPriority(); }
+
+			// Метод перечитывания настроек всех каналов из аппаратуры в теневую таблицу
+			// (нужно, если регистры DMA изменялись в обход этого объекта; без ShadowCache ничего не делает)
+			void resync() {
+				if constexpr (ShadowCache) {
+					for (channel_number_t channel = 0; channel <= ChannelMaxNumber; ++channel)
+						shadowTable.store(channel, onGetSettings(channel));
+				}
 			}
 
 			// Метод для установки направления передачи данных с проверкой валидности входных данных
 			void setDirection(channel_number_t channel, Direction direction) {
 				if (channel > ChannelMaxNumber) {
-					onError(Error::ChannelNumberError); // Обработка ошибки: некорректный номер канала
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
 					return;
 				}
 				onSetDirection(channel, direction); // Установка направления передачи данных
+				if constexpr (ShadowCache)
+					shadowTable.modify(channel, [&](Settings& settings) { settings.setDirection(direction); });
 			}
 
 			// Метод для установки режима передачи данных с проверкой валидности входных данных
 			void setMode(channel_number_t channel, Mode mode) {
 				if (channel > ChannelMaxNumber) {
-					onError(Error::ChannelNumberError); // Обработка ошибки: некорректный номер канала
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
 					return;
 				}
 				onSetMode(channel, mode); // Установка режима передачи данных
+				if constexpr (ShadowCache)
+					shadowTable.modify(channel, [&](Settings& settings) { settings.setMode(mode); });
 			}
 
 			// Метод для установки приоритета работы канала с проверкой валидности входных данных
 			void setPriority(channel_number_t channel, Priority priority) {
 				if (channel > ChannelMaxNumber) {
-					onError(Error::ChannelNumberError); // Обработка ошибки: некорректный номер канала
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
 					return;
 				}
 				onSetPriority(channel, priority); // Установка приоритета работы канала
+				if constexpr (ShadowCache)
+					shadowTable.modify(channel, [&](Settings& settings) { settings.setPriority(priority); });
 			}
 
 			// Метод для установки настроек памяти с проверкой валидности входных данных
 			void setMemorySettings(channel_number_t channel, const MemorySettings& src, const MemorySettings& dst) {
 				if (channel > ChannelMaxNumber) {
-					onError(Error::ChannelNumberError); // Обработка ошибки: некорректный номер канала
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
 					return;
 				}
 				onSetMemorySettings(channel, src, dst); // Установка настроек памяти
+				if constexpr (ShadowCache) {
+					shadowTable.modify(channel, [&](Settings& settings) {
+						settings.setPeriphOrMemToMemSrc(src).setMemoryOrMemToMemDst(dst);
+					});
+				}
+			}
+
+			// Метод для установки количества элементов данных для передачи по каналу
+			void setDataCount(channel_number_t channel, uint32_t count) {
+				BP_TRACE_SCOPE(DmaSetDataCount, channel);
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return;
+				}
+				onSetDataCount(channel, count); // Установка количества элементов данных
+			}
+
+			// Метод для получения количества оставшихся для передачи элементов данных
+			uint32_t getDataCount(channel_number_t channel) const {
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return 0;
+				}
+				return onGetDataCount(channel);
+			}
+
+			// Метод для включения передачи данных по каналу
+			bool enableChannel(channel_number_t channel) {
+				BP_TRACE_SCOPE(DmaEnableChannel, channel);
+				if (!isEnabled()) {
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: контроллер DMA отключен
+					return false;
+				}
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return false;
+				}
+				onEnableChannel(channel); // Включение передачи данных
+				return true;
+			}
+
+			// Метод для выключения передачи данных по каналу
+			void disableChannel(channel_number_t channel) {
+				BP_TRACE_SCOPE(DmaDisableChannel, channel);
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return;
+				}
+				onDisableChannel(channel); // Выключение передачи данных
+			}
+
+			// Метод для запуска цепочки дескрипторов на канале. Направление, режим и приоритет канала должны быть
+			// заданы заранее (initChannel); узлы цепочки задают адреса, количество, ширину и инкременты.
+			// onComplete вызывается один раз: после выполнения последнего узла (ChainStatus::Complete) или после
+			// ошибки передачи (ChainStatus::Error). Узлы должны оставаться доступными до завершения цепочки.
+			// Прерывания TransferComplete и TransferError канала разрешаются дополнительно к событиям, заданным
+			// setEvents: по первому программный обход переходит к следующему узлу, по второму цепочка прерывается.
+			// Возвращает false, если на канале уже выполняется цепочка (она продолжает выполняться)
+			bool submitChain(channel_number_t channel, const Descriptor* head, ChainCallback_t onComplete = ChainCallback_t()) {
+				BP_TRACE_SCOPE(DmaSubmitChain, channel);
+				if (!isEnabled()) {
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: контроллер DMA отключен
+					return false;
+				}
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return false;
+				}
+				if (head == nullptr)
+					return false;
+				if (isChainActive(channel)) {
+					raiseError(Error::ChannelBusy, channel); // Обработка ошибки: цепочка канала еще не завершена
+					return false;
+				}
+				constexpr uint32_t chainEvents = Event::TransferComplete | Event::TransferError;
+				if ((eventMasks[channel] & chainEvents) != chainEvents)
+					setEvents(channel, eventMasks[channel] | chainEvents);
+				chains[channel] = ChainState();
+				chains[channel].current = head;
+				chains[channel].onComplete = onComplete;
+				if (!onSubmitChain(channel, head)) {
+					chains[channel] = ChainState();
+					return false;
+				}
+				return true;
+			}
+
+			// Метод перехода к следующему узлу цепочки. Вызывается из обработчика прерывания завершения передачи
+			// канала; при выполнении последнего узла вызывает обработчик завершения цепочки. Цепочки, которые
+			// обходит контроллер (markHardwareChain), не продвигаются. Возвращает true, если запущен следующий узел
+			bool advanceChain(channel_number_t channel) {
+				if (channel > ChannelMaxNumber || chains[channel].current == nullptr || chains[channel].hardware)
+					return false;
+				const Descriptor* next = chains[channel].current->next;
+				if (next == nullptr) {
+					completeChain(channel);
+					return false;
+				}
+				chains[channel].current = next;
+				return onStartDescriptor(channel, *next);
+			}
+
+			// Метод остановки канала с цепочкой дескрипторов без ее завершения (например, при вытеснении передачи):
+			// выключает канал, сбрасывает необработанные флаги событий и состояние цепочки. Обработчик завершения
+			// цепочки не вызывается
+			void cancelChain(channel_number_t channel) {
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return;
+				}
+				onDisableChannel(channel);
+				onClearEvents(channel, Event::All);
+				chains[channel] = ChainState();
+			}
+
+			// Возвращает true, если на канале выполняется цепочка дескрипторов
+			bool isChainActive(channel_number_t channel) const {
+				return channel <= ChannelMaxNumber && chains[channel].current != nullptr;
+			}
+
+			// Метод для разрешения прерываний по событиям канала (маска из флагов Event, остальные события запрещаются)
+			void setEvents(channel_number_t channel, uint32_t events) {
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return;
+				}
+				eventMasks[channel] = events & Event::All;
+				onSetEvents(channel, eventMasks[channel]); // Разрешение прерываний
+			}
+
+			// Метод для установки обработчика событий канала (вызывается из handleInterrupt)
+			void setEventHandler(channel_number_t channel, ChannelEventHandler_t handler) {
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return;
+				}
+				eventHandlers[channel] = handler;
+			}
+
+			// Обработчик прерывания канала (вызывается из вектора прерывания DMA): читает и сбрасывает флаги событий,
+			// по завершению передачи продвигает цепочку дескрипторов, по ошибке передачи прерывает ее,
+			// затем вызывает обработчик событий канала
+			void handleInterrupt(channel_number_t channel) {
+				BP_TRACE_SCOPE(DmaInterrupt, channel);
+				if (channel > ChannelMaxNumber)
+					return;
+				const uint32_t events = onGetEvents(channel);
+				if (events == 0)
+					return;
+				onClearEvents(channel, events);
+				if ((events & Event::TransferError) != 0)
+					failChain(channel);
+				else if ((events & Event::TransferComplete) != 0)
+					advanceChain(channel);
+				if (eventHandlers[channel])
+					eventHandlers[channel](channel, events);
 			}
 
 		protected:
@@ -204,6 +750,22 @@ namespace BasePeripheral {
 			//Виртуальный метод установки настроек канала DMA (должен быть реализован в наследнике)
 			virtual bool onSetSettings(channel_number_t, const Settings&) = 0;
 
+			//Виртуальный метод получения настроек канала DMA из аппаратуры (должен быть реализован в наследнике)
+			virtual Settings onGetSettings(channel_number_t) const = 0;
+
+			//Виртуальный метод применения образа управляющего регистра канала DMA. Реализация по умолчанию
+			//восстанавливает настройки из образа и вызывает onSetSettings; наследник может записать образ в регистр напрямую
+			virtual bool onApplyChannelImage(channel_number_t channel, const ChannelImage& image, address_t periphOrSrcAddr, address_t memoryOrDstAddr) {
+				return onSetSettings(channel, image.settings(periphOrSrcAddr, memoryOrDstAddr));
+			}
+
+			//Виртуальный метод частичного применения образа канала DMA (fields - флаги ChannelField).
+			//Реализация по умолчанию применяет образ целиком; наследник может записать только отмеченные регистры
+			virtual bool onApplyChannelFields(channel_number_t channel, const ChannelImage& image, address_t periphOrSrcAddr,
+				address_t memoryOrDstAddr, uint32_t) {
+				return onApplyChannelImage(channel, image, periphOrSrcAddr, memoryOrDstAddr);
+			}
+
 			//Виртуальный метод установки направления передачи канала DMA (должен быть реализован в наследнике)
 			virtual void onSetDirection(channel_number_t, Direction) = 0;
 
@@ -216,11 +778,92 @@ namespace BasePeripheral {
 			//Виртуальный метод установки настроек памяти канала DMA (должен быть реализован в наследнике)
 			virtual void onSetMemorySettings(channel_number_t, const MemorySettings&, const MemorySettings&) = 0;
 
+			//Виртуальный метод установки количества элементов данных для передачи по каналу DMA (должен быть реализован в наследнике)
+			virtual void onSetDataCount(channel_number_t, uint32_t) = 0;
+
+			//Виртуальный метод получения количества оставшихся элементов данных канала DMA (должен быть реализован в наследнике)
+			virtual uint32_t onGetDataCount(channel_number_t) const = 0;
+
 			//Виртуальный метод включения передачи данных канала DMA (должен быть реализован в наследнике)
 			virtual void onEnableChannel(channel_number_t) = 0;
 
 			//Виртуальный метод выключения передачи данных канала DMA (должен быть реализован в наследнике)
 			virtual void onDisableChannel(channel_number_t) = 0;
+
+			//Виртуальный метод разрешения прерываний по событиям канала DMA (должен быть реализован в наследнике)
+			virtual void onSetEvents(channel_number_t, uint32_t events) = 0;
+
+			//Виртуальный метод получения флагов произошедших разрешенных событий канала DMA (должен быть реализован в наследнике)
+			virtual uint32_t onGetEvents(channel_number_t) const = 0;
+
+			//Виртуальный метод сброса флагов событий канала DMA (должен быть реализован в наследнике)
+			virtual void onClearEvents(channel_number_t, uint32_t events) = 0;
+
+			//Виртуальный метод запуска цепочки дескрипторов. Реализация по умолчанию запускает первый узел, следующие
+			//узлы запускаются программно из advanceChain. Контроллер с аппаратным обходом списков может передать
+			//цепочку аппаратуре, отметить ее markHardwareChain и вызвать completeChain по ее завершении
+			virtual bool onSubmitChain(channel_number_t channel, const Descriptor* head) {
+				return onStartDescriptor(channel, *head);
+			}
+
+			//Виртуальный метод запуска одного узла цепочки. Реализация по умолчанию перепрограммирует адреса,
+			//ширину и количество элементов канала и включает его
+			virtual bool onStartDescriptor(channel_number_t channel, const Descriptor& descriptor) {
+				onDisableChannel(channel);
+				if (getSettings(channel).getDirection() == Direction::MemoryToPeriph)
+					setMemorySettings(channel, descriptor.dstSettings(), descriptor.srcSettings());
+				else
+					setMemorySettings(channel, descriptor.srcSettings(), descriptor.dstSettings());
+				onSetDataCount(channel, descriptor.getCount());
+				return enableChannel(channel);
+			}
+
+			// Отмечает цепочку канала как обходимую контроллером (вызывается из onSubmitChain)
+			void markHardwareChain(channel_number_t channel) {
+				chains[channel].hardware = true;
+			}
+
+			// Завершает цепочку канала и вызывает ее обработчик завершения
+			void completeChain(channel_number_t channel, ChainStatus status = ChainStatus::Complete) {
+				const ChainCallback_t onComplete = chains[channel].onComplete;
+				chains[channel] = ChainState();
+				if (onComplete)
+					onComplete(channel, status);
+			}
+
+			// Прерывает цепочку канала после ошибки передачи: выключает канал и завершает цепочку с ошибкой
+			void failChain(channel_number_t channel) {
+				if (chains[channel].current == nullptr)
+					return;
+				onDisableChannel(channel);
+				completeChain(channel, ChainStatus::Error);
+			}
+
+			// Сохраняет настройки канала в теневую таблицу при успешном применении (без ShadowCache ничего не делает)
+			bool storeSettings(channel_number_t channel, bool applied, const Settings& settings) {
+				if constexpr (ShadowCache) {
+					if (applied)
+						shadowTable.store(channel, settings);
+					else
+						shadowTable.invalidate(channel);
+				}
+				return applied;
+			}
+
+			//Состояние цепочек дескрипторов каналов
+			ChainState chains[ChannelsCount];
+
+			//Обработчики событий каналов
+			ChannelEventHandler_t eventHandlers[ChannelsCount];
+
+			//Разрешенные события каналов (последние значения setEvents)
+			uint32_t eventMasks[ChannelsCount] = {};
+
+			//Теневая таблица настроек каналов (пустая, если ShadowCache выключен)
+			mutable typename std::conditional<ShadowCache, ShadowTable<ChannelsCount>, NoShadowTable>::type shadowTable;
+
+			//Счетчики операций (только при BP_TRACE)
+			BP_TRACE_COUNTERS
 		};
 	}
 }
@@ -1,10 +1,16 @@
 #ifndef GPIO_HPP_
 #define GPIO_HPP_
 
-#include <iostream>
-#include <functional>
+#include <utility>
+#include <type_traits>
 #include "ControllerPeripheral.hpp"
+#include "Trace.hpp"
 #include "SharedMacro.hpp"
+#include "PinMask.hpp"
+#include "PinInterruptTable.hpp"
+#if !BP_FREESTANDING
+#include <functional>
+#endif
 
 namespace BasePeripheral {
 	namespace Gpio {
@@ -43,54 +49,281 @@ namespace BasePeripheral {
 			PinNumberError		// Некорректный номер пина
 		};
 
-		// Структура для хранения настроек GPIO
+		// Блок периферии для событий ошибок (находится через ADL из raiseError)
+		constexpr ErrorSource errorSource(Error) { return ErrorSource::Gpio; }
+
+		// Структура для хранения настроек GPIO.
+		// Все поля упакованы в один байт (по 2 бита на поле), поэтому структура тривиально копируема,
+		// а сравнение настроек сводится к сравнению одного целого.
 		struct Settings
 		{
+			typedef uint8_t raw_t; // Тип упакованного представления настроек
+
+			static constexpr uint32_t ModePos = 0;        // Позиция поля режима
+			static constexpr uint32_t PullPos = 2;        // Позиция поля подтяжки
+			static constexpr uint32_t OutputTypePos = 4;  // Позиция поля типа выхода
+			static constexpr uint32_t OutputSpeedPos = 6; // Позиция поля скорости выхода
+
 		private:
-			Mode _mode;				// Режим порта
-			Pull _pull;             // Настройка подтягивающего резистора
-			OutputType _outputType; // Тип выходного сигнала
-			OutputSpeed _outputSpeed; // Скорость выходного сигнала
+			raw_t _raw; // Упакованные режим, подтяжка, тип и скорость выхода
+
+			// Возвращает значение 2-битного поля
+			constexpr uint32_t getField(uint32_t position) const {
+				return (static_cast<uint32_t>(_raw) >> position) & 3u;
+			}
+
+			// Записывает значение 2-битного поля
+			constexpr void setField(uint32_t position, uint32_t value) {
+				_raw = static_cast<raw_t>((_raw & ~(3u << position)) | ((value & 3u) << position));
+			}
 
 		public:
 			// Геттеры для получения настроек
-			Mode getMode() const { return _mode; }
-			Pull getPull() const { return _pull; }
-			OutputType getOutputType() const { return _outputType; }
-			OutputSpeed getOutputSpeed() const { return _outputSpeed; }
+			constexpr Mode getMode() const { return static_cast<Mode>(getField(ModePos)); }
+			constexpr Pull getPull() const { return static_cast<Pull>(getField(PullPos)); }
+			constexpr OutputType getOutputType() const { return static_cast<OutputType>(getField(OutputTypePos)); }
+			constexpr OutputSpeed getOutputSpeed() const { return static_cast<OutputSpeed>(getField(OutputSpeedPos)); }
 
 			// Конструктор с параметрами по умолчанию
-			Settings(
+			constexpr Settings(
 				Mode mode = Mode::Output, // значение по умолчанию для режима
 				Pull pull = Pull::NoPull, // значение по умолчанию для подтягивающего резистора
 				OutputType outputType = OutputType::PushPull, // значение по умолчанию для типа выходного сигнала
 				OutputSpeed outputSpeed = OutputSpeed::Low // значение по умолчанию для скорости выходного сигнала
-			) : _mode(mode), _pull(pull), _outputType(outputType), _outputSpeed(outputSpeed) {}
+			) : _raw(static_cast<raw_t>(
+				((static_cast<uint32_t>(mode) & 3u) << ModePos) |
+				((static_cast<uint32_t>(pull) & 3u) << PullPos) |
+				((static_cast<uint32_t>(outputType) & 3u) << OutputTypePos) |
+				((static_cast<uint32_t>(outputSpeed) & 3u) << OutputSpeedPos))) {}
+
+			// Упакованное представление настроек
+			constexpr raw_t toRaw() const { return _raw; }
+			static constexpr Settings fromRaw(raw_t raw) {
+				Settings settings;
+				settings._raw = raw;
+				return settings;
+			}
+			// Возвращает true, если поля упакованного представления содержат только значения перечислений
+			// (подтяжка и тип выхода занимают не все значения своих 2-битных полей)
+			static constexpr bool isValidRaw(raw_t raw) {
+				return ((static_cast<uint32_t>(raw) >> PullPos) & 3u) <= static_cast<uint32_t>(Pull::PullDown) &&
+					((static_cast<uint32_t>(raw) >> OutputTypePos) & 3u) <= static_cast<uint32_t>(OutputType::OpenDrain);
+			}
 
 			//Функции билдера
-			Settings& setMode(Mode mode) { _mode = mode; return *this; }
-			Settings& setPull(Pull pull) { _pull = pull; return *this; }
-			Settings& setOutputType(OutputType outputType) { _outputType = outputType; return *this; }
-			Settings& setOutputSpeed(OutputSpeed outputSpeed) { _outputSpeed = outputSpeed; return *this; }
+			constexpr Settings& setMode(Mode mode) { setField(ModePos, static_cast<uint32_t>(mode)); return *this; }
+			constexpr Settings& setPull(Pull pull) { setField(PullPos, static_cast<uint32_t>(pull)); return *this; }
+			constexpr Settings& setOutputType(OutputType outputType) { setField(OutputTypePos, static_cast<uint32_t>(outputType)); return *this; }
+			constexpr Settings& setOutputSpeed(OutputSpeed outputSpeed) { setField(OutputSpeedPos, static_cast<uint32_t>(outputSpeed)); return *this; }
 
 			// Операторы сравнения
-			bool operator==(const Settings& other) const {
-				return _mode == other._mode && _pull == other._pull && _outputType == other._outputType && _outputSpeed == other._outputSpeed;
+			constexpr bool operator==(const Settings& other) const {
+				return _raw == other._raw;
 			}
 
-			bool operator!=(const Settings& other) const {
+			constexpr bool operator!=(const Settings& other) const {
 				return !(*this == other);
 			}
 		};
 
-		typedef uint32_t pin_number_t;  // Тип данных для номера пина
-		typedef std::function<void(pin_number_t)> ExternalInterruptCallback_t;  // Тип функции обратного вызова для внешних прерываний
+		// Непрерывная таблица упакованных настроек Count пинов (по 4 пина в 32-битном слове).
+		// Сравнение и копирование таблиц выполняются пословно.
+		template <uint32_t Count>
+		class SettingsTable {
+		public:
+			static constexpr uint32_t PinsPerWord = 4;                                // Количество пинов в слове
+			static constexpr uint32_t WordsCount = (Count + PinsPerWord - 1) / PinsPerWord; // Количество слов таблицы
+
+			// Возвращает настройки пина
+			constexpr Settings get(pin_number_t pin) const {
+				return Settings::fromRaw(static_cast<Settings::raw_t>(_words[pin / PinsPerWord] >> shift(pin)));
+			}
+
+			// Записывает настройки пина (пины вне диапазона игнорируются)
+			constexpr void set(pin_number_t pin, const Settings& settings) {
+				if (pin >= Count)
+					return;
+				uint32_t& word = _words[pin / PinsPerWord];
+				word = (word & ~(0xFFu << shift(pin))) | (static_cast<uint32_t>(settings.toRaw()) << shift(pin));
+			}
+
+			// Возвращает маску пинов, настройки которых отличаются от настроек в таблице other
+			PinMask<Count> diff(const SettingsTable& other) const {
+				PinMask<Count> result;
+				for (uint32_t i = 0; i < WordsCount; ++i) {
+					uint32_t changed = _words[i] ^ other._words[i];
+					while (changed != 0) {
+						const uint32_t byte = Bits::countTrailingZeros(changed) / 8;
+						result.set(i * PinsPerWord + byte);
+						changed &= ~(0xFFu << (byte * 8));
+					}
+				}
+				return result;
+			}
+
+			// Доступ к словам таблицы
+			constexpr const uint32_t* data() const { return _words; }
+			constexpr uint32_t* data() { return _words; }
+
+			// Операторы сравнения
+			constexpr bool operator==(const SettingsTable& other) const {
+				for (uint32_t i = 0; i < WordsCount; ++i)
+					if (_words[i] != other._words[i])
+						return false;
+				return true;
+			}
+
+			constexpr bool operator!=(const SettingsTable& other) const {
+				return !(*this == other);
+			}
+
+		private:
+			// Сдвиг байта настроек пина внутри слова
+			static constexpr uint32_t shift(pin_number_t pin) { return (pin % PinsPerWord) * 8; }
+
+			uint32_t _words[WordsCount] = {}; // Упакованные настройки пинов
+		};
+
+		// Образ регистров конфигурации порта, вычисляемый на этапе компиляции.
+		// Поля режима, подтяжки и скорости занимают по 2 бита на пин, тип выхода - 1 бит на пин;
+		// коды полей совпадают со значениями перечислений (раскладка регистров MODER/PUPDR/OSPEEDR/OTYPER).
+		// fieldMask/pins отмечают пины, входящие в образ: наследник может применить образ одной
+		// операцией чтения-модификации-записи на регистр, а регистры, не отмеченные в registers, пропустить.
+		template <uint32_t IOCount>
+		struct PortImage {
+			static constexpr uint32_t FieldWordsCount = (IOCount * 2 + 31) / 32; // Количество слов 2-битных полей
+
+			// Регистры конфигурации, затрагиваемые образом (битовые флаги registers)
+			static constexpr uint32_t ModeRegister = 1u << 0;
+			static constexpr uint32_t PullRegister = 1u << 1;
+			static constexpr uint32_t OutputSpeedRegister = 1u << 2;
+			static constexpr uint32_t OutputTypeRegister = 1u << 3;
+			static constexpr uint32_t AllRegisters = ModeRegister | PullRegister | OutputSpeedRegister | OutputTypeRegister;
+
+			uint32_t mode[FieldWordsCount] = {};        // Образ регистра режима
+			uint32_t pull[FieldWordsCount] = {};        // Образ регистра подтяжки
+			uint32_t outputSpeed[FieldWordsCount] = {}; // Образ регистра скорости выхода
+			uint32_t fieldMask[FieldWordsCount] = {};   // Маска 2-битных полей пинов, входящих в образ
+			PinMask<IOCount> outputType;                // Образ регистра типа выхода
+			PinMask<IOCount> pins;                      // Маска пинов, входящих в образ
+			uint32_t registers = 0;                     // Регистры, которые нужно записать
+
+			// Добавляет в образ настройки пина (пины вне диапазона игнорируются)
+			constexpr PortImage& add(pin_number_t pin, const Settings& settings) {
+				if (pin >= IOCount)
+					return *this;
+				const uint32_t word = pin / 16;
+				const uint32_t shift = (pin % 16) * 2;
+				mode[word] = (mode[word] & ~(3u << shift)) | ((static_cast<uint32_t>(settings.getMode()) & 3u) << shift);
+				pull[word] = (pull[word] & ~(3u << shift)) | ((static_cast<uint32_t>(settings.getPull()) & 3u) << shift);
+				outputSpeed[word] = (outputSpeed[word] & ~(3u << shift)) | ((static_cast<uint32_t>(settings.getOutputSpeed()) & 3u) << shift);
+				fieldMask[word] |= 3u << shift;
+				outputType.set(pin, settings.getOutputType() == OutputType::OpenDrain);
+				pins.set(pin);
+				registers = AllRegisters;
+				return *this;
+			}
+
+			// Образ перехода от конфигурации from к конфигурации to: в образ входят только пины с измененными
+			// настройками, а в registers - только регистры, в которых меняется хотя бы одно поле
+			static PortImage delta(const SettingsTable<IOCount>& from, const SettingsTable<IOCount>& to) {
+				PortImage image;
+				uint32_t changed = 0;
+				to.diff(from).forEach([&](pin_number_t pin) {
+					const Settings before = from.get(pin);
+					const Settings after = to.get(pin);
+					image.add(pin, after);
+					changed |= (before.getMode() != after.getMode() ? ModeRegister : 0u) |
+						(before.getPull() != after.getPull() ? PullRegister : 0u) |
+						(before.getOutputSpeed() != after.getOutputSpeed() ? OutputSpeedRegister : 0u) |
+						(before.getOutputType() != after.getOutputType() ? OutputTypeRegister : 0u);
+				});
+				image.registers = changed;
+				return image;
+			}
+
+			// Восстанавливает настройки пина из образа
+			constexpr Settings settings(pin_number_t pin) const {
+				const uint32_t word = pin / 16;
+				const uint32_t shift = (pin % 16) * 2;
+				return Settings(
+					static_cast<Mode>((mode[word] >> shift) & 3u),
+					static_cast<Pull>((pull[word] >> shift) & 3u),
+					outputType.test(pin) ? OutputType::OpenDrain : OutputType::PushPull,
+					static_cast<OutputSpeed>((outputSpeed[word] >> shift) & 3u));
+			}
+		};
+
+		// Теневая таблица настроек пинов (кэш конфигурации в ОЗУ).
+		// Настройки хранятся в упакованной таблице SettingsTable (один байт на пин),
+		// маска valid отмечает пины, настройки которых известны таблице.
+		template <uint32_t IOCount>
+		class ShadowTable {
+		public:
+			// Возвращает true, если настройки пина известны таблице
+			bool isValid(pin_number_t pin) const { return _valid.test(pin); }
+
+			// Возвращает настройки пина из таблицы
+			Settings get(pin_number_t pin) const { return _settings.get(pin); }
+
+			// Сохраняет настройки пина в таблицу
+			void store(pin_number_t pin, const Settings& settings) {
+				if (pin >= IOCount)
+					return;
+				_settings.set(pin, settings);
+				_valid.set(pin);
+			}
+
+			// Изменяет настройки пина функцией function, если настройки пина известны таблице
+			template <typename Function>
+			void modify(pin_number_t pin, Function&& function) {
+				if (!isValid(pin))
+					return;
+				Settings settings = _settings.get(pin);
+				function(settings);
+				_settings.set(pin, settings);
+			}
+
+			// Помечает настройки пина (или всех пинов) как неизвестные
+			void invalidate(pin_number_t pin) { _valid.reset(pin); }
+			void invalidate() { _valid.reset(); }
+
+		private:
+			SettingsTable<IOCount> _settings; // Упакованные настройки пинов
+			PinMask<IOCount> _valid;          // Маска пинов с известными настройками
+		};
 
-		template <uint32_t IOCount> // Максимальный номер пина
+		// Тип функции обратного вызова для внешних прерываний. В профиле BP_FREESTANDING - невыделяющий делегат
+		// (лямбда с захватом передается через Delegate::bind и должна жить дольше порта)
+#if BP_FREESTANDING
+		typedef Delegate<void(pin_number_t)> ExternalInterruptCallback_t;
+#else
+		typedef std::function<void(pin_number_t)> ExternalInterruptCallback_t;
+#endif
+
+		// IOCount - количество пинов порта.
+		// ShadowCache - включение теневой таблицы настроек: геттеры настроек обслуживаются из ОЗУ без обращения
+		// к наследнику, сеттеры поддерживают таблицу в актуальном состоянии (см. resync)
+		//
+		// Параллельный доступ (потоки, прерывания). BaseGpio не использует блокировок; атомарность операций
+		// определяется обработчиками наследника:
+		// - setPin/resetPin/writePins/setPins/resetPins сводятся к onSetPin/onResetPin/onWritePins, которые должны быть
+		//   одной записью в регистр установки/сброса (BSRR) и поэтому не теряют изменения других пинов;
+		// - togglePin/togglePins атомарны, если наследник переопределяет onTogglePin/onTogglePins атомарной операцией
+		//   (например, записью в регистр переключения или атомарным XOR); реализации по умолчанию читают выход и
+		//   записывают BSRR, поэтому одновременное переключение одного и того же пина может потерять изменение;
+		// - setMode/setPull/setOutputType/setOutputSpeed/updateSettings изменяют поле общего регистра настроек и
+		//   атомарны, только если обработчики наследника выполняют чтение-изменение-запись атомарно
+		//   (LDREX/STREX, bit-banding, compare-and-swap); теневая таблица (ShadowCache) при этом не защищена,
+		//   поэтому при параллельной настройке пинов ее следует выключать;
+		// - чтение состояния пинов и порта не изменяет состояния и безопасно всегда.
+		template <uint32_t IOCount, bool ShadowCache = false>
 		class BaseGpio : public ControllerPeripheral {
 		public:
 			static constexpr pin_number_t PinMaxNumber = IOCount - 1;
 
+			typedef PinMask<IOCount> Mask; // Маска пинов порта
+
 			virtual ~BaseGpio() = default;
 
 			// Метод инициализации контроллера DMA
@@ -105,104 +338,303 @@ namespace BasePeripheral {
 
 			// Инициализирует пин с указанными настройками
 			bool initPin(pin_number_t pin, const Settings& settings = Settings()) {
+				BP_TRACE_SCOPE(GpioInitPin, pin);
 				if(!isEnabled()){
-					onError(Error::PeripheralDisabled); // Обработка ошибки: контроллер DMA отключен
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: контроллер DMA отключен
 					return false;
 				}
 				if (pin > PinMaxNumber) {
-					onError(Error::PinNumberError); // Обработка ошибки: некорректный номер пина
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
 					return false;
 				}
 
-				return onSetSettings(pin, settings);
+				return storeSettings(pin, onSetSettings(pin, settings), settings);
+			}
+
+			// Инициализирует пин, описанный дескриптором Pin<...> (номер пина проверен на этапе компиляции)
+			template <typename PinDescriptor>
+			bool initPin() {
+				BP_TRACE_SCOPE(GpioInitPin, PinDescriptor::Number);
+				static_assert(PinDescriptor::Number <= PinMaxNumber, "Pin number is out of range");
+				if (!isEnabled()) {
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: контроллер GPIO отключен
+					return false;
+				}
+				return storeSettings(PinDescriptor::Number, onSetSettings(PinDescriptor::Number, PinDescriptor::settings()), PinDescriptor::settings());
+			}
+
+			// Инициализирует группу пинов, описанную конфигурацией PortConfig<...>
+			template <typename Config>
+			bool initPins() {
+				static_assert(Config::IOCount == IOCount, "Port configuration does not match the port");
+				return applyImage(Config::image);
+			}
+
+			// Инициализирует группу пинов по заранее вычисленному образу регистров (см. PortConfig)
+			bool applyImage(const PortImage<IOCount>& image) {
+				if (!isEnabled()) {
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: контроллер GPIO отключен
+					return false;
+				}
+				const bool result = onApplyImage(image);
+				if constexpr (ShadowCache) {
+					image.pins.forEach([&](pin_number_t pin) {
+						storeSettings(pin, result, image.settings(pin));
+					});
+				}
+				return result;
 			}
 
 			// Обновляет настройки указанного пина
 			virtual bool updateSettings(pin_number_t pin, const Settings& settings = Settings()) {
 				if (!isEnabled()) {
-					onError(Error::PeripheralDisabled); // Обработка ошибки: контроллер DMA отключен
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: контроллер DMA отключен
 					return false;
 				}
 				if (pin > PinMaxNumber) {
-					onError(Error::PinNumberError); // Обработка ошибки: некорректный номер пина
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
 					return false;
 				}
 
-				return onUpdateSettings(pin, settings);
+				return storeSettings(pin, onUpdateSettings(pin, settings), settings);
 			};
 
 			// Возвращает текущие настройки указанного пина
 			virtual Settings getSettings(pin_number_t pin) const {
-				if (pin > PinMaxNumber)
-					onError(Error::PinNumberError); // Обработка ошибки: некорректный номер пина
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return Settings();
+				}
 
+				if constexpr (ShadowCache) {
+					if (shadowTable.isValid(pin))
+						return shadowTable.get(pin);
+					const Settings settings = onGetSettings(pin);
+					shadowTable.store(pin, settings);
+					return settings;
+				}
 				return onGetSettings(pin);
 			};
 
+			// Возвращает режим работы указанного пина
+			Mode getMode(pin_number_t pin) const {
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return Mode();
+				}
+				if constexpr (ShadowCache) {
+					if (shadowTable.isValid(pin))
+						return shadowTable.get(pin).getMode();
+				}
+				return onGetMode(pin);
+			}
+
+			// Возвращает подтяжку указанного пина
+			Pull getPull(pin_number_t pin) const {
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return Pull();
+				}
+				if constexpr (ShadowCache) {
+					if (shadowTable.isValid(pin))
+						return shadowTable.get(pin).getPull();
+				}
+				return onGetPull(pin);
+			}
+
+			// Возвращает тип выходного сигнала указанного пина
+			OutputType getOutputType(pin_number_t pin) const {
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return OutputType();
+				}
+				if constexpr (ShadowCache) {
+					if (shadowTable.isValid(pin))
+						return shadowTable.get(pin).getOutputType();
+				}
+				return onGetOutputType(pin);
+			}
+
+			// Возвращает скорость выходного сигнала указанного пина
+			OutputSpeed getOutputSpeed(pin_number_t pin) const {
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return OutputSpeed();
+				}
+				if constexpr (ShadowCache) {
+					if (shadowTable.isValid(pin))
+						return shadowTable.get(pin).getOutputSpeed();
+				}
+				return onGetOutputSpeed(pin);
+			}
+
+			// Перечитывает настройки всех пинов из аппаратуры в теневую таблицу
+			// (нужно, если регистры порта изменялись в обход этого объекта; без ShadowCache ничего не делает)
+			void resync() {
+				if constexpr (ShadowCache) {
+					for (pin_number_t pin = 0; pin <= PinMaxNumber; ++pin)
+						shadowTable.store(pin, onGetSettings(pin));
+				}
+			}
+
 			// Устанавливает логическую единицу на указанном пине
 			void setPin(pin_number_t pin) {
-				if (pin > PinMaxNumber)
-					onError(Error::PinNumberError); // Обработка ошибки: некорректный номер пина
+				BP_TRACE_SCOPE(GpioSetPin, pin);
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return;
+				}
 				onSetPin(pin);
 			}
 
 			// Устанавливает логический ноль на указанном пине
 			void resetPin(pin_number_t pin) {
-				if (pin > PinMaxNumber)
-					onError(Error::PinNumberError); // Обработка ошибки: некорректный номер пина
+				BP_TRACE_SCOPE(GpioResetPin, pin);
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return;
+				}
 				onResetPin(pin);
 			}
 
 			// Переключает состояние указанного пина на противоположное
 			void togglePin(pin_number_t pin) {
-				if (pin > PinMaxNumber)
-					onError(Error::PinNumberError); // Обработка ошибки: некорректный номер пина
-				if(onGetPinOutput(pin))
-					onResetPin(pin);
-				else
-					onSetPin(pin);
+				BP_TRACE_SCOPE(GpioTogglePin, pin);
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return;
+				}
+				onTogglePin(pin);
+			}
+
+			// Быстрый путь для пина, номер которого известен на этапе компиляции: номер проверяется static_assert,
+			// поэтому проверки во время выполнения и обработка ошибок не выполняются (setPin<3>() - одна запись в порт)
+			template <pin_number_t Pin>
+			void setPin() {
+				BP_TRACE_SCOPE(GpioSetPin, Pin);
+				static_assert(Pin <= PinMaxNumber, "Pin number is out of range");
+				onSetPin(Pin);
+			}
+
+			template <pin_number_t Pin>
+			void resetPin() {
+				BP_TRACE_SCOPE(GpioResetPin, Pin);
+				static_assert(Pin <= PinMaxNumber, "Pin number is out of range");
+				onResetPin(Pin);
+			}
+
+			template <pin_number_t Pin>
+			void togglePin() {
+				BP_TRACE_SCOPE(GpioTogglePin, Pin);
+				static_assert(Pin <= PinMaxNumber, "Pin number is out of range");
+				onTogglePin(Pin);
+			}
+
+			template <pin_number_t Pin>
+			bool readPinInput() {
+				BP_TRACE_SCOPE(GpioReadPin, Pin);
+				static_assert(Pin <= PinMaxNumber, "Pin number is out of range");
+				return onGetPinInput(Pin);
 			}
 
 			// Читает текущее входное состояние указанного пина
 			virtual bool readPinInput(pin_number_t pin) {
-				if (pin > PinMaxNumber)
-					onError(Error::PinNumberError); // Обработка ошибки: некорректный номер пина
+				BP_TRACE_SCOPE(GpioReadPin, pin);
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return false;
+				}
 				return onGetPinInput(pin);
 			}
 
 			// Читает текущее входное состояние указанного пина
 			virtual bool readPinOutput(pin_number_t pin) {
-				if (pin > PinMaxNumber)
-					onError(Error::PinNumberError); // Обработка ошибки: некорректный номер пина
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return false;
+				}
 				return onGetPinOutput(pin);
 			}
 
 			// Устанавливает тип подтяжки для пина
 			virtual void setPull(pin_number_t pin, Pull pull) {
-				if (pin > PinMaxNumber)
-					onError(Error::PinNumberError); // Обработка ошибки: некорректный номер пина
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return;
+				}
 				onSetPull(pin, pull);
+				if constexpr (ShadowCache)
+					shadowTable.modify(pin, [&](Settings& settings) { settings.setPull(pull); });
 			}
 
 			// Устанавливает режим работы пина
 			virtual void setMode(pin_number_t pin, Mode mode) {
-				if (pin > PinMaxNumber)
-					onError(Error::PinNumberError); // Обработка ошибки: некорректный номер пина
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return;
+				}
 				onSetMode(pin, mode);
+				if constexpr (ShadowCache)
+					shadowTable.modify(pin, [&](Settings& settings) { settings.setMode(mode); });
 			}
 
 			// Устанавливает тип выходного сигнала пина
 			virtual void setOutputType(pin_number_t pin, OutputType outputType) {
-				if (pin > PinMaxNumber)
-					onError(Error::PinNumberError); // Обработка ошибки: некорректный номер пина
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return;
+				}
 				onSetOutputType(pin, outputType);
+				if constexpr (ShadowCache)
+					shadowTable.modify(pin, [&](Settings& settings) { settings.setOutputType(outputType); });
 			}
 
 			// Устанавливает выходную скорость работы пина
 			virtual void setOutputSpeed(pin_number_t pin, OutputSpeed speed) {
-				if (pin > PinMaxNumber)
-					onError(Error::PinNumberError); // Обработка ошибки: некорректный номер пина
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return;
+				}
 				onSetOutputSpeed(pin, speed);
+				if constexpr (ShadowCache)
+					shadowTable.modify(pin, [&](Settings& settings) { settings.setOutputSpeed(speed); });
+			}
+
+			// Групповые операции над пинами порта.
+			// Биты маски за пределами IOCount отбрасываются самой маской, поэтому проверка номеров пинов не требуется.
+			//
+			// Записывает значения values в пины, отмеченные в mask (остальные пины не изменяются)
+			void writePins(const Mask& mask, const Mask& values) {
+				BP_TRACE_SCOPE(GpioWritePins, mask.word(0));
+				onWritePins(mask, values & mask);
+			}
+
+			// Устанавливает логическую единицу на всех пинах маски
+			void setPins(const Mask& mask) {
+				BP_TRACE_SCOPE(GpioWritePins, mask.word(0));
+				onWritePins(mask, mask);
+			}
+
+			// Устанавливает логический ноль на всех пинах маски
+			void resetPins(const Mask& mask) {
+				BP_TRACE_SCOPE(GpioWritePins, mask.word(0));
+				onWritePins(mask, Mask());
+			}
+
+			// Переключает состояние всех пинов маски на противоположное
+			void togglePins(const Mask& mask) {
+				BP_TRACE_SCOPE(GpioTogglePins, mask.word(0));
+				onTogglePins(mask);
+			}
+
+			// Читает входное состояние всего порта
+			Mask readPort() {
+				return onReadPortInput();
+			}
+
+			// Читает выходное состояние всего порта
+			Mask readPortOutput() {
+				return onReadPortOutput();
 			}
 
 			// Устанавливает внешний обработчик прерываний
@@ -215,10 +647,30 @@ namespace BasePeripheral {
 				interruptCallback = nullptr;
 			}
 
+			// Устанавливает невыделяющий обработчик прерывания для указанного пина
+			bool setPinInterruptHandler(pin_number_t pin, PinInterruptHandler_t handler) {
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return false;
+				}
+				pinInterruptHandlers.attach(pin, handler);
+				return true;
+			}
+
+			// Удаляет обработчик прерывания указанного пина
+			void clearPinInterruptHandler(pin_number_t pin) {
+				pinInterruptHandlers.detach(pin);
+			}
+
 		protected:
-			// Возвращает битовую маску для указанного пина
+			// Возвращает битовую маску указанного пина внутри 32-битного слова порта
 			static constexpr uint32_t getPinMask(pin_number_t pin) {
-				return 1 << pin;
+				return static_cast<uint32_t>(1) << (pin % Mask::WordBits);
+			}
+
+			// Возвращает номер 32-битного слова порта, в котором находится указанный пин
+			static constexpr uint32_t getPinWordIndex(pin_number_t pin) {
+				return pin / Mask::WordBits;
 			}
 
 			//Виртуальные функции применения настроек
@@ -226,17 +678,43 @@ namespace BasePeripheral {
 			//Виртуальный метод установки настроек пина GPIO (должен быть реализован в наследнике)
 			virtual bool onSetSettings(pin_number_t, const Settings&) = 0;
 
+			//Виртуальный метод применения образа регистров конфигурации. Реализация по умолчанию применяет настройки
+			//попиново через onSetSettings (образ частичной перенастройки - только измененными полями);
+			//наследник может переопределить ее записью образа целиком в регистры порта
+			virtual bool onApplyImage(const PortImage<IOCount>& image) {
+				if (image.registers != PortImage<IOCount>::AllRegisters) {
+					typedef PortImage<IOCount> Image;
+					image.pins.forEach([&](pin_number_t pin) {
+						const Settings settings = image.settings(pin);
+						if ((image.registers & Image::ModeRegister) != 0)
+							onSetMode(pin, settings.getMode());
+						if ((image.registers & Image::PullRegister) != 0)
+							onSetPull(pin, settings.getPull());
+						if ((image.registers & Image::OutputSpeedRegister) != 0)
+							onSetOutputSpeed(pin, settings.getOutputSpeed());
+						if ((image.registers & Image::OutputTypeRegister) != 0)
+							onSetOutputType(pin, settings.getOutputType());
+					});
+					return true;
+				}
+				bool result = true;
+				image.pins.forEach([&](pin_number_t pin) {
+					result = onSetSettings(pin, image.settings(pin)) && result;
+				});
+				return result;
+			}
+
 			//Виртуальный метод получения настроек пина GPIO (должен быть реализован в наследнике)
-			virtual bool onGetSettings(pin_number_t) = 0;
+			virtual Settings onGetSettings(pin_number_t) const = 0;
 
 			//Виртуальный метод обновления настроек пина GPIO (должен быть реализован в наследнике)
 			virtual bool onUpdateSettings(pin_number_t, const Settings&) = 0;
 
 			//Виртуальный метод установки логической единицы на пине GPIO (должен быть реализован в наследнике)
-			virtual void onSetPin(pin_number_t, bool) = 0;
+			virtual void onSetPin(pin_number_t) = 0;
 
 			//Виртуальный метод установки логического нуля на пине GPIO (должен быть реализован в наследнике)
-			virtual void onResetPin(pin_number_t, bool) = 0;
+			virtual void onResetPin(pin_number_t) = 0;
 
 			//Виртуальный метод установки подтяжки пина GPIO (должен быть реализован в наследнике)
 			virtual void onSetPull(pin_number_t, Pull) = 0;
@@ -250,6 +728,49 @@ namespace BasePeripheral {
 			//Виртуальный метод установки скорости выходно сигнала пина GPIO (должен быть реализован в наследнике)
 			virtual void onSetOutputSpeed(pin_number_t, OutputSpeed) = 0;
 
+			//Методы групповых операций. Реализации по умолчанию выполняют операцию попиново через onSetPin/onResetPin
+			//и onGetPinOutput/onGetPinInput; наследник может переопределить их одной записью в регистр установки/сброса (BSRR)
+			//
+			//Виртуальный метод записи значений values (уже ограниченных маской) в пины маски mask
+			virtual void onWritePins(const Mask& mask, const Mask& values) {
+				mask.forEach([&](pin_number_t pin) {
+					if (values.test(pin))
+						onSetPin(pin);
+					else
+						onResetPin(pin);
+				});
+			}
+
+			//Виртуальный метод переключения пинов маски
+			virtual void onTogglePins(const Mask& mask) {
+				onWritePins(mask, ~onReadPortOutput() & mask);
+			}
+
+			//Виртуальный метод переключения одного пина. Реализация по умолчанию читает выход и записывает
+			//противоположное значение (две операции); наследник переопределяет его атомарной операцией порта
+			virtual void onTogglePin(pin_number_t pin) {
+				if (onGetPinOutput(pin))
+					onResetPin(pin);
+				else
+					onSetPin(pin);
+			}
+
+			//Виртуальный метод чтения входного состояния порта
+			virtual Mask onReadPortInput() {
+				Mask result;
+				for (pin_number_t pin = 0; pin <= PinMaxNumber; ++pin)
+					result.set(pin, onGetPinInput(pin));
+				return result;
+			}
+
+			//Виртуальный метод чтения выходного состояния порта
+			virtual Mask onReadPortOutput() {
+				Mask result;
+				for (pin_number_t pin = 0; pin <= PinMaxNumber; ++pin)
+					result.set(pin, onGetPinOutput(pin));
+				return result;
+			}
+
 			//Функции получения установленных настроек
 			//
 			// Виртуальный метод получения состояние выхода пина (должен быть реализован в наследнике)
@@ -259,22 +780,53 @@ namespace BasePeripheral {
 			virtual bool onGetPinInput(pin_number_t) = 0;
 
 			// Виртуальный метод получения режима работы пина (должен быть реализован в наследнике)
-			virtual Mode getMode(pin_number_t) const = 0;
+			virtual Mode onGetMode(pin_number_t) const = 0;
 
 			// Виртуальный метод получения подтяжки пина (должен быть реализован в наследнике)
-			virtual Pull getPull(pin_number_t) const = 0;
+			virtual Pull onGetPull(pin_number_t) const = 0;
 
 			// Виртуальный метод получения типа выходно сигнала пина (должен быть реализован в наследнике)
-			virtual OutputType getOutputType(pin_number_t) const = 0;
+			virtual OutputType onGetOutputType(pin_number_t) const = 0;
 
 			// Виртуальный метод получения скорости выходно сигнала пина (должен быть реализован в наследнике)
-			virtual OutputSpeed getOutputSpeed(pin_number_t) const = 0;
+			virtual OutputSpeed onGetOutputSpeed(pin_number_t) const = 0;
 
 			// Виртуальный метод валидации порта GPIO (должен быть реализован в наследнике)
 			virtual bool validatePortAddr(uint32_t portAddr) const = 0;
 
+			// Диспетчеризация прерываний порта (вызывается наследником из обработчика прерывания).
+			// Для пинов маски pending вызываются обработчики из таблицы по пинам; пины без своего обработчика
+			// передаются во внешний обработчик interruptCallback, если он установлен
+			void dispatchInterrupts(const Mask& pending) {
+				BP_TRACE_SCOPE(GpioInterrupt, pending.word(0));
+				Mask unhandled = pinInterruptHandlers.dispatch(pending);
+				if (interruptCallback)
+					unhandled.forEach(interruptCallback);
+			}
+
+			// Сохраняет настройки пина в теневую таблицу при успешном применении (без ShadowCache ничего не делает).
+			// При неудаче настройки пина в таблице помечаются неизвестными, так как аппаратура могла примениться частично
+			bool storeSettings(pin_number_t pin, bool applied, const Settings& settings) {
+				if constexpr (ShadowCache) {
+					if (applied)
+						shadowTable.store(pin, settings);
+					else
+						shadowTable.invalidate(pin);
+				}
+				return applied;
+			}
+
 			//Внешний обработчик прерываний (может быть реализован как в наследнике, так и из объекта)
 			ExternalInterruptCallback_t interruptCallback;
+
+			//Таблица невыделяющих обработчиков прерываний по пинам
+			PinInterruptTable<IOCount> pinInterruptHandlers;
+
+			//Теневая таблица настроек пинов (пустая, если ShadowCache выключен)
+			mutable typename std::conditional<ShadowCache, ShadowTable<IOCount>, NoShadowTable>::type shadowTable;
+
+			//Счетчики операций (только при BP_TRACE)
+			BP_TRACE_COUNTERS
 		};
 	}
 }
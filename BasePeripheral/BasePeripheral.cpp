@@ -1,7 +1,7 @@
-﻿#include <iostream>
+﻿#include <cstdio>
 #include "BaseDma.hpp"
 
 int main()
 {
-    std::cout << "Hello World!\n";
+    std::puts("Hello World!");
 }
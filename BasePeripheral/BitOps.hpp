@@ -0,0 +1,43 @@
+#ifndef BIT_OPS_HPP_
+#define BIT_OPS_HPP_
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace BasePeripheral {
+	namespace Bits {
+		// Возвращает номер младшего установленного бита (значение не должно быть нулевым)
+		inline uint32_t countTrailingZeros(uint32_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+			return static_cast<uint32_t>(__builtin_ctz(value));
+#elif defined(_MSC_VER)
+			unsigned long index;
+			_BitScanForward(&index, value);
+			return static_cast<uint32_t>(index);
+#else
+			uint32_t index = 0;
+			while ((value & 1u) == 0) {
+				value >>= 1;
+				++index;
+			}
+			return index;
+#endif
+		}
+
+		// Возвращает количество установленных битов
+		inline uint32_t popCount(uint32_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+			return static_cast<uint32_t>(__builtin_popcount(value));
+#else
+			value = value - ((value >> 1) & 0x55555555u);
+			value = (value & 0x33333333u) + ((value >> 2) & 0x33333333u);
+			return (((value + (value >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24;
+#endif
+		}
+	}
+}
+
+#endif
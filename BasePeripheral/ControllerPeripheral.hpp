@@ -1,8 +1,12 @@
 #ifndef CONTROLLER_PERIPHERAL_HPP
 #define CONTROLLER_PERIPHERAL_HPP
 
+#include <cstdint>
+#include "ErrorPolicy.hpp"
+
 namespace BasePeripheral {
-	typedef uint32_t error_t;
+	// Пустая заглушка теневой таблицы настроек для блоков периферии с выключенным кэшем
+	struct NoShadowTable {};
 
 	class ControllerPeripheral {
 	protected:
@@ -15,6 +19,26 @@ namespace BasePeripheral {
 		// Виртуальный метод установки ошибки блока периферии (должен быть реализован в конечном наследнике)
 		virtual void onError(error_t) = 0;
 
+		// Виртуальный метод обработки события ошибки с номером пина или канала. По умолчанию передает код
+		// ошибки в onError; наследник может переопределить его, чтобы передать событие в политику ошибок
+		virtual void onErrorEvent(const ErrorEvent& event) {
+			onError(event.error);
+		}
+
+		// Передает ошибку из перечисления конкретного блока периферии (блок определяется функцией
+		// errorSource(ErrorEnum) из пространства имен перечисления) в onErrorEvent
+		template <typename ErrorEnum>
+		void raiseError(ErrorEnum error, uint32_t index = ErrorEvent::NoIndex) {
+			onErrorEvent(ErrorEvent(errorSource(error), static_cast<error_t>(error), index));
+		}
+
+		// То же для константных методов (геттеров): сообщение об ошибке не относится к наблюдаемому состоянию
+		// блока периферии, обработчик ошибок наследника вызывается как обычно
+		template <typename ErrorEnum>
+		void raiseError(ErrorEnum error, uint32_t index = ErrorEvent::NoIndex) const {
+			const_cast<ControllerPeripheral*>(this)->raiseError(error, index);
+		}
+
 	public:
 		// Виртуальный деструктор
 		virtual ~ControllerPeripheral() {}
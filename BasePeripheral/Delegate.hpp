@@ -0,0 +1,111 @@
+#ifndef DELEGATE_HPP_
+#define DELEGATE_HPP_
+
+#include <type_traits>
+
+namespace BasePeripheral {
+	template <typename Signature>
+	class Delegate;
+
+	// Невыделяющий память делегат фиксированного размера: указатель на функцию-переходник и контекст.
+	// В отличие от std::function не выполняет выделение памяти и не использует стирание типа через
+	// виртуальные вызовы: вызов сводится к одному косвенному вызову. Делегат не владеет контекстом,
+	// поэтому связанный объект должен жить дольше делегата.
+	template <typename R, typename... Args>
+	class Delegate<R(Args...)> {
+	public:
+		typedef R(*Function_t)(Args...);              // Свободная функция (или лямбда без захвата)
+		typedef R(*ContextFunction_t)(void*, Args...); // Функция с пользовательским контекстом
+
+		// Пустой делегат
+		constexpr Delegate() : _stub(nullptr), _context() {}
+		constexpr Delegate(decltype(nullptr)) : Delegate() {}
+
+		// Делегат из свободной функции или лямбды без захвата
+		Delegate(Function_t function) : _stub(function ? &callFunction : nullptr), _context() {
+			_context.function = function;
+		}
+
+		// Делегат из лямбды без захвата (или другого объекта, приводимого к указателю на функцию): приведение
+		// выполняется явно, так как цепочка "лямбда -> указатель -> делегат" не строится неявно
+		template <typename F, typename = typename std::enable_if<std::is_convertible<F, Function_t>::value &&
+			!std::is_same<typename std::decay<F>::type, Function_t>::value &&
+			!std::is_same<typename std::decay<F>::type, decltype(nullptr)>::value>::type>
+		Delegate(F function) : Delegate(static_cast<Function_t>(function)) {}
+
+		// Делегат из пары "функция + контекст"
+		Delegate(ContextFunction_t function, void* context) : _stub(nullptr), _context() {
+			if (function) {
+				_stub = &callContextFunction;
+				_context.pair.function = function;
+				_context.pair.object = context;
+			}
+		}
+
+		// Делегат, вызывающий метод Method объекта object
+		template <typename T, R(T::*Method)(Args...)>
+		static Delegate bind(T* object) {
+			Delegate result;
+			result._stub = &callMethod<T, Method>;
+			result._context.object = object;
+			return result;
+		}
+
+		// Делегат, вызывающий функциональный объект (например, лямбду с захватом), хранимый вызывающей стороной
+		template <typename F>
+		static Delegate bind(F& functor) {
+			Delegate result;
+			result._stub = &callFunctor<F>;
+			result._context.object = &functor;
+			return result;
+		}
+
+		// Вызов делегата (делегат не должен быть пустым)
+		R operator()(Args... args) const {
+			return _stub(_context, args...);
+		}
+
+		explicit operator bool() const { return _stub != nullptr; }
+
+		bool operator==(decltype(nullptr)) const { return _stub == nullptr; }
+		bool operator!=(decltype(nullptr)) const { return _stub != nullptr; }
+
+	private:
+		// Хранилище контекста: объект, свободная функция или пара "функция + контекст"
+		union Context {
+			void* object;
+			Function_t function;
+			struct {
+				ContextFunction_t function;
+				void* object;
+			} pair;
+
+			constexpr Context() : object(nullptr) {}
+		};
+
+		typedef R(*Stub_t)(const Context&, Args...);
+
+		static R callFunction(const Context& context, Args... args) {
+			return context.function(args...);
+		}
+
+		static R callContextFunction(const Context& context, Args... args) {
+			return context.pair.function(context.pair.object, args...);
+		}
+
+		template <typename T, R(T::*Method)(Args...)>
+		static R callMethod(const Context& context, Args... args) {
+			return (static_cast<T*>(context.object)->*Method)(args...);
+		}
+
+		template <typename F>
+		static R callFunctor(const Context& context, Args... args) {
+			return (*static_cast<F*>(context.object))(args...);
+		}
+
+		Stub_t _stub;     // Функция-переходник
+		Context _context; // Контекст вызова
+	};
+}
+
+#endif
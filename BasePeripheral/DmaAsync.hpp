@@ -0,0 +1,428 @@
+#ifndef DMA_ASYNC_HPP_
+#define DMA_ASYNC_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "BitOps.hpp"
+#include "DmaScheduler.hpp"
+#include "SharedMacro.hpp"
+
+#ifndef BP_DMA_ASYNC_FRAME_SIZE
+#define BP_DMA_ASYNC_FRAME_SIZE 512 // Размер блока пула кадров сопрограмм, байт
+#endif
+
+#ifndef BP_DMA_ASYNC_FRAMES
+#define BP_DMA_ASYNC_FRAMES 64      // Количество блоков пула кадров сопрограмм (степень двойки)
+#endif
+
+// Сопрограммы доступны при компиляции в режиме C++20; будущие передач (TransferFuture) работают и в C++17
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#include <exception>
+#define BP_DMA_ASYNC_COROUTINES 1
+#endif
+#endif
+
+namespace BasePeripheral {
+	namespace Dma {
+		class TransferFuture;
+
+		typedef Delegate<void(TransferFuture&)> FutureContinuation_t; // Продолжение после завершения передачи
+
+		// Легковесное будущее передачи DMA: запрос планировщика и состояние завершения без выделения памяти.
+		// Хранится вызывающей стороной (на стеке, в объекте или в кадре сопрограммы) и не должно разрушаться
+		// и перемещаться до завершения передачи. Продолжение (then) вызывается ровно один раз: из прерывания DMA
+		// при завершении или сразу, если передача уже завершилась
+		class TransferFuture {
+		public:
+			TransferFuture() {
+				_request.onComplete = TransferCallback_t::bind<TransferFuture, &TransferFuture::onComplete>(this);
+			}
+
+			TransferFuture(const TransferFuture&) = delete;
+			TransferFuture& operator=(const TransferFuture&) = delete;
+
+			// Возвращает true, если передача завершена
+			bool ready() const { return _state.load(std::memory_order_acquire) == Ready; }
+
+			// Возвращает true, если завершенная передача прервана ошибкой (или ее не удалось запустить)
+			bool failed() const { return ready() && _request.status == ChainStatus::Error; }
+
+			// Задает продолжение. Возвращает false, если передача уже завершена (продолжение вызвано сразу)
+			bool then(FutureContinuation_t continuation) {
+				if (defer(continuation))
+					return true;
+				if (continuation)
+					continuation(*this);
+				return false;
+			}
+
+			// Запрос планировщика (канал, отметки времени, количество вытеснений)
+			const TransferRequest& request() const { return _request; }
+
+		private:
+			template <typename Controller>
+			friend class AsyncDma;
+			friend class FutureAwaiter;
+
+			static constexpr uint8_t Pending = 0; // Передача выполняется, продолжения нет
+			static constexpr uint8_t Waiting = 1; // Передача выполняется, продолжение задано
+			static constexpr uint8_t Ready = 2;   // Передача завершена
+
+			// Подготавливает будущее к новой передаче
+			void prepare() {
+				_continuation = FutureContinuation_t();
+				_state.store(Pending, std::memory_order_relaxed);
+			}
+
+			// Задает продолжение, если передача еще выполняется. Возвращает false (продолжение не вызывается),
+			// если передача уже завершена
+			bool defer(FutureContinuation_t continuation) {
+				_continuation = continuation;
+				uint8_t expected = Pending;
+				return _state.compare_exchange_strong(expected, Waiting, std::memory_order_acq_rel);
+			}
+
+			// Обработчик завершения запроса планировщика (прерывание DMA). Продолжение вызывается последним:
+			// после него будущее может быть разрушено
+			void onComplete(TransferRequest&) {
+				if (_state.exchange(Ready, std::memory_order_acq_rel) == Waiting && _continuation)
+					_continuation(*this);
+			}
+
+			TransferRequest _request;                 // Запрос планировщика
+			FutureContinuation_t _continuation;       // Продолжение
+			std::atomic<uint8_t> _state{ Ready };     // Состояние передачи
+		};
+
+#if BP_DMA_ASYNC_COROUTINES
+		class Executor;
+
+		namespace Detail {
+			// Пул кадров сопрограмм: блоки фиксированного размера, занятость - в битовой карте (без блокировок)
+			struct FramePool {
+				static constexpr size_t FrameSize = BP_DMA_ASYNC_FRAME_SIZE;
+				static constexpr uint32_t Frames = BP_DMA_ASYNC_FRAMES;
+				static constexpr uint32_t Words = (Frames + 31) / 32;
+
+				alignas(std::max_align_t) unsigned char storage[Frames][FrameSize];
+				std::atomic<uint32_t> used[Words] = {};
+
+				// Выделяет блок или возвращает nullptr, если кадр не помещается в блок или блоки закончились
+				void* allocate(size_t size) noexcept {
+					if (size > FrameSize) {
+						RG_LOG(Warning, "DmaAsync: coroutine frame does not fit BP_DMA_ASYNC_FRAME_SIZE");
+						return nullptr;
+					}
+					for (uint32_t word = 0; word < Words; ++word) {
+						uint32_t bits = used[word].load(std::memory_order_relaxed);
+						const uint32_t valid = word + 1 < Words || Frames % 32 == 0 ? 0xFFFFFFFFu : (1u << (Frames % 32)) - 1u;
+						while ((~bits & valid) != 0) {
+							const uint32_t bit = Bits::countTrailingZeros(~bits & valid);
+							if (used[word].compare_exchange_weak(bits, bits | (1u << bit), std::memory_order_acquire))
+								return storage[word * 32 + bit];
+						}
+					}
+					RG_LOG(Warning, "DmaAsync: coroutine frame pool is exhausted");
+					return nullptr;
+				}
+
+				void release(void* frame) noexcept {
+					const size_t index = static_cast<size_t>(static_cast<unsigned char*>(frame) - storage[0]) / FrameSize;
+					used[index / 32].fetch_and(~(1u << (index % 32)), std::memory_order_release);
+				}
+
+				// Количество занятых блоков
+				uint32_t count() const {
+					uint32_t total = 0;
+					for (uint32_t word = 0; word < Words; ++word)
+						total += Bits::popCount(used[word].load(std::memory_order_relaxed));
+					return total;
+				}
+			};
+
+			inline FramePool framePool;
+		}
+
+		// Сопрограмма, выполняемая исполнителем (Executor::spawn). Кадр размещается в пуле кадров без обращения
+		// к куче; если пул исчерпан или кадр больше блока, возвращается пустая задача (spawn вернет false).
+		// После завершения кадр освобождается автоматически
+		class Task {
+		public:
+			struct promise_type {
+				Executor* executor = nullptr; // Исполнитель, возобновляющий сопрограмму
+
+				static void* operator new(size_t size) noexcept { return Detail::framePool.allocate(size); }
+				static void operator delete(void* frame) noexcept { Detail::framePool.release(frame); }
+				static Task get_return_object_on_allocation_failure() noexcept { return Task(); }
+
+				Task get_return_object() noexcept { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+				std::suspend_always initial_suspend() noexcept { return {}; }
+				std::suspend_never final_suspend() noexcept;
+				void return_void() noexcept {}
+				void unhandled_exception() noexcept { std::terminate(); }
+			};
+
+			Task() = default;
+			Task(Task&& other) noexcept : _handle(other._handle) { other._handle = nullptr; }
+			Task& operator=(Task&& other) noexcept {
+				if (this != &other) {
+					if (_handle)
+						_handle.destroy();
+					_handle = other._handle;
+					other._handle = nullptr;
+				}
+				return *this;
+			}
+			~Task() {
+				if (_handle)
+					_handle.destroy(); // Задача не была запущена
+			}
+
+			explicit operator bool() const { return static_cast<bool>(_handle); }
+
+		private:
+			friend class Executor;
+
+			explicit Task(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+
+			std::coroutine_handle<promise_type> _handle;
+		};
+
+		// Кооперативный исполнитель сопрограмм в одном потоке. Готовые к выполнению сопрограммы стоят в очереди
+		// без блокировок: ставить в нее (post) можно из любого потока и из прерываний, например по завершении
+		// передачи DMA, возобновляет их только поток, вызывающий runOnce/run. Сопрограмма находится в очереди
+		// не более одного раза, поэтому емкости, равной числу кадров пула, достаточно
+		class Executor {
+		public:
+			Executor() {
+				for (uint32_t i = 0; i < Capacity; ++i)
+					_cells[i].sequence.store(i, std::memory_order_relaxed);
+			}
+
+			Executor(const Executor&) = delete;
+			Executor& operator=(const Executor&) = delete;
+
+			// Запускает задачу. Возвращает false, если задача пуста (кадр не выделен) или очередь готовых заполнена
+			bool spawn(Task&& task) {
+				if (!task._handle)
+					return false;
+				std::coroutine_handle<Task::promise_type> handle = task._handle;
+				task._handle = nullptr;
+				handle.promise().executor = this;
+				_live.fetch_add(1, std::memory_order_relaxed);
+				if (!post(handle)) {
+					_live.fetch_sub(1, std::memory_order_relaxed);
+					handle.destroy();
+					return false;
+				}
+				return true;
+			}
+
+			// Ставит сопрограмму в очередь готовых (из любого потока или прерывания). Возвращает false, если очередь
+			// заполнена (в ней больше сопрограмм, чем кадров пула: например, ожидают сопрограммы не из пула) -
+			// сопрограмма не поставлена, вызывающая сторона должна возобновить ее сама; случай учитывается в overflows()
+			bool post(std::coroutine_handle<> handle) {
+				uint32_t position = _tail.load(std::memory_order_relaxed);
+				for (;;) {
+					Cell& cell = _cells[position & (Capacity - 1)];
+					const uint32_t sequence = cell.sequence.load(std::memory_order_acquire);
+					const int32_t difference = static_cast<int32_t>(sequence - position);
+					if (difference == 0) {
+						if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+							cell.handle = handle.address();
+							cell.sequence.store(position + 1, std::memory_order_release);
+							return true;
+						}
+					}
+					else if (difference < 0) {
+						_overflows.fetch_add(1, std::memory_order_relaxed);
+						RG_LOG(Warning, "DmaAsync: executor ready queue is full");
+						return false;
+					}
+					else {
+						position = _tail.load(std::memory_order_relaxed);
+					}
+				}
+			}
+
+			// Возобновляет сопрограммы, готовые на момент вызова. Возвращает количество возобновленных
+			uint32_t runOnce() {
+				const uint32_t limit = _tail.load(std::memory_order_acquire) - _head;
+				uint32_t resumed = 0;
+				while (resumed < limit) {
+					Cell& cell = _cells[_head & (Capacity - 1)];
+					if (cell.sequence.load(std::memory_order_acquire) != _head + 1)
+						break; // Ячейка еще заполняется
+					void* address = cell.handle;
+					cell.sequence.store(_head + Capacity, std::memory_order_release);
+					++_head;
+					++resumed;
+					std::coroutine_handle<>::from_address(address).resume();
+				}
+				return resumed;
+			}
+
+			// Выполняет задачи до завершения всех. idle() вызывается, когда готовых сопрограмм нет
+			// (ожидание прерывания на контроллере, продвижение симулятора)
+			template <typename Idle>
+			void run(Idle&& idle) {
+				while (_live.load(std::memory_order_relaxed) != 0)
+					if (runOnce() == 0)
+						idle();
+			}
+
+			// Количество незавершенных задач
+			uint32_t live() const { return _live.load(std::memory_order_relaxed); }
+
+			// Количество отказов post из-за заполненной очереди готовых
+			uint32_t overflows() const { return _overflows.load(std::memory_order_relaxed); }
+
+			// Ожидание, уступающее выполнение другим готовым сопрограммам: co_await executor.yield().
+			// Если очередь готовых заполнена, сопрограмма продолжается без приостановки
+			struct YieldAwaiter {
+				Executor& executor;
+				bool await_ready() const noexcept { return false; }
+				bool await_suspend(std::coroutine_handle<> handle) { return executor.post(handle); }
+				void await_resume() const noexcept {}
+			};
+
+			YieldAwaiter yield() { return YieldAwaiter{ *this }; }
+
+		private:
+			friend struct Task::promise_type;
+
+			static constexpr uint32_t Capacity = Detail::FramePool::Frames;
+			static_assert((Capacity & (Capacity - 1)) == 0, "BP_DMA_ASYNC_FRAMES must be a power of two");
+
+			// Ячейка очереди: номер последовательности указывает, свободна она или заполнена
+			struct Cell {
+				std::atomic<uint32_t> sequence{ 0 };
+				void* handle = nullptr;
+			};
+
+			void finished() { _live.fetch_sub(1, std::memory_order_relaxed); }
+
+			Cell _cells[Capacity];
+			std::atomic<uint32_t> _tail{ 0 };      // Позиция записи (производители)
+			uint32_t _head = 0;                    // Позиция чтения (поток исполнителя)
+			std::atomic<uint32_t> _live{ 0 };      // Незавершенные задачи
+			std::atomic<uint32_t> _overflows{ 0 }; // Отказы post из-за заполненной очереди
+		};
+
+		inline std::suspend_never Task::promise_type::final_suspend() noexcept {
+			if (executor != nullptr)
+				executor->finished();
+			return {};
+		}
+
+		// Ожидание завершения будущего в сопрограмме: co_await future. Сопрограмма задачи возобновляется
+		// исполнителем (продолжение из прерывания только ставит ее в очередь), сопрограмма другого типа -
+		// прямо в продолжении
+		class FutureAwaiter {
+		public:
+			explicit FutureAwaiter(TransferFuture& future) : _future(&future) {}
+
+			bool await_ready() const { return _future->ready(); }
+
+			template <typename Promise>
+			bool await_suspend(std::coroutine_handle<Promise> handle) {
+				if constexpr (std::is_same<Promise, Task::promise_type>::value)
+					_executor = handle.promise().executor;
+				_handle = handle;
+				return _future->defer(FutureContinuation_t::bind<FutureAwaiter, &FutureAwaiter::onReady>(this));
+			}
+
+			void await_resume() const {}
+
+		protected:
+			FutureAwaiter() = default;
+
+			TransferFuture* _future = nullptr;
+
+		private:
+			// Если очередь исполнителя заполнена, сопрограмма возобновляется сразу, чтобы не потерять ее
+			void onReady(TransferFuture&) {
+				if (_executor == nullptr || !_executor->post(_handle))
+					_handle.resume();
+			}
+
+			Executor* _executor = nullptr;
+			std::coroutine_handle<> _handle;
+		};
+
+		inline FutureAwaiter operator co_await(TransferFuture& future) { return FutureAwaiter(future); }
+#endif
+
+		// Асинхронные передачи память-память поверх планировщика DMA: запуск возвращает управление сразу,
+		// о завершении сообщает будущее (TransferFuture) или возобновление сопрограммы (co_await copy(...)).
+		// Запросов может быть больше, чем каналов в пуле планировщика: лишние ждут в его очередях.
+		// Контракт по прерываниям тот же, что у DmaScheduler: запуск и завершение передач не выполняются
+		// одновременно
+		template <typename Controller>
+		class AsyncDma {
+		public:
+			explicit AsyncDma(DmaScheduler<Controller>& scheduler) : _scheduler(scheduler) {}
+
+			AsyncDma(const AsyncDma&) = delete;
+			AsyncDma& operator=(const AsyncDma&) = delete;
+
+			// Запускает копирование count элементов шириной width из src в dst (адреса на шине DMA).
+			// Возвращает false, если передача пуста или future еще занят предыдущей передачей
+			bool start(TransferFuture& future, address_t dst, address_t src, uint32_t count,
+				DataAlign width = DataAlign::Byte, Priority priority = Priority::Low) {
+				if (count == 0 || !future.ready())
+					return false;
+				future.prepare();
+				TransferRequest& request = future._request;
+				request.descriptor = Descriptor(src, dst, count, width);
+				request.direction = Direction::MemoryToMemory;
+				request.priority = priority;
+				_scheduler.submit(request);
+				return true;
+			}
+
+#if BP_DMA_ASYNC_COROUTINES
+			// Операция копирования для co_await: передача запускается при ожидании, будущее хранится в кадре
+			// сопрограммы. Пустая передача завершается сразу
+			class CopyOperation : public FutureAwaiter {
+			public:
+				CopyOperation(AsyncDma& dma, address_t dst, address_t src, uint32_t count, DataAlign width, Priority priority)
+					: _dma(dma), _dst(dst), _src(src), _count(count), _width(width), _priority(priority) {
+					_future = &_transfer;
+				}
+
+				bool await_ready() {
+					return !_dma.start(_transfer, _dst, _src, _count, _width, _priority) || _transfer.ready();
+				}
+
+				// Запрос планировщика выполненной передачи
+				const TransferRequest& await_resume() const { return _transfer.request(); }
+
+			private:
+				AsyncDma& _dma;
+				address_t _dst;
+				address_t _src;
+				uint32_t _count;
+				DataAlign _width;
+				Priority _priority;
+				TransferFuture _transfer;
+			};
+
+			// Копирование для сопрограмм: co_await dma.copy(dst, src, count)
+			CopyOperation copy(address_t dst, address_t src, uint32_t count,
+				DataAlign width = DataAlign::Byte, Priority priority = Priority::Low) {
+				return CopyOperation(*this, dst, src, count, width, priority);
+			}
+#endif
+
+		private:
+			DmaScheduler<Controller>& _scheduler; // Планировщик каналов
+		};
+	}
+}
+
+#endif
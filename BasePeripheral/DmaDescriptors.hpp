@@ -0,0 +1,41 @@
+#ifndef DMA_DESCRIPTORS_HPP_
+#define DMA_DESCRIPTORS_HPP_
+
+#include "BaseDma.hpp"
+
+namespace BasePeripheral {
+	namespace Dma {
+		// Дескриптор канала DMA, вычисляемый на этапе компиляции.
+		// Controller - тип контроллера DMA (наследник BaseDma или StaticDma), номер канала проверяется по Controller::ChannelMaxNumber.
+		// Адреса не входят в дескриптор и передаются в dma.initChannel<Descriptor>(periphOrSrcAddr, memoryOrDstAddr).
+		template <
+			typename Controller,
+			channel_number_t N,
+			Direction ChannelDirection = Direction::PeriphToMemory,
+			Mode ChannelMode = Mode::Normal,
+			Priority ChannelPriority = Priority::Low,
+			DataAlign PeriphOrSrcAlign = DataAlign::Byte,
+			IncrementMode PeriphOrSrcIncrement = IncrementMode::NoIncrement,
+			DataAlign MemoryOrDstAlign = DataAlign::Byte,
+			IncrementMode MemoryOrDstIncrement = IncrementMode::Increment
+		>
+		struct Channel {
+			static_assert(N <= Controller::ChannelMaxNumber, "Channel number is out of range");
+
+			typedef Controller Controller_t;
+			static constexpr channel_number_t Number = N;
+
+			// Настройки канала без адресов
+			static constexpr Settings settings() {
+				return Settings(ChannelDirection, ChannelMode, ChannelPriority,
+					MemorySettings(0, PeriphOrSrcAlign, PeriphOrSrcIncrement),
+					MemorySettings(0, MemoryOrDstAlign, MemoryOrDstIncrement));
+			}
+
+			// Образ управляющего регистра канала
+			static constexpr ChannelImage image = ChannelImage::fromSettings(settings());
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef DMA_KERNELS_HPP_
+#define DMA_KERNELS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BP_DMA_KERNELS_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define BP_DMA_KERNELS_NEON 1
+#endif
+
+namespace BasePeripheral {
+	namespace Sim {
+		// Ядра пересылки блоков данных для симулятора DMA.
+		// Векторные реализации (SSE2 или NEON) выбираются на этапе компиляции, при их отсутствии используется
+		// скалярный вариант. Все функции работают с памятью хоста, адреса шины переводятся вызывающим кодом.
+		namespace Kernels {
+			// Копирует bytes байт из src в dst (области не должны перекрываться)
+			inline void copyBlock(uint8_t* dst, const uint8_t* src, size_t bytes) {
+#if defined(BP_DMA_KERNELS_SSE2)
+				for (; bytes >= 64; bytes -= 64, src += 64, dst += 64) {
+					const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+					const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+					const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+					const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), a);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), b);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32), c);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 48), d);
+				}
+				for (; bytes >= 16; bytes -= 16, src += 16, dst += 16)
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+#elif defined(BP_DMA_KERNELS_NEON)
+				for (; bytes >= 64; bytes -= 64, src += 64, dst += 64) {
+					const uint8x16_t a = vld1q_u8(src);
+					const uint8x16_t b = vld1q_u8(src + 16);
+					const uint8x16_t c = vld1q_u8(src + 32);
+					const uint8x16_t d = vld1q_u8(src + 48);
+					vst1q_u8(dst, a);
+					vst1q_u8(dst + 16, b);
+					vst1q_u8(dst + 32, c);
+					vst1q_u8(dst + 48, d);
+				}
+				for (; bytes >= 16; bytes -= 16, src += 16, dst += 16)
+					vst1q_u8(dst, vld1q_u8(src));
+#endif
+				if (bytes != 0)
+					std::memcpy(dst, src, bytes);
+			}
+
+			// Заполняет count элементов шириной size (1, 2 или 4 байта) значением value
+			inline void fillBlock(uint8_t* dst, uint32_t value, uint32_t size, size_t count) {
+				size_t bytes = count * size;
+				// Значение, размноженное на 32 бита
+				const uint32_t pattern = size == 1 ? (value & 0xFFu) * 0x01010101u :
+					size == 2 ? (value & 0xFFFFu) * 0x00010001u : value;
+#if defined(BP_DMA_KERNELS_SSE2)
+				const __m128i vector = _mm_set1_epi32(static_cast<int>(pattern));
+				for (; bytes >= 64; bytes -= 64, dst += 64) {
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), vector);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), vector);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32), vector);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 48), vector);
+				}
+				for (; bytes >= 16; bytes -= 16, dst += 16)
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), vector);
+#elif defined(BP_DMA_KERNELS_NEON)
+				const uint8x16_t vector = vreinterpretq_u8_u32(vdupq_n_u32(pattern));
+				for (; bytes >= 64; bytes -= 64, dst += 64) {
+					vst1q_u8(dst, vector);
+					vst1q_u8(dst + 16, vector);
+					vst1q_u8(dst + 32, vector);
+					vst1q_u8(dst + 48, vector);
+				}
+				for (; bytes >= 16; bytes -= 16, dst += 16)
+					vst1q_u8(dst, vector);
+#endif
+				for (; bytes >= 4; bytes -= 4, dst += 4)
+					std::memcpy(dst, &pattern, 4);
+				if (bytes != 0)
+					std::memcpy(dst, &pattern, bytes);
+			}
+
+			// Читает элемент шириной size байт (little-endian)
+			inline uint32_t loadItem(const uint8_t* src, uint32_t size) {
+				uint32_t value = 0;
+				std::memcpy(&value, src, size);
+				return value;
+			}
+
+			// Записывает младшие size байт значения (little-endian)
+			inline void storeItem(uint8_t* dst, uint32_t value, uint32_t size) {
+				std::memcpy(dst, &value, size);
+			}
+
+			// Скалярная пересылка count элементов с произвольными шириной и шагом сторон (шаг 0 - фиксированный адрес).
+			// Элементы пересылаются по одному в прямом порядке: более узкий источник дополняется нулями,
+			// более широкий усекается до младших байт, как в контроллерах DMA с разной шириной сторон.
+			inline void convertBlock(uint8_t* dst, size_t dstStride, uint32_t dstSize,
+				const uint8_t* src, size_t srcStride, uint32_t srcSize, size_t count) {
+				for (; count != 0; --count, src += srcStride, dst += dstStride) {
+					const uint32_t value = loadItem(src, srcSize);
+					storeItem(dst, value, dstSize);
+				}
+			}
+		}
+	}
+}
+
+#endif
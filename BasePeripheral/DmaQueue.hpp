@@ -0,0 +1,134 @@
+#ifndef DMA_QUEUE_HPP_
+#define DMA_QUEUE_HPP_
+
+#include "BaseDma.hpp"
+
+namespace BasePeripheral {
+	namespace Dma {
+		// Очередь отправки передач DMA на один канал. Передачи накапливаются в открытом пакете (push),
+		// submit закрывает пакет и отправляет его одной цепочкой дескрипторов; обработчик завершения
+		// вызывается один раз на пакет (с ChainStatus::Error, если выполнение пакета прервано ошибкой передачи).
+		// Пакеты, отправленные во время выполнения предыдущего, ждут в очереди и запускаются из обработчика
+		// завершения цепочки.
+		// Controller - BaseDma или StaticDma; Capacity - количество узлов, MaxBatches - количество пакетов в очереди.
+		// Очередь не использует блокировок: push/submit и завершение цепочки (прерывание DMA) не должны
+		// выполняться одновременно, например, прерывание канала запрещается на время submit.
+		template <typename Controller, uint32_t Capacity, uint32_t MaxBatches = 8>
+		class SubmissionQueue {
+			static_assert(Capacity > 0 && MaxBatches > 0, "Queue capacity must be positive");
+
+		public:
+			SubmissionQueue(Controller& dma, channel_number_t channel) : _dma(dma), _channel(channel) {}
+
+			SubmissionQueue(const SubmissionQueue&) = delete;
+			SubmissionQueue& operator=(const SubmissionQueue&) = delete;
+
+			// Добавляет передачу в открытый пакет. Возвращает false, если свободных узлов нет
+			bool push(const Descriptor& descriptor) {
+				if (_used == Capacity)
+					return false;
+				const uint32_t index = wrap(_first + _used);
+				_nodes[index] = descriptor;
+				_nodes[index].setNext(nullptr);
+				if (_openCount != 0)
+					_nodes[wrap(index + Capacity - 1)].setNext(&_nodes[index]);
+				++_used;
+				++_openCount;
+				return true;
+			}
+
+			// Добавляет передачу count элементов шириной width из src в dst с инкрементом обоих адресов
+			bool push(address_t src, address_t dst, uint32_t count, DataAlign width = DataAlign::Byte) {
+				return push(Descriptor(src, dst, count, width));
+			}
+
+			// Закрывает открытый пакет и отправляет его (или ставит в очередь, если канал занят).
+			// Возвращает false, если пакет пуст или очередь пакетов заполнена (пакет не принят, обработчик
+			// не вызывается), а также если цепочку не удалось запустить (обработчик уже вызван с ChainStatus::Error)
+			bool submit(ChainCallback_t onComplete = ChainCallback_t()) {
+				if (_openCount == 0 || _batchCount == MaxBatches)
+					return false;
+				Batch& batch = _batches[wrapBatch(_firstBatch + _batchCount)];
+				batch.first = wrap(_first + _used - _openCount);
+				batch.count = _openCount;
+				batch.onComplete = onComplete;
+				++_batchCount;
+				_openCount = 0;
+				if (!_running)
+					return start();
+				return true;
+			}
+
+			// Количество пакетов, ожидающих выполнения или выполняемых
+			uint32_t pendingBatches() const { return _batchCount; }
+
+			// Количество свободных узлов
+			uint32_t freeNodes() const { return Capacity - _used; }
+
+			// Возвращает true, если очередь не содержит ни пакетов, ни открытых передач
+			bool empty() const { return _used == 0; }
+
+		private:
+			// Пакет передач: непрерывный (по модулю Capacity) диапазон узлов и обработчик завершения
+			struct Batch {
+				uint32_t first = 0;
+				uint32_t count = 0;
+				ChainCallback_t onComplete;
+			};
+
+			static uint32_t wrap(uint32_t index) { return index % Capacity; }
+			static uint32_t wrapBatch(uint32_t index) { return index % MaxBatches; }
+
+			// Запускает первый пакет очереди. Пакет, который не удалось запустить, удаляется из очереди с вызовом
+			// обработчика с ChainStatus::Error, и запускается следующий. Возвращает true, если пакет выполняется
+			bool start() {
+				while (_batchCount != 0 && !_running) {
+					_running = true; // До запуска: цепочка может завершиться прямо в submitChain
+					if (_dma.submitChain(_channel, &_nodes[_batches[_firstBatch].first],
+						ChainCallback_t::template bind<SubmissionQueue, &SubmissionQueue::onChainComplete>(this)))
+						return true;
+					_running = false;
+					const ChainCallback_t onComplete = _batches[_firstBatch].onComplete;
+					release();
+					if (onComplete)
+						onComplete(_channel, ChainStatus::Error);
+				}
+				return _running;
+			}
+
+			// Освобождает узлы первого пакета и удаляет его из очереди
+			void release() {
+				const uint32_t count = _batches[_firstBatch].count;
+				_batches[_firstBatch].onComplete = ChainCallback_t();
+				_first = wrap(_first + count);
+				_used -= count;
+				_firstBatch = wrapBatch(_firstBatch + 1);
+				--_batchCount;
+			}
+
+			// Обработчик завершения цепочки: освобождает пакет, уведомляет владельца (с результатом выполнения цепочки)
+			// и запускает следующий пакет
+			void onChainComplete(channel_number_t channel, ChainStatus status) {
+				const ChainCallback_t onComplete = _batches[_firstBatch].onComplete;
+				_running = false;
+				release();
+				if (onComplete)
+					onComplete(channel, status); // Может отправить новый пакет и запустить его
+				start();
+			}
+
+			Controller& _dma;                  // Контроллер DMA
+			channel_number_t _channel;         // Канал для выполнения цепочек
+			Descriptor _nodes[Capacity];       // Кольцо узлов
+			uint32_t _first = 0;               // Первый занятый узел
+			uint32_t _used = 0;                // Количество занятых узлов (пакеты и открытые передачи)
+			uint32_t _openCount = 0;           // Количество передач в открытом пакете
+			Batch _batches[MaxBatches];        // Кольцо пакетов
+			uint32_t _firstBatch = 0;          // Первый (выполняемый) пакет
+			uint32_t _batchCount = 0;          // Количество пакетов в очереди
+			bool _running = false;             // Первый пакет очереди выполняется
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,274 @@
+#ifndef DMA_SCHEDULER_HPP_
+#define DMA_SCHEDULER_HPP_
+
+#include "BaseDma.hpp"
+
+namespace BasePeripheral {
+	namespace Dma {
+		typedef uint64_t tick_t; // Тип данных для отсчетов времени планировщика
+
+		typedef Delegate<tick_t()> TimeSource_t; // Источник времени планировщика
+
+		struct TransferRequest;
+
+		typedef Delegate<void(TransferRequest&)> TransferCallback_t; // Обработчик завершения запроса
+
+		// Запрос на передачу для планировщика DMA. Запрос хранится вызывающей стороной и не должен
+		// разрушаться до вызова onComplete (очереди планировщика интрузивные и не выделяют память)
+		struct TransferRequest {
+			Descriptor descriptor;                    // Передача (или начало цепочки дескрипторов)
+			Direction direction = Direction::MemoryToMemory; // Направление передачи
+			Priority priority = Priority::Low;        // Класс приоритета
+			TransferCallback_t onComplete;            // Обработчик завершения
+
+			// Заполняются планировщиком
+			channel_number_t channel = 0;             // Канал, на котором выполнялся запрос
+			uint32_t preemptions = 0;                 // Количество вытеснений
+			tick_t submitTick = 0;                    // Время постановки в очередь
+			tick_t startTick = 0;                     // Время первого запуска на канале
+			tick_t completeTick = 0;                  // Время завершения
+			ChainStatus status = ChainStatus::Complete; // Результат: Error - ошибка передачи или запрос не удалось запустить
+
+			TransferRequest* nextInQueue = nullptr;   // Следующий запрос в очереди приоритета
+		};
+
+		// Статистика использования канала планировщиком
+		struct ChannelStats {
+			uint32_t transfers = 0;   // Количество завершенных запросов
+			uint32_t preemptions = 0; // Количество вытеснений запросов с канала
+			uint64_t items = 0;       // Количество переданных элементов (для одиночных дескрипторов)
+			tick_t busyTicks = 0;     // Суммарное время занятости канала
+		};
+
+		// Планировщик передач DMA: распределяет запросы с приоритетами по свободным каналам из пула.
+		// Для каждого класса Priority ведется своя очередь FIFO; освободившийся канал получает запрос из самой
+		// приоритетной непустой очереди. При включенном вытеснении запрос, для которого нет свободного канала,
+		// вытесняет выполняемый запрос более низкого класса (только одиночный дескриптор с невыполненным остатком):
+		// канал останавливается, его необработанные флаги событий и состояние цепочки сбрасываются, остаток
+		// передачи возвращается в начало очереди своего класса и будет продолжен с места остановки.
+		// Controller - BaseDma или StaticDma. Методы планировщика и завершение передач (прерывание DMA)
+		// не должны выполняться одновременно.
+		template <typename Controller>
+		class DmaScheduler {
+		public:
+			static constexpr uint32_t ChannelsCount = Controller::ChannelMaxNumber + 1;
+			static constexpr uint32_t PriorityClasses = 4;
+
+			static_assert(ChannelsCount <= 32, "Channel pool mask supports up to 32 channels");
+
+			// Конструктор. channelMask - каналы, отданные планировщику (бит N - канал N)
+			DmaScheduler(Controller& dma, uint32_t channelMask, bool preemptive = false, TimeSource_t timeSource = TimeSource_t())
+				: _dma(dma), _channelMask(channelMask & static_cast<uint32_t>((1ull << ChannelsCount) - 1u)),
+				_preemptive(preemptive), _timeSource(timeSource) {}
+
+			DmaScheduler(const DmaScheduler&) = delete;
+			DmaScheduler& operator=(const DmaScheduler&) = delete;
+
+			// Ставит запрос в очередь своего класса приоритета и запускает его, если есть свободный канал
+			void submit(TransferRequest& request) {
+				request.preemptions = 0;
+				request.submitTick = now();
+				request.startTick = 0;
+				request.completeTick = 0;
+				request.status = ChainStatus::Complete;
+				enqueue(request, false);
+				if (_preemptive && freeChannel() == NoChannel)
+					preemptFor(request.priority);
+				dispatch();
+			}
+
+			// Количество запросов в очередях (без выполняемых)
+			uint32_t queued() const { return _queued; }
+
+			// Количество выполняемых запросов
+			uint32_t active() const {
+				uint32_t count = 0;
+				for (const TransferRequest* request : _active)
+					count += request != nullptr ? 1u : 0u;
+				return count;
+			}
+
+			// Статистика канала
+			const ChannelStats& stats(channel_number_t channel) const { return _stats[channel]; }
+
+			// Доля времени занятости канала за период elapsed (0..1)
+			double utilisation(channel_number_t channel, tick_t elapsed) const {
+				tick_t busy = _stats[channel].busyTicks;
+				if (_active[channel] != nullptr)
+					busy += now() - _busySince[channel];
+				return elapsed != 0 ? static_cast<double>(busy) / static_cast<double>(elapsed) : 0.0;
+			}
+
+			// Сбрасывает статистику каналов
+			void resetStats() {
+				for (channel_number_t channel = 0; channel < ChannelsCount; ++channel) {
+					_stats[channel] = ChannelStats();
+					_busySince[channel] = now();
+				}
+			}
+
+		private:
+			static constexpr channel_number_t NoChannel = ChannelsCount;
+
+			// Очередь FIFO запросов одного класса приоритета
+			struct Queue {
+				TransferRequest* head = nullptr;
+				TransferRequest* tail = nullptr;
+			};
+
+			tick_t now() const { return _timeSource ? _timeSource() : 0; }
+
+			// Добавляет запрос в конец (или в начало) очереди его класса
+			void enqueue(TransferRequest& request, bool front) {
+				Queue& queue = _queues[static_cast<uint32_t>(request.priority) & 3u];
+				if (front) {
+					request.nextInQueue = queue.head;
+					queue.head = &request;
+					if (queue.tail == nullptr)
+						queue.tail = &request;
+				}
+				else {
+					request.nextInQueue = nullptr;
+					if (queue.tail != nullptr)
+						queue.tail->nextInQueue = &request;
+					else
+						queue.head = &request;
+					queue.tail = &request;
+				}
+				++_queued;
+			}
+
+			// Извлекает запрос из самой приоритетной непустой очереди
+			TransferRequest* dequeue() {
+				for (uint32_t priorityClass = PriorityClasses; priorityClass-- > 0;) {
+					Queue& queue = _queues[priorityClass];
+					TransferRequest* request = queue.head;
+					if (request == nullptr)
+						continue;
+					queue.head = request->nextInQueue;
+					if (queue.head == nullptr)
+						queue.tail = nullptr;
+					request->nextInQueue = nullptr;
+					--_queued;
+					return request;
+				}
+				return nullptr;
+			}
+
+			// Возвращает свободный канал пула или NoChannel
+			channel_number_t freeChannel() const {
+				for (channel_number_t channel = 0; channel < ChannelsCount; ++channel)
+					if (((_channelMask >> channel) & 1u) != 0 && _active[channel] == nullptr)
+						return channel;
+				return NoChannel;
+			}
+
+			// Запускает запросы из очередей на свободных каналах. Повторный вход (передача завершилась прямо
+			// при запуске) только отмечает необходимость еще одного прохода внешнего цикла
+			void dispatch() {
+				if (_dispatching) {
+					_redispatch = true;
+					return;
+				}
+				_dispatching = true;
+				do {
+					_redispatch = false;
+					channel_number_t channel;
+					while (_queued != 0 && (channel = freeChannel()) != NoChannel)
+						start(channel, *dequeue());
+				} while (_redispatch);
+				_dispatching = false;
+			}
+
+			// Запускает запрос на канале
+			void start(channel_number_t channel, TransferRequest& request) {
+				const tick_t tick = now();
+				if (request.startTick == 0 && request.preemptions == 0)
+					request.startTick = tick;
+				request.channel = channel;
+				_active[channel] = &request;
+				_busySince[channel] = tick;
+				_dma.disableChannel(channel);
+				const bool started = _dma.initChannel(channel, Settings(request.direction, Mode::Normal, request.priority)) &&
+					_dma.submitChain(channel, &request.descriptor,
+						ChainCallback_t::template bind<DmaScheduler, &DmaScheduler::onChainComplete>(this));
+				if (!started && _active[channel] == &request)
+					finish(channel, ChainStatus::Error); // Запрос завершается без передачи, чтобы не занимать канал
+			}
+
+			// Вытесняет выполняемый запрос самого низкого класса ниже priority
+			void preemptFor(Priority priority) {
+				channel_number_t victim = NoChannel;
+				for (channel_number_t channel = 0; channel < ChannelsCount; ++channel) {
+					const TransferRequest* request = _active[channel];
+					if (request == nullptr || request->priority >= priority || request->descriptor.next != nullptr ||
+						_dma.getDataCount(channel) == 0)
+						continue;
+					if (victim == NoChannel || request->priority < _active[victim]->priority)
+						victim = channel;
+				}
+				if (victim == NoChannel)
+					return;
+
+				TransferRequest& request = *_active[victim];
+				_dma.disableChannel(victim);
+				const uint32_t remaining = _dma.getDataCount(victim);
+				if (remaining == 0)
+					return; // Передача уже выполнена: запрос завершится по ожидающему прерыванию
+				_dma.cancelChain(victim); // Флаги остановленной передачи не должны завершить следующую
+				const Descriptor& descriptor = request.descriptor;
+				const uint32_t done = descriptor.getCount() - remaining;
+				const uint32_t width = 1u << static_cast<uint32_t>(descriptor.getWidth());
+				request.descriptor = Descriptor(
+					descriptor.getSrc() + (descriptor.getSrcIncrement() == IncrementMode::Increment ? done * width : 0u),
+					descriptor.getDst() + (descriptor.getDstIncrement() == IncrementMode::Increment ? done * width : 0u),
+					remaining, descriptor.getWidth(), descriptor.getSrcIncrement(), descriptor.getDstIncrement());
+
+				ChannelStats& stats = _stats[victim];
+				stats.items += done;
+				stats.busyTicks += now() - _busySince[victim];
+				++stats.preemptions;
+				++request.preemptions;
+				_active[victim] = nullptr;
+				enqueue(request, true);
+			}
+
+			// Обработчик завершения цепочки канала
+			void onChainComplete(channel_number_t channel, ChainStatus status) {
+				if (channel >= ChannelsCount || _active[channel] == nullptr)
+					return;
+				TransferRequest& request = *_active[channel];
+				if (request.descriptor.next == nullptr && status == ChainStatus::Complete)
+					_stats[channel].items += request.descriptor.getCount();
+				++_stats[channel].transfers;
+				finish(channel, status);
+				dispatch();
+			}
+
+			// Освобождает канал и уведомляет владельца запроса
+			void finish(channel_number_t channel, ChainStatus status) {
+				TransferRequest& request = *_active[channel];
+				request.status = status;
+				request.completeTick = now();
+				_stats[channel].busyTicks += request.completeTick - _busySince[channel];
+				_active[channel] = nullptr;
+				if (request.onComplete)
+					request.onComplete(request);
+			}
+
+			Controller& _dma;                               // Контроллер DMA
+			uint32_t _channelMask;                          // Каналы пула
+			bool _preemptive;                               // Вытеснение запросов низших классов
+			TimeSource_t _timeSource;                       // Источник времени (без него время равно 0)
+			Queue _queues[PriorityClasses];                 // Очереди по классам приоритета
+			uint32_t _queued = 0;                           // Количество запросов в очередях
+			TransferRequest* _active[ChannelsCount] = {};   // Выполняемые запросы по каналам
+			tick_t _busySince[ChannelsCount] = {};          // Время запуска текущего запроса канала
+			ChannelStats _stats[ChannelsCount];             // Статистика каналов
+			bool _dispatching = false;                      // Выполняется dispatch
+			bool _redispatch = false;                       // Требуется повторный проход dispatch
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef DMA_STREAM_HPP_
+#define DMA_STREAM_HPP_
+
+#include <atomic>
+#include "BaseDma.hpp"
+
+namespace BasePeripheral {
+	namespace Dma {
+		// Поток данных поверх циклического канала DMA с двойной буферизацией.
+		// DMA непрерывно заполняет buffer из BufferItems элементов; по событиям HalfTransfer и TransferComplete
+		// заполненная половина публикуется в очередь одного производителя и одного потребителя (SPSC) без блокировок.
+		// Потребитель получает span прямо на буфер DMA (без копирования): acquire - получить, release - вернуть.
+		// Span действителен, пока DMA не завершит следующую половину (после этого запись идет в ту же половину).
+		// Переполнение фиксируется, если опубликовать половину некуда (потребитель не забрал две предыдущие)
+		// или если release обнаружил, что половина была перезаписана во время обработки.
+		//
+		// Канал должен быть заранее настроен (initChannel) в режиме Mode::Circular со стороной памяти на buffer.
+		// Controller - BaseDma или StaticDma. Обработчик событий вызывается из прерывания DMA (производитель),
+		// acquire/release - из одного потока-потребителя.
+		template <typename Controller, typename T, uint32_t BufferItems>
+		class CircularStream {
+			static_assert(BufferItems >= 2 && BufferItems % 2 == 0, "Circular buffer must consist of two equal halves");
+
+		public:
+			static constexpr uint32_t HalfItems = BufferItems / 2; // Размер половины буфера в элементах
+
+			// Заполненная половина буфера
+			struct Span {
+				const T* data = nullptr; // Начало половины в буфере DMA
+				uint32_t count = 0;      // Количество элементов
+				uint32_t sequence = 0;   // Порядковый номер половины с момента запуска (пропуски означают потерю данных)
+			};
+
+			CircularStream(Controller& dma, channel_number_t channel, T* buffer) : _dma(dma), _channel(channel), _buffer(buffer) {}
+
+			CircularStream(const CircularStream&) = delete;
+			CircularStream& operator=(const CircularStream&) = delete;
+
+			// Запускает поток: задает количество элементов, подписывается на события канала и включает канал
+			bool start() {
+				_head.store(0, std::memory_order_relaxed);
+				_tail.store(0, std::memory_order_relaxed);
+				_produced.store(0, std::memory_order_relaxed);
+				_overruns.store(0, std::memory_order_relaxed);
+				_errors.store(0, std::memory_order_relaxed);
+				_dma.setDataCount(_channel, BufferItems);
+				_dma.setEventHandler(_channel, ChannelEventHandler_t::template bind<CircularStream, &CircularStream::onEvent>(this));
+				_dma.setEvents(_channel, Event::All);
+				return _dma.enableChannel(_channel);
+			}
+
+			// Останавливает поток
+			void stop() {
+				_dma.disableChannel(_channel);
+				_dma.setEvents(_channel, 0);
+				_dma.setEventHandler(_channel, ChannelEventHandler_t());
+			}
+
+			// Получает самую старую непрочитанную половину без удаления из очереди. Возвращает false, если очередь пуста
+			bool acquire(Span& span) const {
+				const uint32_t tail = _tail.load(std::memory_order_relaxed);
+				if (tail == _head.load(std::memory_order_acquire))
+					return false;
+				span = _spans[tail % QueueDepth];
+				return true;
+			}
+
+			// Возвращает половину, полученную acquire. Возвращает false (и учитывает переполнение),
+			// если за время обработки DMA начал перезаписывать эту половину
+			bool release(const Span& span) {
+				_tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+				if (isValid(span))
+					return true;
+				_overruns.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+
+			// Возвращает true, если данные половины еще не перезаписываются DMA
+			bool isValid(const Span& span) const {
+				return _produced.load(std::memory_order_acquire) - span.sequence <= 1;
+			}
+
+			// Количество непрочитанных половин
+			uint32_t pending() const {
+				return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_relaxed);
+			}
+
+			// Количество заполненных половин с момента запуска
+			uint32_t produced() const { return _produced.load(std::memory_order_relaxed); }
+
+			// Количество переполнений (потерянных или перезаписанных во время обработки половин)
+			uint32_t overruns() const { return _overruns.load(std::memory_order_relaxed); }
+
+			// Количество ошибок передачи
+			uint32_t errors() const { return _errors.load(std::memory_order_relaxed); }
+
+		private:
+			static constexpr uint32_t QueueDepth = 2; // Больше двух половин одновременно действительными быть не могут
+
+			// Обработчик событий канала (производитель)
+			void onEvent(channel_number_t, uint32_t events) {
+				if ((events & Event::TransferError) != 0)
+					_errors.fetch_add(1, std::memory_order_relaxed);
+				if ((events & Event::HalfTransfer) != 0)
+					publish(0);
+				if ((events & Event::TransferComplete) != 0)
+					publish(HalfItems);
+			}
+
+			// Публикует заполненную половину, начинающуюся с элемента offset
+			void publish(uint32_t offset) {
+				const uint32_t sequence = _produced.load(std::memory_order_relaxed);
+				const uint32_t head = _head.load(std::memory_order_relaxed);
+				if (head - _tail.load(std::memory_order_acquire) >= QueueDepth) {
+					_overruns.fetch_add(1, std::memory_order_relaxed);
+				}
+				else {
+					Span& span = _spans[head % QueueDepth];
+					span.data = _buffer + offset;
+					span.count = HalfItems;
+					span.sequence = sequence;
+					_head.store(head + 1, std::memory_order_release);
+				}
+				_produced.store(sequence + 1, std::memory_order_release);
+			}
+
+			Controller& _dma;                       // Контроллер DMA
+			channel_number_t _channel;              // Циклический канал
+			T* _buffer;                             // Буфер DMA из BufferItems элементов
+			Span _spans[QueueDepth];                // Очередь опубликованных половин
+			std::atomic<uint32_t> _head{ 0 };       // Количество опубликованных половин (производитель)
+			std::atomic<uint32_t> _tail{ 0 };       // Количество возвращенных половин (потребитель)
+			std::atomic<uint32_t> _produced{ 0 };   // Количество заполненных половин
+			std::atomic<uint32_t> _overruns{ 0 };   // Количество переполнений
+			std::atomic<uint32_t> _errors{ 0 };     // Количество ошибок передачи
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,211 @@
+#ifndef ERROR_POLICY_HPP_
+#define ERROR_POLICY_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include "Delegate.hpp"
+
+namespace BasePeripheral {
+	typedef uint32_t error_t;
+
+	// Блок периферии, в котором возникла ошибка
+	enum class ErrorSource : uint8_t {
+		Unknown,
+		Gpio,
+		Dma,
+		Adc
+	};
+
+	// Событие ошибки: блок периферии, код ошибки (значение перечисления Error блока), номер пина или канала
+	// и отметка времени (заполняется политикой записи)
+	struct ErrorEvent {
+		static constexpr uint32_t NoIndex = 0xFFFFFFFFu; // Ошибка не относится к пину или каналу
+
+		uint64_t timestamp = 0;                 // Отметка времени (единицы задает источник времени политики)
+		error_t error = 0;                      // Код ошибки
+		uint32_t index = NoIndex;               // Номер пина или канала
+		ErrorSource source = ErrorSource::Unknown; // Блок периферии
+
+		constexpr ErrorEvent() = default;
+		constexpr ErrorEvent(ErrorSource source, error_t error, uint32_t index = NoIndex)
+			: error(error), index(index), source(source) {}
+	};
+
+	typedef Delegate<uint64_t()> ErrorTimeSource_t; // Источник отметок времени для событий ошибок
+
+	// Кольцо событий ошибок фиксированного размера без блокировок (несколько производителей, несколько
+	// потребителей; ячейки с порядковыми номерами). Запись из прерывания или любого потока не ждет:
+	// при переполнении событие отбрасывается и учитывается в dropped(). Capacity - степень двойки
+	template <uint32_t Capacity>
+	class ErrorRing {
+		static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Error ring capacity must be a power of two");
+
+	public:
+		ErrorRing() {
+			for (uint32_t i = 0; i < Capacity; ++i)
+				_cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+
+		ErrorRing(const ErrorRing&) = delete;
+		ErrorRing& operator=(const ErrorRing&) = delete;
+
+		// Добавляет событие. Возвращает false, если кольцо заполнено (событие отброшено)
+		bool push(const ErrorEvent& event) {
+			uint32_t position = _head.load(std::memory_order_relaxed);
+			for (;;) {
+				Cell& cell = _cells[position & (Capacity - 1)];
+				const int32_t diff = static_cast<int32_t>(cell.sequence.load(std::memory_order_acquire) - position);
+				if (diff == 0) {
+					if (_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+						cell.event = event;
+						cell.sequence.store(position + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (diff < 0) {
+					_dropped.fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+				else
+					position = _head.load(std::memory_order_relaxed);
+			}
+		}
+
+		// Извлекает самое старое событие. Возвращает false, если кольцо пусто
+		bool pop(ErrorEvent& event) {
+			uint32_t position = _tail.load(std::memory_order_relaxed);
+			for (;;) {
+				Cell& cell = _cells[position & (Capacity - 1)];
+				const int32_t diff = static_cast<int32_t>(cell.sequence.load(std::memory_order_acquire) - (position + 1));
+				if (diff == 0) {
+					if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+						event = cell.event;
+						cell.sequence.store(position + Capacity, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (diff < 0)
+					return false;
+				else
+					position = _tail.load(std::memory_order_relaxed);
+			}
+		}
+
+		// Передает все накопленные события в handler(const ErrorEvent&) и возвращает их количество
+		template <typename Handler>
+		uint32_t drain(Handler&& handler) {
+			uint32_t count = 0;
+			ErrorEvent event;
+			while (pop(event)) {
+				handler(static_cast<const ErrorEvent&>(event));
+				++count;
+			}
+			return count;
+		}
+
+		// Количество событий, отброшенных из-за переполнения
+		uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+		static constexpr uint32_t capacity() { return Capacity; }
+
+	private:
+		struct Cell {
+			std::atomic<uint32_t> sequence; // Порядковый номер ячейки
+			ErrorEvent event;
+		};
+
+		alignas(64) std::atomic<uint32_t> _head{ 0 }; // Позиция записи
+		alignas(64) std::atomic<uint32_t> _tail{ 0 }; // Позиция чтения
+		std::atomic<uint32_t> _dropped{ 0 };          // Отброшенные события
+		Cell _cells[Capacity];
+	};
+
+	// Политики обработки ошибок блоков периферии. Политика принимает событие report(const ErrorEvent&)
+	// и предоставляет count() и last(); выбирается параметром шаблона реализации блока периферии.
+	//
+	// Ошибки не обрабатываются: report сводится к пустой встроенной функции и удаляется компилятором
+	struct NullErrorPolicy {
+		static constexpr bool Enabled = false;
+
+		void report(const ErrorEvent&) {}
+		uint32_t count() const { return 0; }
+		ErrorEvent last() const { return ErrorEvent(); }
+	};
+
+	// Ошибки подсчитываются: количество и код последней ошибки (атомарные счетчики, без блокировок).
+	// Последнее событие упаковано в одно 64-битное слово: блок (8 бит), код ошибки (младшие ErrorBits бит;
+	// коды перечислений Error блоков - небольшие последовательные значения) и номер пина или канала (32 бита)
+	class CountingErrorPolicy {
+	public:
+		static constexpr bool Enabled = true;
+
+		void report(const ErrorEvent& event) {
+			_last.store(pack(event), std::memory_order_relaxed);
+			_count.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		uint32_t count() const { return _count.load(std::memory_order_relaxed); }
+
+		// Последняя ошибка (без отметки времени)
+		ErrorEvent last() const {
+			const uint64_t packed = _last.load(std::memory_order_relaxed);
+			return ErrorEvent(static_cast<ErrorSource>(packed >> 56), static_cast<error_t>((packed >> 32) & ErrorMask),
+				static_cast<uint32_t>(packed));
+		}
+
+		void reset() {
+			_count.store(0, std::memory_order_relaxed);
+			_last.store(pack(ErrorEvent()), std::memory_order_relaxed);
+		}
+
+	private:
+		static constexpr uint32_t ErrorBits = 24;
+		static constexpr error_t ErrorMask = (1u << ErrorBits) - 1u;
+
+		static uint64_t pack(const ErrorEvent& event) {
+			return (static_cast<uint64_t>(event.source) << 56) | (static_cast<uint64_t>(event.error & ErrorMask) << 32) | event.index;
+		}
+
+		std::atomic<uint32_t> _count{ 0 };
+		std::atomic<uint64_t> _last{ ErrorEvent::NoIndex };
+	};
+
+	// Ошибки записываются с отметкой времени в кольцо ErrorRing<Capacity>; кольцо разбирается вне
+	// критичного по времени кода (drain), например в фоновой задаче
+	template <uint32_t Capacity = 64>
+	class RecordingErrorPolicy {
+	public:
+		static constexpr bool Enabled = true;
+
+		explicit RecordingErrorPolicy(ErrorTimeSource_t timeSource = ErrorTimeSource_t()) : _timeSource(timeSource) {}
+
+		void setTimeSource(ErrorTimeSource_t timeSource) { _timeSource = timeSource; }
+
+		void report(const ErrorEvent& event) {
+			ErrorEvent stamped = event;
+			stamped.timestamp = _timeSource ? _timeSource() : 0;
+			_counter.report(stamped);
+			_ring.push(stamped);
+		}
+
+		uint32_t count() const { return _counter.count(); }
+		ErrorEvent last() const { return _counter.last(); }
+
+		// Передает накопленные события в handler(const ErrorEvent&) и возвращает их количество
+		template <typename Handler>
+		uint32_t drain(Handler&& handler) { return _ring.drain(handler); }
+
+		// Извлекает самое старое событие
+		bool pop(ErrorEvent& event) { return _ring.pop(event); }
+
+		// Количество событий, не поместившихся в кольцо
+		uint32_t dropped() const { return _ring.dropped(); }
+
+	private:
+		ErrorTimeSource_t _timeSource;   // Источник отметок времени
+		CountingErrorPolicy _counter;    // Счетчики
+		ErrorRing<Capacity> _ring;       // Кольцо событий
+	};
+}
+
+#endif
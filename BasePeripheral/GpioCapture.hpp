@@ -0,0 +1,258 @@
+#ifndef GPIO_CAPTURE_HPP_
+#define GPIO_CAPTURE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "BitOps.hpp"
+#include "DmaStream.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BP_GPIO_CAPTURE_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BP_GPIO_CAPTURE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define BP_GPIO_CAPTURE_NEON 1
+#endif
+
+namespace BasePeripheral {
+	namespace Gpio {
+		// Запись сжатого потока выборок: момент (номер выборки), маска изменившихся пинов и новые уровни.
+		// Для выборок по 16 бит запись занимает 8 байт
+		template <typename Sample>
+		struct EdgeRecord {
+			uint32_t timestamp; // Номер выборки с момента сброса компрессора (по модулю 2^32)
+			Sample changed;     // Пины, уровень которых изменился
+			Sample levels;      // Уровни пинов после изменения
+		};
+
+		namespace CaptureKernels {
+			// Возвращает индекс первой выборки i из [begin, count), у которой ((samples[i] ^ samples[i - 1]) & mask) != 0,
+			// или count, если изменений нет (begin >= 1). Векторные реализации (AVX2, SSE2 или NEON) сравнивают
+			// выборки со сдвинутыми на одну позицию и пропускают блоки без изменений целиком
+			template <typename Sample>
+			size_t findChange(const Sample* samples, size_t begin, size_t count, Sample mask) {
+				static_assert(std::is_unsigned<Sample>::value && sizeof(Sample) <= 4, "Sample must be an unsigned integer up to 32 bits");
+				size_t i = begin;
+#if defined(BP_GPIO_CAPTURE_AVX2) || defined(BP_GPIO_CAPTURE_SSE2)
+				// Маска, размноженная на все элементы вектора
+				const uint32_t pattern = sizeof(Sample) == 1 ? static_cast<uint32_t>(mask) * 0x01010101u :
+					sizeof(Sample) == 2 ? static_cast<uint32_t>(mask) * 0x00010001u : static_cast<uint32_t>(mask);
+#endif
+#if defined(BP_GPIO_CAPTURE_AVX2)
+				{
+					constexpr size_t Lanes = 32 / sizeof(Sample);
+					const __m256i vMask = _mm256_set1_epi32(static_cast<int>(pattern));
+					const __m256i vZero = _mm256_setzero_si256();
+					for (; i + Lanes <= count; i += Lanes) {
+						const __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(samples + i));
+						const __m256i previous = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(samples + i - 1));
+						const __m256i diff = _mm256_and_si256(_mm256_xor_si256(current, previous), vMask);
+						const uint32_t equal = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(diff, vZero)));
+						if (equal != 0xFFFFFFFFu)
+							return i + Bits::countTrailingZeros(~equal) / sizeof(Sample);
+					}
+				}
+#endif
+#if defined(BP_GPIO_CAPTURE_SSE2)
+				{
+					constexpr size_t Lanes = 16 / sizeof(Sample);
+					const __m128i vMask = _mm_set1_epi32(static_cast<int>(pattern));
+					const __m128i vZero = _mm_setzero_si128();
+					for (; i + Lanes <= count; i += Lanes) {
+						const __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+						const __m128i previous = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i - 1));
+						const __m128i diff = _mm_and_si128(_mm_xor_si128(current, previous), vMask);
+						const uint32_t equal = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(diff, vZero)));
+						if (equal != 0xFFFFu)
+							return i + Bits::countTrailingZeros(~equal & 0xFFFFu) / sizeof(Sample);
+					}
+				}
+#elif defined(BP_GPIO_CAPTURE_NEON)
+				{
+					// Векторно проверяется только наличие изменения в блоке, позиция уточняется скалярным циклом ниже
+					constexpr size_t Lanes = 16 / sizeof(Sample);
+					const uint8x16_t vMask = sizeof(Sample) == 1 ? vdupq_n_u8(static_cast<uint8_t>(mask)) :
+						sizeof(Sample) == 2 ? vreinterpretq_u8_u16(vdupq_n_u16(static_cast<uint16_t>(mask))) :
+						vreinterpretq_u8_u32(vdupq_n_u32(static_cast<uint32_t>(mask)));
+					for (; i + Lanes <= count; i += Lanes) {
+						const uint8x16_t current = vld1q_u8(reinterpret_cast<const uint8_t*>(samples + i));
+						const uint8x16_t previous = vld1q_u8(reinterpret_cast<const uint8_t*>(samples + i - 1));
+						const uint64x2_t diff = vreinterpretq_u64_u8(vandq_u8(veorq_u8(current, previous), vMask));
+						if ((vgetq_lane_u64(diff, 0) | vgetq_lane_u64(diff, 1)) != 0)
+							break;
+					}
+				}
+#endif
+				for (; i < count; ++i)
+					if (((samples[i] ^ samples[i - 1]) & mask) != 0)
+						return i;
+				return count;
+			}
+		}
+
+		// Потоковый компрессор выборок входного регистра порта: последовательность выборок сводится к записям
+		// EdgeRecord только для выборок, в которых изменился хотя бы один пин маски. Блоки передаются
+		// последовательно (process), состояние между блоками сохраняется. Первая выборка после сброса задает
+		// начальные уровни (initialLevels) и записи не порождает
+		template <typename Sample = uint16_t>
+		class EdgeCompressor {
+		public:
+			typedef EdgeRecord<Sample> Record;
+
+			// Сбрасывает состояние. mask - отслеживаемые пины (изменения остальных игнорируются)
+			void reset(Sample mask = static_cast<Sample>(~Sample(0))) {
+				_mask = mask;
+				_levels = _initial = 0;
+				_time = 0;
+				_records = 0;
+				_primed = false;
+			}
+
+			// Обрабатывает count выборок. sink(const Record&) вызывается для каждой записи.
+			// Возвращает количество записей
+			template <typename Sink>
+			uint32_t process(const Sample* samples, size_t count, Sink&& sink) {
+				if (count == 0)
+					return 0;
+				size_t i = 0;
+				if (!_primed) {
+					_initial = _levels = static_cast<Sample>(samples[0] & _mask);
+					_primed = true;
+					i = 1;
+				}
+				uint32_t records = 0;
+				// Первая выборка блока сравнивается с последними уровнями предыдущего блока
+				if (i == 0) {
+					if (((samples[0] & _mask) ^ _levels) != 0)
+						emit(0, samples[0], sink, records);
+					i = 1;
+				}
+				while ((i = CaptureKernels::findChange(samples, i, count, _mask)) < count) {
+					emit(i, samples[i], sink, records);
+					++i;
+				}
+				_time += static_cast<uint32_t>(count);
+				_records += records;
+				return records;
+			}
+
+			// Пропускает count потерянных выборок (сохраняет непрерывность отметок времени при переполнении);
+			// изменения за время пропуска попадут в одну запись с первой выборкой после него
+			void skip(size_t count) { _time += static_cast<uint32_t>(count); }
+
+			Sample mask() const { return _mask; }
+			Sample initialLevels() const { return _initial; }  // Уровни первой выборки
+			Sample levels() const { return _levels; }          // Уровни последней выборки
+			uint32_t time() const { return _time; }            // Количество обработанных и пропущенных выборок
+			uint32_t records() const { return _records; }      // Количество записей с момента сброса
+
+		private:
+			template <typename Sink>
+			void emit(size_t index, Sample sample, Sink& sink, uint32_t& records) {
+				const Sample levels = static_cast<Sample>(sample & _mask);
+				Record record;
+				record.timestamp = _time + static_cast<uint32_t>(index);
+				record.changed = static_cast<Sample>(levels ^ _levels);
+				record.levels = levels;
+				_levels = levels;
+				++records;
+				sink(static_cast<const Record&>(record));
+			}
+
+			Sample _mask = static_cast<Sample>(~Sample(0)); // Отслеживаемые пины
+			Sample _levels = 0;                            // Уровни последней выборки
+			Sample _initial = 0;                           // Уровни первой выборки
+			uint32_t _time = 0;                            // Номер следующей выборки
+			uint32_t _records = 0;                         // Количество записей
+			bool _primed = false;                          // Первая выборка получена
+		};
+
+		// Режим логического анализатора: канал DMA с постоянной частотой (запросы от таймера) читает входной
+		// регистр порта (IDR) в циклический буфер из BufferSamples выборок, заполненные половины буфера
+		// сжимаются в записи EdgeRecord. Ширина выборки задает ширину передачи DMA (uint8_t, uint16_t или uint32_t).
+		// При потере половины буфера отметки времени сохраняют непрерывность (см. EdgeCompressor::skip).
+		// DmaController - BaseDma или StaticDma; poll вызывается из одного потока.
+		template <typename DmaController, uint32_t BufferSamples, typename Sample = uint16_t>
+		class LogicCapture {
+		public:
+			typedef EdgeRecord<Sample> Record;
+
+			// Конструктор. buffer - буфер из BufferSamples выборок, bufferAddress - его адрес на шине DMA
+			LogicCapture(DmaController& dma, Dma::channel_number_t channel, Sample* buffer, Dma::address_t bufferAddress,
+				Dma::Priority priority = Dma::Priority::High)
+				: _dma(dma), _channel(channel), _bufferAddress(bufferAddress), _priority(priority), _stream(dma, channel, buffer) {}
+
+			LogicCapture(const LogicCapture&) = delete;
+			LogicCapture& operator=(const LogicCapture&) = delete;
+
+			// Настраивает канал DMA (периферия-память, циклический режим, без инкремента адреса периферии) на чтение
+			// регистра по адресу idrAddress и запускает захват. mask - отслеживаемые пины
+			bool start(Dma::address_t idrAddress, Sample mask = static_cast<Sample>(~Sample(0))) {
+				_dma.disableChannel(_channel);
+				const Dma::Settings settings(Dma::Direction::PeriphToMemory, Dma::Mode::Circular, _priority,
+					Dma::MemorySettings(idrAddress, SampleAlign, Dma::IncrementMode::NoIncrement),
+					Dma::MemorySettings(_bufferAddress, SampleAlign, Dma::IncrementMode::Increment));
+				if (!_dma.initChannel(_channel, settings))
+					return false;
+				_compressor.reset(mask);
+				_nextSequence = 0;
+				return _stream.start();
+			}
+
+			// Останавливает захват
+			void stop() { _stream.stop(); }
+
+			// Сжимает все заполненные половины буфера, передавая записи в sink(const Record&).
+			// Возвращает количество записей
+			template <typename Sink>
+			uint32_t poll(Sink&& sink) {
+				uint32_t records = 0;
+				typename Stream_t::Span span;
+				while (_stream.acquire(span)) {
+					// Половина, которую DMA уже начал перезаписывать, не сжимается: release учитывает ее как
+					// переполнение, а пропуск отметок времени учтется со следующей действительной половиной
+					if (!_stream.isValid(span)) {
+						_stream.release(span);
+						continue;
+					}
+					if (span.sequence != _nextSequence)
+						_compressor.skip(static_cast<size_t>(span.sequence - _nextSequence) * Stream_t::HalfItems);
+					records += _compressor.process(span.data, span.count, sink);
+					_nextSequence = span.sequence + 1;
+					_stream.release(span);
+				}
+				return records;
+			}
+
+			// Компрессор захвата (начальные уровни, время, количество записей)
+			const EdgeCompressor<Sample>& compressor() const { return _compressor; }
+
+			// Количество переполнений (потерянных или перезаписанных во время сжатия половин буфера)
+			uint32_t overruns() const { return _stream.overruns(); }
+
+			// Количество ошибок передачи DMA
+			uint32_t errors() const { return _stream.errors(); }
+
+		private:
+			typedef Dma::CircularStream<DmaController, Sample, BufferSamples> Stream_t;
+
+			static constexpr Dma::DataAlign SampleAlign = sizeof(Sample) == 1 ? Dma::DataAlign::Byte :
+				sizeof(Sample) == 2 ? Dma::DataAlign::HalfWord : Dma::DataAlign::Word;
+
+			DmaController& _dma;                // Контроллер DMA
+			Dma::channel_number_t _channel;     // Канал DMA
+			Dma::address_t _bufferAddress;      // Адрес буфера на шине DMA
+			Dma::Priority _priority;            // Приоритет канала DMA
+			Stream_t _stream;                   // Поток половин буфера
+			EdgeCompressor<Sample> _compressor; // Компрессор выборок
+			uint32_t _nextSequence = 0;         // Ожидаемый номер следующей половины
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef GPIO_DESCRIPTORS_HPP_
+#define GPIO_DESCRIPTORS_HPP_
+
+#include <type_traits>
+#include "BaseGpio.hpp"
+
+namespace BasePeripheral {
+	namespace Gpio {
+		// Дескриптор пина, вычисляемый на этапе компиляции.
+		// Port - тип контроллера GPIO (наследник BaseGpio или StaticGpio), номер пина проверяется по Port::PinMaxNumber.
+		// Пример: typedef Pin<BoardGpio, 5, Mode::Output, Pull::NoPull, OutputType::PushPull, OutputSpeed::High> LedPin;
+		template <
+			typename Port,
+			pin_number_t N,
+			Mode PinMode = Mode::Output,
+			Pull PinPull = Pull::NoPull,
+			OutputType PinOutputType = OutputType::PushPull,
+			OutputSpeed PinOutputSpeed = OutputSpeed::Low
+		>
+		struct Pin {
+			static_assert(N <= Port::PinMaxNumber, "Pin number is out of range");
+
+			typedef Port Port_t;
+			static constexpr pin_number_t Number = N;
+
+			// Настройки пина
+			static constexpr Settings settings() {
+				return Settings(PinMode, PinPull, PinOutputType, PinOutputSpeed);
+			}
+		};
+
+		// Конфигурация группы пинов одного порта, свернутая на этапе компиляции в образ регистров.
+		// Применяется одним вызовом gpio.initPins<Config>() (или gpio.applyImage(Config::image)).
+		template <typename Port, typename... Pins>
+		struct PortConfig {
+			static_assert(std::conjunction<std::is_same<Port, typename Pins::Port_t>...>::value, "All pins must belong to the same port type");
+
+			typedef Port Port_t;
+			static constexpr uint32_t IOCount = Port::PinMaxNumber + 1;
+
+		private:
+			// Проверяет, что каждый пин встречается в конфигурации не более одного раза
+			static constexpr bool hasUniquePins() {
+				PinMask<IOCount> seen;
+				bool unique = true;
+				((unique = unique && !seen.test(Pins::Number), seen.set(Pins::Number)), ...);
+				return unique;
+			}
+
+			static constexpr PortImage<IOCount> build() {
+				PortImage<IOCount> result;
+				(result.add(Pins::Number, Pins::settings()), ...);
+				return result;
+			}
+
+		public:
+			static_assert(hasUniquePins(), "Pin is configured more than once");
+
+			// Образ регистров конфигурации порта
+			static constexpr PortImage<IOCount> image = build();
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,184 @@
+#ifndef GPIO_EVENT_PIPELINE_HPP_
+#define GPIO_EVENT_PIPELINE_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include "Delegate.hpp"
+#include "PinMask.hpp"
+#include "PinInterruptTable.hpp"
+
+namespace BasePeripheral {
+	namespace Gpio {
+		typedef uint64_t event_time_t;                   // Отметка времени событий (единицы задает источник времени)
+		typedef Delegate<event_time_t()> EventClock_t;   // Источник времени конвейера событий
+
+		// Событие пина после подавления дребезга
+		struct PinEvent {
+			event_time_t timestamp = 0; // Время последнего фронта перед установлением уровня
+			pin_number_t pin = 0;       // Номер пина
+			bool level = false;         // Установившийся уровень
+			uint32_t edges = 0;         // Количество фронтов, объединенных в событие
+		};
+
+		// Конвейер отложенной обработки внешних прерываний порта с подавлением дребезга.
+		// В прерывании (latch/latchPin) только отмечаются сработавшие пины, время последнего фронта и количество
+		// фронтов - без блокировок и вызовов обработчиков. Обработка (process) выполняется пакетами из рабочего
+		// потока или главного цикла: пин, на котором не было фронтов в течение времени подавления дребезга,
+		// считается установившимся; если его уровень отличается от последнего переданного, передается одно событие
+		// (все фронты пачки объединяются), иначе пачка фронтов считается помехой и отбрасывается.
+		// Прерывание может вызываться параллельно с process; process вызывается из одного потока.
+		template <uint32_t IOCount>
+		class EventPipeline {
+		public:
+			typedef PinMask<IOCount> Mask;
+
+			explicit EventPipeline(EventClock_t clock = EventClock_t()) : _clock(clock) {}
+
+			EventPipeline(const EventPipeline&) = delete;
+			EventPipeline& operator=(const EventPipeline&) = delete;
+
+			// Задает время подавления дребезга пина (0 - только объединение фронтов в пределах одного пакета)
+			void setDebounce(pin_number_t pin, event_time_t time) {
+				if (pin < IOCount)
+					_debounce[pin] = time;
+			}
+
+			// Задает время подавления дребезга для всех пинов маски
+			void setDebounce(const Mask& pins, event_time_t time) {
+				pins.forEach([&](pin_number_t pin) { _debounce[pin] = time; });
+			}
+
+			// Задает начальные (последние переданные) уровни пинов и сбрасывает состояние конвейера
+			void reset(const Mask& levels) {
+				for (uint32_t i = 0; i < Mask::WordsCount; ++i)
+					_pending[i].store(0, std::memory_order_relaxed);
+				for (uint32_t pin = 0; pin < IOCount; ++pin) {
+					_edges[pin].store(0, std::memory_order_relaxed);
+					_lastEdge[pin].store(0, std::memory_order_relaxed);
+				}
+				_reported = levels;
+				_settling = Mask();
+				_edgeCount = _events = _coalesced = _dropped = 0;
+			}
+
+			// Отмечает сработавшие пины (вызывается из прерывания порта)
+			void latch(const Mask& pending) {
+				const event_time_t now = _clock ? _clock() : 0;
+				pending.forEach([&](pin_number_t pin) { mark(pin, now); });
+				for (uint32_t i = 0; i < Mask::WordsCount; ++i)
+					if (pending.word(i) != 0)
+						_pending[i].fetch_or(pending.word(i), std::memory_order_release);
+			}
+
+			// Отмечает сработавший пин (вызывается из прерывания порта)
+			void latchPin(pin_number_t pin) {
+				if (pin >= IOCount)
+					return;
+				mark(pin, _clock ? _clock() : 0);
+				_pending[pin / Mask::WordBits].fetch_or(1u << (pin % Mask::WordBits), std::memory_order_release);
+			}
+
+			// Невыделяющий обработчик прерывания пина для BaseGpio::setPinInterruptHandler
+			PinInterruptHandler_t handler() {
+				return PinInterruptHandler_t::template bind<EventPipeline, &EventPipeline::latchPin>(this);
+			}
+
+			// Обрабатывает отмеченные пины. levels - текущие уровни пинов порта (например, BaseGpio::readPort()),
+			// handler(const PinEvent&) вызывается для каждого события. Возвращает количество событий
+			template <typename Handler>
+			uint32_t process(const Mask& levels, Handler&& handler) {
+				return process(levels, _clock ? _clock() : 0, handler);
+			}
+
+			// То же с явно заданным текущим временем
+			template <typename Handler>
+			uint32_t process(const Mask& levels, event_time_t now, Handler&& handler) {
+				Mask pins = _settling;
+				for (uint32_t i = 0; i < Mask::WordsCount; ++i)
+					pins.setWord(i, pins.word(i) | _pending[i].exchange(0, std::memory_order_acquire));
+
+				uint32_t events = 0;
+				Mask settling;
+				pins.forEach([&](pin_number_t pin) {
+					const event_time_t lastEdge = _lastEdge[pin].load(std::memory_order_relaxed);
+					if (now - lastEdge < _debounce[pin]) {
+						settling.set(pin); // Уровень еще не установился
+						return;
+					}
+					const uint32_t edges = _edges[pin].exchange(0, std::memory_order_relaxed);
+					if (edges == 0)
+						return;
+					_edgeCount += edges;
+					const bool level = levels.test(pin);
+					if (level == _reported.test(pin)) {
+						_dropped += edges; // Пачка фронтов вернулась к прежнему уровню - помеха
+						return;
+					}
+					_reported.set(pin, level);
+					_coalesced += edges - 1;
+					++_events;
+					++events;
+					PinEvent event;
+					event.timestamp = lastEdge;
+					event.pin = pin;
+					event.level = level;
+					event.edges = edges;
+					handler(static_cast<const PinEvent&>(event));
+				});
+				_settling = settling;
+				return events;
+			}
+
+			// Возвращает true, если есть отмеченные или ожидающие установления пины
+			bool pending() const {
+				if (_settling.any())
+					return true;
+				for (uint32_t i = 0; i < Mask::WordsCount; ++i)
+					if (_pending[i].load(std::memory_order_relaxed) != 0)
+						return true;
+				return false;
+			}
+
+			// Время, когда установится самый поздний из ожидающих пинов (для ожидания рабочего потока)
+			event_time_t nextDeadline() const {
+				event_time_t deadline = 0;
+				_settling.forEach([&](pin_number_t pin) {
+					const event_time_t time = _lastEdge[pin].load(std::memory_order_relaxed) + _debounce[pin];
+					deadline = time > deadline ? time : deadline;
+				});
+				return deadline;
+			}
+
+			// Последние переданные уровни пинов
+			const Mask& levels() const { return _reported; }
+
+			// Статистика: обработанные фронты; переданные события; фронты, объединенные с другими
+			// в одно событие; фронты, отброшенные как помехи (edges = events + coalesced + dropped)
+			uint32_t edges() const { return _edgeCount; }
+			uint32_t events() const { return _events; }
+			uint32_t coalesced() const { return _coalesced; }
+			uint32_t dropped() const { return _dropped; }
+
+		private:
+			// Запоминает время фронта и увеличивает счетчик фронтов пина
+			void mark(pin_number_t pin, event_time_t now) {
+				_lastEdge[pin].store(now, std::memory_order_relaxed);
+				_edges[pin].fetch_add(1, std::memory_order_relaxed);
+			}
+
+			EventClock_t _clock;                                 // Источник времени
+			std::atomic<uint32_t> _pending[Mask::WordsCount] = {}; // Пины, отмеченные в прерывании
+			std::atomic<uint32_t> _edges[IOCount] = {};          // Фронты с последней обработки по пинам
+			std::atomic<event_time_t> _lastEdge[IOCount] = {};   // Время последнего фронта по пинам
+			event_time_t _debounce[IOCount] = {};                // Время подавления дребезга по пинам
+			Mask _reported;                                      // Последние переданные уровни
+			Mask _settling;                                      // Пины, ожидающие установления уровня
+			uint32_t _edgeCount = 0;                             // Обработанные фронты
+			uint32_t _events = 0;                                // Переданные события
+			uint32_t _coalesced = 0;                             // Объединенные фронты
+			uint32_t _dropped = 0;                               // Отброшенные фронты
+		};
+	}
+}
+
+#endif
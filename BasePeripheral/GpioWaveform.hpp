@@ -0,0 +1,265 @@
+#ifndef GPIO_WAVEFORM_HPP_
+#define GPIO_WAVEFORM_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "BaseDma.hpp"
+#include "PinMask.hpp"
+
+namespace BasePeripheral {
+	namespace Gpio {
+		// Генерация сигналов на выходах порта через DMA. Временная диаграмма компилируется в буфер слов регистра
+		// BSRR: одно слово на такт (слот) диаграммы, биты 0-15 устанавливают выходы, биты 16-31 сбрасывают,
+		// нулевое слово оставляет выходы без изменений. Канал DMA (память-периферия) по запросам таймера
+		// пересылает слова в BSRR порта, поэтому фронты формируются без участия процессора и без джиттера.
+		// Поддерживаются порты до 16 пинов (ширина BSRR).
+		namespace Waveform {
+			typedef uint32_t word_t; // Слово регистра BSRR
+
+			static constexpr pin_number_t MaxPins = 16; // Пины, адресуемые одним словом BSRR
+
+			// Слово установки выходов маски
+			constexpr word_t setWord(uint32_t mask) { return mask & 0xFFFFu; }
+
+			// Слово сброса выходов маски
+			constexpr word_t resetWord(uint32_t mask) { return (mask & 0xFFFFu) << 16; }
+
+			// Слово записи значений values в выходы маски
+			constexpr word_t writeWord(uint32_t mask, uint32_t values) {
+				return setWord(mask & values) | resetWord(mask & ~values);
+			}
+
+			// Фронт временной диаграммы: в слоте tick выход pin принимает уровень level
+			struct Edge {
+				uint32_t tick = 0;
+				pin_number_t pin = 0;
+				bool level = false;
+			};
+
+			// Компилирует диаграмму из count фронтов (в любом порядке) в буфер из slots слов.
+			// Несколько фронтов в одном слоте объединяются в одно слово; если один пин в слоте переключается
+			// дважды, действует последний фронт в массиве. Возвращает false, если фронт выходит за пределы буфера
+			// или порта (остальные фронты при этом компилируются)
+			inline bool compile(const Edge* edges, size_t count, word_t* buffer, uint32_t slots) {
+				std::memset(buffer, 0, slots * sizeof(word_t));
+				bool valid = true;
+				for (size_t i = 0; i < count; ++i) {
+					const Edge& edge = edges[i];
+					if (edge.tick >= slots || edge.pin >= MaxPins) {
+						valid = false;
+						continue;
+					}
+					const uint32_t bit = 1u << edge.pin;
+					word_t& word = buffer[edge.tick];
+					word = edge.level ? (word & ~resetWord(bit)) | setWord(bit) : (word & ~setWord(bit)) | resetWord(bit);
+				}
+				return valid;
+			}
+
+			// Кодировщик светодиодов WS2812 (и совместимых SK6812): до 16 параллельных линий на одном порту.
+			// Бит передается тремя слотами (при частоте слотов 2,4 МГц - 417 нс): высокий уровень в первом слоте,
+			// во втором - высокий для единицы и низкий для нуля, в третьем - низкий. Порядок байтов (GRB и т.п.)
+			// задается данными, биты передаются старшим вперед. После данных добавляется пауза сброса (латч)
+			struct Ws2812 {
+				static constexpr uint32_t SlotsPerBit = 3;   // Слотов на бит
+				static constexpr uint32_t ResetSlots = 120;  // Слотов паузы сброса (50 мкс при 2,4 МГц)
+
+				// Размер буфера для bytes байтов на линию
+				static constexpr uint32_t bufferSlots(size_t bytes) {
+					return static_cast<uint32_t>(bytes) * 8 * SlotsPerBit + ResetSlots;
+				}
+
+				// Кодирует одну линию на выходе pin. Возвращает количество записанных слотов (bufferSlots(bytes))
+				static uint32_t encode(word_t* buffer, const uint8_t* data, size_t bytes, pin_number_t pin) {
+					return encode(buffer, &data, 1, bytes, pin);
+				}
+
+				// Кодирует laneCount линий по bytes байтов: линия i выводится на пин firstPin + i.
+				// Возвращает количество записанных слотов (0, если линии не помещаются в порт)
+				static uint32_t encode(word_t* buffer, const uint8_t* const* lanes, uint32_t laneCount, size_t bytes,
+					pin_number_t firstPin = 0) {
+					if (laneCount == 0 || firstPin + laneCount > MaxPins)
+						return 0;
+					const uint32_t lanesMask = ((1u << laneCount) - 1u) << firstPin;
+					const word_t high = setWord(lanesMask);
+					const word_t low = resetWord(lanesMask);
+					word_t* slot = buffer;
+					for (size_t i = 0; i < bytes; ++i) {
+						// Маски линий с нулевыми битами: бит 7 передается первым
+						uint32_t zeros[8] = {};
+						for (uint32_t lane = 0; lane < laneCount; ++lane) {
+							const uint32_t inverted = ~static_cast<uint32_t>(lanes[lane][i]);
+							const uint32_t pinBit = firstPin + lane;
+							for (uint32_t bit = 0; bit < 8; ++bit)
+								zeros[bit] |= ((inverted >> (7 - bit)) & 1u) << pinBit;
+						}
+						for (uint32_t bit = 0; bit < 8; ++bit) {
+							slot[0] = high;
+							slot[1] = resetWord(zeros[bit]);
+							slot[2] = low;
+							slot += SlotsPerBit;
+						}
+					}
+					std::memset(slot, 0, ResetSlots * sizeof(word_t));
+					return bufferSlots(bytes);
+				}
+			};
+
+			// Кодировщик параллельной шины с записью по фронту строба (интерфейс Intel 8080 дисплеев, защелки).
+			// Слово передается двумя слотами: данные на dataWidth выходах начиная с dataShift вместе со спадом WR,
+			// затем подъем WR (приемник защелкивает данные по нарастающему фронту)
+			struct ParallelBus {
+				static constexpr uint32_t SlotsPerWord = 2; // Слотов на слово
+
+				static constexpr uint32_t bufferSlots(size_t count) { return static_cast<uint32_t>(count) * SlotsPerWord; }
+
+				// Кодирует count слов. Возвращает количество записанных слотов (0, если пины шины пересекаются
+				// или не помещаются в порт)
+				static uint32_t encode(word_t* buffer, const uint16_t* data, size_t count,
+					pin_number_t dataShift, uint32_t dataWidth, pin_number_t wrPin) {
+					if (dataWidth == 0 || dataShift + dataWidth > MaxPins || wrPin >= MaxPins)
+						return 0;
+					const uint32_t dataMask = ((1u << dataWidth) - 1u) << dataShift;
+					const uint32_t wrBit = 1u << wrPin;
+					if ((dataMask & wrBit) != 0)
+						return 0;
+					const word_t strobe = setWord(wrBit);
+					for (size_t i = 0; i < count; ++i) {
+						buffer[2 * i] = writeWord(dataMask | wrBit, static_cast<uint32_t>(data[i]) << dataShift);
+						buffer[2 * i + 1] = strobe;
+					}
+					return bufferSlots(count);
+				}
+			};
+
+			// Кодировщик SPI (режим 0: CPOL = 0, CPHA = 0), только передача, старшим битом вперед.
+			// Бит передается двумя слотами: MOSI выставляется вместе со спадом SCK, затем подъем SCK;
+			// завершающий слот возвращает SCK в низкий уровень. Выбор устройства (CS) управляется отдельно
+			struct Spi {
+				static constexpr uint32_t SlotsPerBit = 2; // Слотов на бит
+
+				static constexpr uint32_t bufferSlots(size_t bytes) {
+					return static_cast<uint32_t>(bytes) * 8 * SlotsPerBit + 1;
+				}
+
+				// Кодирует bytes байтов. Возвращает количество записанных слотов (0 при неверных пинах)
+				static uint32_t encode(word_t* buffer, const uint8_t* data, size_t bytes, pin_number_t sckPin, pin_number_t mosiPin) {
+					if (sckPin >= MaxPins || mosiPin >= MaxPins || sckPin == mosiPin)
+						return 0;
+					const uint32_t sckBit = 1u << sckPin;
+					const word_t one = setWord(1u << mosiPin) | resetWord(sckBit);
+					const word_t zero = resetWord((1u << mosiPin) | sckBit);
+					const word_t rise = setWord(sckBit);
+					word_t* slot = buffer;
+					for (size_t i = 0; i < bytes; ++i) {
+						const uint32_t value = data[i];
+						for (uint32_t bit = 0; bit < 8; ++bit) {
+							slot[0] = ((value >> (7 - bit)) & 1u) != 0 ? one : zero;
+							slot[1] = rise;
+							slot += SlotsPerBit;
+						}
+					}
+					*slot = resetWord(sckBit);
+					return bufferSlots(bytes);
+				}
+			};
+		}
+
+		typedef Delegate<void(uint32_t firstSlot, uint32_t count)> WaveformRefillHandler_t; // Освободилась часть буфера
+
+		// Проигрыватель скомпилированной диаграммы: настраивает канал DMA на пересылку слов буфера в регистр BSRR
+		// порта (память-периферия, слова, инкремент только адреса памяти). Темп задает периферия, формирующая
+		// запросы канала (обычно таймер). В однократном режиме isPlaying сбрасывается по завершении передачи,
+		// в циклическом диаграмма повторяется до stop; обработчик дозаполнения вызывается из прерывания DMA
+		// для половины буфера, которую DMA уже передал, чтобы следующий кадр можно было формировать на лету.
+		// DmaController - BaseDma или StaticDma.
+		template <typename DmaController>
+		class WaveformPlayer {
+		public:
+			WaveformPlayer(DmaController& dma, Dma::channel_number_t channel, Dma::Priority priority = Dma::Priority::VeryHigh)
+				: _dma(dma), _channel(channel), _priority(priority) {}
+
+			WaveformPlayer(const WaveformPlayer&) = delete;
+			WaveformPlayer& operator=(const WaveformPlayer&) = delete;
+
+			// Задает обработчик дозаполнения буфера (только для циклического режима)
+			void setRefillHandler(WaveformRefillHandler_t handler) { _refill = handler; }
+
+			// Запускает вывод slots слов буфера по адресу bufferAddress (адрес на шине DMA) в регистр BSRR
+			// по адресу bsrrAddress. repeat - повторять диаграмму (циклический режим)
+			bool play(Dma::address_t bufferAddress, uint32_t slots, Dma::address_t bsrrAddress, bool repeat = false) {
+				if (slots == 0)
+					return false;
+				_dma.disableChannel(_channel);
+				const Dma::Settings settings(Dma::Direction::MemoryToPeriph, repeat ? Dma::Mode::Circular : Dma::Mode::Normal, _priority,
+					Dma::MemorySettings(bsrrAddress, Dma::DataAlign::Word, Dma::IncrementMode::NoIncrement),
+					Dma::MemorySettings(bufferAddress, Dma::DataAlign::Word, Dma::IncrementMode::Increment));
+				if (!_dma.initChannel(_channel, settings))
+					return false;
+				_slots = slots;
+				_repeat = repeat;
+				_passes.store(0, std::memory_order_relaxed);
+				_playing.store(true, std::memory_order_release);
+				_dma.setDataCount(_channel, slots);
+				_dma.setEventHandler(_channel, Dma::ChannelEventHandler_t::template bind<WaveformPlayer, &WaveformPlayer::onEvent>(this));
+				_dma.setEvents(_channel, Dma::Event::TransferComplete | Dma::Event::TransferError |
+					(repeat && _refill ? Dma::Event::HalfTransfer : 0u));
+				if (_dma.enableChannel(_channel))
+					return true;
+				_playing.store(false, std::memory_order_relaxed);
+				return false;
+			}
+
+			// Останавливает вывод (выходы сохраняют последний выведенный уровень)
+			void stop() {
+				_dma.disableChannel(_channel);
+				_dma.setEvents(_channel, 0);
+				_dma.setEventHandler(_channel, Dma::ChannelEventHandler_t());
+				_playing.store(false, std::memory_order_release);
+			}
+
+			// Возвращает true, пока диаграмма выводится
+			bool isPlaying() const { return _playing.load(std::memory_order_acquire); }
+
+			// Количество полностью выведенных проходов диаграммы
+			uint32_t passes() const { return _passes.load(std::memory_order_relaxed); }
+
+			// Количество ошибок передачи
+			uint32_t errors() const { return _errors.load(std::memory_order_relaxed); }
+
+		private:
+			// Обработчик событий канала (вызывается из прерывания DMA)
+			void onEvent(Dma::channel_number_t, uint32_t events) {
+				if ((events & Dma::Event::TransferError) != 0) {
+					_errors.fetch_add(1, std::memory_order_relaxed);
+					_playing.store(false, std::memory_order_release);
+					return;
+				}
+				const uint32_t half = _slots / 2;
+				if ((events & Dma::Event::HalfTransfer) != 0 && _refill)
+					_refill(0, half);
+				if ((events & Dma::Event::TransferComplete) != 0) {
+					_passes.fetch_add(1, std::memory_order_relaxed);
+					if (!_repeat)
+						_playing.store(false, std::memory_order_release);
+					else if (_refill)
+						_refill(half, _slots - half);
+				}
+			}
+
+			DmaController& _dma;                   // Контроллер DMA
+			Dma::channel_number_t _channel;        // Канал вывода
+			Dma::Priority _priority;               // Приоритет канала
+			WaveformRefillHandler_t _refill;       // Обработчик дозаполнения буфера
+			uint32_t _slots = 0;                   // Длина диаграммы в слотах
+			bool _repeat = false;                  // Циклический режим
+			std::atomic<bool> _playing{ false };   // Идет вывод
+			std::atomic<uint32_t> _passes{ 0 };    // Выведенные проходы
+			std::atomic<uint32_t> _errors{ 0 };    // Ошибки передачи
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef PIN_INTERRUPT_TABLE_HPP_
+#define PIN_INTERRUPT_TABLE_HPP_
+
+#include "Delegate.hpp"
+#include "PinMask.hpp"
+
+namespace BasePeripheral {
+	namespace Gpio {
+		typedef Delegate<void(pin_number_t)> PinInterruptHandler_t; // Невыделяющий обработчик прерывания пина
+
+		// Таблица обработчиков внешних прерываний по пинам порта.
+		// Обработчики хранятся в массиве фиксированного размера IOCount, поэтому диспетчеризация не выделяет память,
+		// а ее время ограничено количеством одновременно сработавших пинов с зарегистрированным обработчиком.
+		// Регистрировать и удалять обработчики следует при запрещенном прерывании соответствующего пина.
+		template <uint32_t IOCount>
+		class PinInterruptTable {
+		public:
+			typedef PinMask<IOCount> Mask;
+
+			// Регистрирует обработчик для указанного пина (пустой обработчик эквивалентен detach)
+			void attach(pin_number_t pin, PinInterruptHandler_t handler) {
+				if (pin >= IOCount)
+					return;
+				_handlers[pin] = handler;
+				_registered.set(pin, static_cast<bool>(handler));
+			}
+
+			// Удаляет обработчик указанного пина
+			void detach(pin_number_t pin) {
+				if (pin >= IOCount)
+					return;
+				_handlers[pin] = nullptr;
+				_registered.reset(pin);
+			}
+
+			// Возвращает маску пинов с зарегистрированными обработчиками
+			const Mask& registered() const { return _registered; }
+
+			// Вызывает обработчики для установленных битов маски pending (поиск битов через count-trailing-zeros).
+			// Возвращает маску сработавших пинов, для которых обработчик не зарегистрирован
+			Mask dispatch(const Mask& pending) const {
+				(pending & _registered).forEach([this](pin_number_t pin) {
+					_handlers[pin](pin);
+				});
+				return pending & ~_registered;
+			}
+
+		private:
+			PinInterruptHandler_t _handlers[IOCount]; // Обработчики по номерам пинов
+			Mask _registered;                         // Маска пинов с зарегистрированными обработчиками
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef PIN_MASK_HPP_
+#define PIN_MASK_HPP_
+
+#include <cstdint>
+#include "BitOps.hpp"
+
+namespace BasePeripheral {
+	namespace Gpio {
+		typedef uint32_t pin_number_t;  // Тип данных для номера пина
+
+		// Битовая маска пинов порта произвольной ширины (аналог std::bitset с доступом к 32-битным словам).
+		// Бит N соответствует пину N, биты за пределами IOCount всегда сброшены.
+		template <uint32_t IOCount>
+		class PinMask {
+		public:
+			typedef uint32_t word_t;
+
+			static constexpr uint32_t WordBits = 32;                                    // Количество бит в слове маски
+			static constexpr uint32_t WordsCount = (IOCount + WordBits - 1) / WordBits; // Количество слов маски
+
+			// Пустая маска
+			constexpr PinMask() : _words{} {}
+
+			// Маска из младших 64 бит значения (удобно для портов шириной до 64 пинов)
+			constexpr explicit PinMask(uint64_t value) : _words{} {
+				for (uint32_t i = 0; i < WordsCount && i < 2; ++i)
+					_words[i] = static_cast<word_t>(value >> (i * WordBits));
+				trim();
+			}
+
+			// Маска, содержащая только указанный пин
+			static constexpr PinMask fromPin(pin_number_t pin) {
+				PinMask mask;
+				mask.set(pin);
+				return mask;
+			}
+
+			// Маска, содержащая все пины порта
+			static constexpr PinMask all() {
+				PinMask mask;
+				for (uint32_t i = 0; i < WordsCount; ++i)
+					mask._words[i] = ~word_t(0);
+				mask.trim();
+				return mask;
+			}
+
+			// Возвращает количество пинов, которое может хранить маска
+			static constexpr uint32_t size() { return IOCount; }
+
+			// Операции с отдельными пинами (пины вне диапазона игнорируются)
+			constexpr bool test(pin_number_t pin) const {
+				return pin < IOCount && ((_words[pin / WordBits] >> (pin % WordBits)) & 1u) != 0;
+			}
+			constexpr PinMask& set(pin_number_t pin, bool value = true) {
+				if (pin < IOCount) {
+					if (value)
+						_words[pin / WordBits] |= word_t(1) << (pin % WordBits);
+					else
+						_words[pin / WordBits] &= ~(word_t(1) << (pin % WordBits));
+				}
+				return *this;
+			}
+			constexpr PinMask& reset(pin_number_t pin) { return set(pin, false); }
+			constexpr PinMask& flip(pin_number_t pin) { return set(pin, !test(pin)); }
+
+			// Операции со всей маской
+			constexpr PinMask& reset() {
+				for (uint32_t i = 0; i < WordsCount; ++i)
+					_words[i] = 0;
+				return *this;
+			}
+			constexpr bool any() const {
+				for (uint32_t i = 0; i < WordsCount; ++i)
+					if (_words[i] != 0)
+						return true;
+				return false;
+			}
+			constexpr bool none() const { return !any(); }
+			uint32_t count() const {
+				uint32_t result = 0;
+				for (uint32_t i = 0; i < WordsCount; ++i)
+					result += Bits::popCount(_words[i]);
+				return result;
+			}
+
+			// Доступ к словам маски (для записи в регистры порта целыми словами)
+			constexpr word_t word(uint32_t index) const { return _words[index]; }
+			constexpr PinMask& setWord(uint32_t index, word_t value) {
+				_words[index] = value;
+				trim();
+				return *this;
+			}
+
+			// Вызывает f(pin) для каждого установленного бита в порядке возрастания номера пина
+			template <typename Function>
+			void forEach(Function&& f) const {
+				for (uint32_t i = 0; i < WordsCount; ++i) {
+					word_t bits = _words[i];
+					while (bits != 0) {
+						f(static_cast<pin_number_t>(i * WordBits + Bits::countTrailingZeros(bits)));
+						bits &= bits - 1;
+					}
+				}
+			}
+
+			// Побитовые операции
+			constexpr PinMask& operator&=(const PinMask& other) {
+				for (uint32_t i = 0; i < WordsCount; ++i)
+					_words[i] &= other._words[i];
+				return *this;
+			}
+			constexpr PinMask& operator|=(const PinMask& other) {
+				for (uint32_t i = 0; i < WordsCount; ++i)
+					_words[i] |= other._words[i];
+				return *this;
+			}
+			constexpr PinMask& operator^=(const PinMask& other) {
+				for (uint32_t i = 0; i < WordsCount; ++i)
+					_words[i] ^= other._words[i];
+				return *this;
+			}
+			constexpr PinMask operator~() const {
+				PinMask result;
+				for (uint32_t i = 0; i < WordsCount; ++i)
+					result._words[i] = ~_words[i];
+				result.trim();
+				return result;
+			}
+			friend constexpr PinMask operator&(PinMask lhs, const PinMask& rhs) { return lhs &= rhs; }
+			friend constexpr PinMask operator|(PinMask lhs, const PinMask& rhs) { return lhs |= rhs; }
+			friend constexpr PinMask operator^(PinMask lhs, const PinMask& rhs) { return lhs ^= rhs; }
+
+			// Операторы сравнения
+			constexpr bool operator==(const PinMask& other) const {
+				for (uint32_t i = 0; i < WordsCount; ++i)
+					if (_words[i] != other._words[i])
+						return false;
+				return true;
+			}
+
+			constexpr bool operator!=(const PinMask& other) const {
+				return !(*this == other);
+			}
+
+		private:
+			// Сбрасывает биты за пределами IOCount в последнем слове
+			constexpr void trim() {
+				if (IOCount % WordBits != 0)
+					_words[WordsCount - 1] &= (word_t(1) << (IOCount % WordBits)) - 1;
+			}
+
+			word_t _words[WordsCount];
+		};
+	}
+}
+
+#endif
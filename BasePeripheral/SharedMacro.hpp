@@ -1,16 +1,105 @@
 #ifndef SHARED_MACRO_HPP
 #define SHARED_MACRO_HPP
 
-#include <iostream>
-
 #ifndef __IO
 #define __IO volatile
 #endif
 
+// Профиль сборки без среды выполнения (микроконтроллеры, -ffreestanding, -fno-exceptions -fno-rtti).
+// При BP_FREESTANDING=1 заголовки не подключают <functional>, <string>, <chrono> и <cstdio>: внешний
+// обработчик прерываний GPIO становится невыделяющим делегатом, трассировка работает только
+// с пользовательским источником времени и без экспорта в строку. Исключения и RTTI библиотекой
+// не используются ни в одном профиле. По умолчанию включается для сред без стандартной библиотеки
+#ifndef BP_FREESTANDING
+#if defined(__STDC_HOSTED__) && __STDC_HOSTED__ == 0
+#define BP_FREESTANDING 1
+#else
+#define BP_FREESTANDING 0
+#endif
+#endif
+
+#if !BP_FREESTANDING
+#include <cstdio>
+#endif
+
+// Обработчик нарушенного утверждения RG_ASSERT_MSG. Обработчик по умолчанию сообщает о нарушении сразу:
+// в профиле со средой выполнения выводит сообщение в stderr, в профиле без среды выполнения останавливает
+// выполнение (исключение ядра или зацикливание, видимое отладчику). Синхронный вывод недопустим в обработчиках
+// прерываний и критичном по времени коде, поэтому приложение может установить свой обработчик, например
+// записывающий сообщение в журнал; nullptr отключает обработку
+typedef void (*RgAssertHandler_t)(unsigned long ulLine, char const* pcFileName, char const* message);
+
+inline void rgDefaultAssertHandler(unsigned long ulLine, char const* pcFileName, char const* message) {
+#if BP_FREESTANDING
+	(void)ulLine;
+	(void)pcFileName;
+	(void)message;
+#if defined(__GNUC__) || defined(__clang__)
+	__builtin_trap();
+#else
+	for (;;) {}
+#endif
+#else
+	std::fprintf(stderr, "Assertion failed: %s, file %s, line %lu\n", message, pcFileName, ulLine);
+#endif
+}
+
+inline RgAssertHandler_t rgAssertHandler = &rgDefaultAssertHandler;
+
+inline void rgSetAssertHandler(RgAssertHandler_t handler) {
+	rgAssertHandler = handler;
+}
+
 inline void rgAssertMsgCalled(unsigned long ulLine, char const* const pcFileName, char const* const message) {
-	std::cerr << "Assertion failed: " << message << ", file " << pcFileName << ", line " << ulLine << std::endl; \
+	if (rgAssertHandler != nullptr)
+		rgAssertHandler(ulLine, pcFileName, message);
 }
 
-#define RG_ASSERT_MSG(x, msg) if((x) == 0) rgAssertMsgCalled(__LINE__, __FILE__, msg)
+// Уровень сообщения журнала RG_LOG
+enum class RgLogLevel : unsigned char {
+	Debug,
+	Info,
+	Warning,
+	Error
+};
+
+// Обработчик сообщений журнала RG_LOG. Сообщения - статические строки, поэтому обработчику достаточно
+// сохранить указатель (например, в кольцевой буфер), а форматирование и вывод выполнить позже
+typedef void (*RgLogHandler_t)(RgLogLevel level, char const* message);
 
-#endif
\ No newline at end of file
+inline RgLogHandler_t rgLogHandler = nullptr;
+
+inline void rgSetLogHandler(RgLogHandler_t handler) {
+	rgLogHandler = handler;
+}
+
+inline void rgLogCalled(RgLogLevel level, char const* const message) {
+	if (rgLogHandler != nullptr)
+		rgLogHandler(level, message);
+}
+
+// Обработчики можно подключить и на этапе компиляции, определив RG_ASSERT_HOOK(line, file, msg) и
+// RG_LOG_HOOK(level, msg): тогда макросы вызывают их напрямую, без указателя на функцию
+#ifndef RG_ASSERT_HOOK
+#define RG_ASSERT_HOOK(line, file, msg) rgAssertMsgCalled(line, file, msg)
+#endif
+
+#ifndef RG_LOG_HOOK
+#define RG_LOG_HOOK(level, msg) rgLogCalled(level, msg)
+#endif
+
+// Проверка утверждения; при определенном RG_DISABLE_ASSERT проверка удаляется полностью
+#ifdef RG_DISABLE_ASSERT
+#define RG_ASSERT_MSG(x, msg) do { } while (0)
+#else
+#define RG_ASSERT_MSG(x, msg) do { if ((x) == 0) RG_ASSERT_HOOK(__LINE__, __FILE__, msg); } while (0)
+#endif
+
+// Сообщение журнала (level - имя элемента RgLogLevel); при определенном RG_DISABLE_LOG удаляется полностью
+#ifdef RG_DISABLE_LOG
+#define RG_LOG(level, msg) do { } while (0)
+#else
+#define RG_LOG(level, msg) do { RG_LOG_HOOK(RgLogLevel::level, msg); } while (0)
+#endif
+
+#endif
@@ -0,0 +1,289 @@
+#ifndef SIM_ADC_HPP_
+#define SIM_ADC_HPP_
+
+#include "BaseAdc.hpp"
+#include "BaseDma.hpp"
+#include "SimBus.hpp"
+
+namespace BasePeripheral {
+	namespace Sim {
+		// Раскладка регистров симулированного АЦП (в стиле STM32F4)
+		struct AdcRegisters {
+			__IO uint32_t SR;       // 0x00 Регистр состояния
+			__IO uint32_t CR1;      // 0x04 Управляющий регистр 1 (SCAN, RES)
+			__IO uint32_t CR2;      // 0x08 Управляющий регистр 2 (ADON, CONT, DMA, DDS, EXTSEL, EXTEN, SWSTART)
+			__IO uint32_t SMPR1;    // 0x0C Длительность выборки каналов 10-18 (3 бита на канал)
+			__IO uint32_t SMPR2;    // 0x10 Длительность выборки каналов 0-9 (3 бита на канал)
+			__IO uint32_t JOFR[4];  // 0x14 Смещения инжектированных каналов (не моделируются)
+			__IO uint32_t HTR;      // 0x24 Верхний порог аналогового сторожа (не моделируется)
+			__IO uint32_t LTR;      // 0x28 Нижний порог аналогового сторожа (не моделируется)
+			__IO uint32_t SQR1;     // 0x2C Последовательность: SQ13-SQ16 и длина L
+			__IO uint32_t SQR2;     // 0x30 Последовательность: SQ7-SQ12
+			__IO uint32_t SQR3;     // 0x34 Последовательность: SQ1-SQ6
+			__IO uint32_t JSQR;     // 0x38 Инжектированная последовательность (не моделируется)
+			__IO uint32_t JDR[4];   // 0x3C Данные инжектированных каналов (не моделируются)
+			__IO uint32_t DR;       // 0x4C Регистр данных
+		};
+
+		// Биты регистров АЦП
+		namespace AdcBits {
+			constexpr uint32_t SR_EOC = 1u << 1;       // Преобразование завершено
+			constexpr uint32_t SR_OVR = 1u << 5;       // Переполнение (результат не прочитан)
+			constexpr uint32_t CR1_SCAN = 1u << 8;     // Режим сканирования
+			constexpr uint32_t CR1_RES_Pos = 24;       // Разрядность (2 бита)
+			constexpr uint32_t CR2_ADON = 1u << 0;     // АЦП включен
+			constexpr uint32_t CR2_CONT = 1u << 1;     // Непрерывный режим
+			constexpr uint32_t CR2_DMA = 1u << 8;      // Запросы DMA
+			constexpr uint32_t CR2_DDS = 1u << 9;      // Непрерывные запросы DMA
+			constexpr uint32_t CR2_EXTSEL_Pos = 24;    // Источник внешнего запуска (4 бита)
+			constexpr uint32_t CR2_EXTEN_Pos = 28;     // Фронт внешнего запуска (2 бита)
+			constexpr uint32_t CR2_SWSTART = 1u << 30; // Программный запуск
+			constexpr uint32_t SQR1_L_Pos = 20;        // Длина последовательности минус 1 (4 бита)
+			constexpr address_t DR_Offset = 0x4C;      // Смещение регистра данных
+		}
+
+		typedef Delegate<uint32_t(Adc::channel_number_t)> AnalogSource_t; // Источник сигнала: 12-битное значение на входе канала
+		typedef Delegate<bool(Dma::channel_number_t)> DmaRequest_t;        // Запрос обслуживания канала DMA
+
+		// Симулированный АЦП с моделью регистров SR/CR1/CR2/SMPR/SQR/DR.
+		// Значения на входах задаются setInput или источником сигнала; каждое преобразование (convert/run)
+		// берет следующий канал последовательности, записывает результат в DR и, если запросы DMA разрешены,
+		// вызывает обработчик запроса DMA (например, SimDma::serviceRequest), который забирает DR через шину.
+		// Время преобразования в тактах АЦП - длительность выборки плюс разрядность.
+		// ErrorPolicy - политика обработки ошибок (NullErrorPolicy, CountingErrorPolicy, RecordingErrorPolicy<N>).
+		template <uint32_t ChannelsCount = 19, typename ErrorPolicy = CountingErrorPolicy>
+		class SimAdc : public Adc::BaseAdc<ChannelsCount> {
+			static_assert(ChannelsCount <= 19, "Simulated ADC supports up to 19 channels");
+
+		public:
+			// Конструктор. registers - внешний блок регистров, при nullptr используется собственный блок
+			explicit SimAdc(AdcRegisters* registers = nullptr)
+				: _ownRegisters(), _regs(registers != nullptr ? *registers : _ownRegisters) {}
+
+			SimAdc(const SimAdc&) = delete;
+			SimAdc& operator=(const SimAdc&) = delete;
+
+			// Блок регистров АЦП
+			AdcRegisters& registers() { return _regs; }
+			const AdcRegisters& registers() const { return _regs; }
+
+			// Отображает регистры АЦП на шину по адресу base
+			bool attach(SimBus& bus, address_t base) {
+				_baseAddress = base;
+				return bus.mapDevice(base, sizeof(AdcRegisters),
+					BusReadHandler_t(&SimAdc::busRead, this), BusWriteHandler_t(&SimAdc::busWrite, this));
+			}
+
+			// Задает 12-битное значение на входе канала
+			void setInput(Adc::channel_number_t channel, uint32_t value) {
+				if (channel < ChannelsCount)
+					_inputs[channel] = value & 0xFFFu;
+			}
+
+			// Задает источник сигнала (вместо значений setInput)
+			void setSource(AnalogSource_t source) { _source = source; }
+
+			// Подключает обработчик запросов DMA для канала dmaChannel
+			void connectDma(DmaRequest_t request, Dma::channel_number_t dmaChannel) {
+				_dmaRequest = request;
+				_dmaChannel = dmaChannel;
+			}
+
+			// Внешний сигнал запуска: запускает последовательность, если внешний запуск разрешен и источник совпадает
+			void trigger(Adc::trigger_source_t source) {
+				const uint32_t cr2 = _regs.CR2;
+				if (((cr2 >> AdcBits::CR2_EXTEN_Pos) & 3u) != 0 && ((cr2 >> AdcBits::CR2_EXTSEL_Pos) & 0xFu) == (source & 0xFu) && _armed)
+					_running = true;
+			}
+
+			// Возвращает true, если выполняются преобразования
+			bool isRunning() const { return _running; }
+
+			// Выполняет одно преобразование следующего канала последовательности.
+			// Возвращает время преобразования в тактах АЦП или 0, если преобразования остановлены
+			uint32_t convert() {
+				if (!_running)
+					return 0;
+				const uint32_t length = onGetSequenceLength();
+				const Adc::channel_number_t channel = sequenceChannel(_position);
+				const uint32_t bits = Adc::resolutionBits(static_cast<Adc::Resolution>((_regs.CR1 >> AdcBits::CR1_RES_Pos) & 3u));
+				const uint32_t input = (_source ? _source(channel) : _inputs[channel]) & 0xFFFu;
+
+				if ((_regs.SR & AdcBits::SR_EOC) != 0)
+					_regs.SR = _regs.SR | AdcBits::SR_OVR; // Предыдущий результат не был прочитан
+				_regs.DR = input >> (12u - bits);
+				_regs.SR = _regs.SR | AdcBits::SR_EOC;
+				++_conversions;
+
+				if ((_regs.CR2 & AdcBits::CR2_DMA) != 0 && _dmaRequest)
+					_dmaRequest(_dmaChannel);
+
+				if (++_position >= length) {
+					_position = 0;
+					if ((_regs.CR2 & AdcBits::CR2_CONT) == 0)
+						_running = false; // Однократный режим: последовательность завершена
+				}
+				return Adc::sampleTimeCycles(onGetSampleTime(channel)) + bits;
+			}
+
+			// Выполняет до count преобразований и возвращает их суммарное время в тактах АЦП
+			uint64_t run(uint32_t count) {
+				uint64_t cycles = 0;
+				for (uint32_t i = 0; i < count && _running; ++i)
+					cycles += convert();
+				return cycles;
+			}
+
+			// Количество выполненных преобразований
+			uint64_t conversions() const { return _conversions; }
+
+			// Политика ошибок и статистика ошибок
+			ErrorPolicy& errors() { return _errors; }
+			uint32_t errorCount() const { return _errors.count(); }
+			error_t lastError() const { return _errors.last().error; }
+
+			virtual bool isEnabled() const override { return _clockEnabled; }
+
+		protected:
+			virtual void onEnableClock() override {
+				_clockEnabled = true;
+				_regs.CR2 = _regs.CR2 | AdcBits::CR2_ADON;
+			}
+			virtual void onDisableClock() override {
+				_clockEnabled = false;
+				_regs.CR2 = _regs.CR2 & ~AdcBits::CR2_ADON;
+			}
+
+			virtual void onError(error_t error) override {
+				_errors.report(ErrorEvent(ErrorSource::Adc, error));
+			}
+
+			virtual void onErrorEvent(const ErrorEvent& event) override {
+				_errors.report(event);
+			}
+
+			virtual bool onSetSettings(const Adc::Settings& settings) override {
+				_regs.CR1 = (_regs.CR1 & ~(3u << AdcBits::CR1_RES_Pos)) |
+					(static_cast<uint32_t>(settings.getResolution()) << AdcBits::CR1_RES_Pos);
+				uint32_t cr2 = _regs.CR2 & ~(AdcBits::CR2_CONT | (3u << AdcBits::CR2_EXTEN_Pos) | (0xFu << AdcBits::CR2_EXTSEL_Pos));
+				if (settings.getConversionMode() == Adc::ConversionMode::Continuous)
+					cr2 |= AdcBits::CR2_CONT;
+				cr2 |= static_cast<uint32_t>(settings.getTriggerEdge()) << AdcBits::CR2_EXTEN_Pos;
+				cr2 |= settings.getTriggerSource() << AdcBits::CR2_EXTSEL_Pos;
+				_regs.CR2 = cr2;
+				return true;
+			}
+
+			virtual Adc::Settings onGetSettings() const override {
+				const uint32_t cr2 = _regs.CR2;
+				return Adc::Settings(
+					static_cast<Adc::Resolution>((_regs.CR1 >> AdcBits::CR1_RES_Pos) & 3u),
+					(cr2 & AdcBits::CR2_CONT) != 0 ? Adc::ConversionMode::Continuous : Adc::ConversionMode::Single,
+					static_cast<Adc::TriggerEdge>((cr2 >> AdcBits::CR2_EXTEN_Pos) & 3u),
+					(cr2 >> AdcBits::CR2_EXTSEL_Pos) & 0xFu);
+			}
+
+			virtual void onSetSampleTime(Adc::channel_number_t channel, Adc::SampleTime sampleTime) override {
+				__IO uint32_t& reg = channel < 10 ? _regs.SMPR2 : _regs.SMPR1;
+				const uint32_t position = (channel < 10 ? channel : channel - 10) * 3;
+				reg = (reg & ~(7u << position)) | ((static_cast<uint32_t>(sampleTime) & 7u) << position);
+			}
+
+			virtual Adc::SampleTime onGetSampleTime(Adc::channel_number_t channel) const override {
+				const uint32_t reg = channel < 10 ? _regs.SMPR2 : _regs.SMPR1;
+				const uint32_t position = (channel < 10 ? channel : channel - 10) * 3;
+				return static_cast<Adc::SampleTime>((reg >> position) & 7u);
+			}
+
+			virtual void onSetSequence(const Adc::channel_number_t* channels, uint32_t length) override {
+				uint32_t sqr[3] = { 0, 0, (length - 1) << AdcBits::SQR1_L_Pos }; // SQR3, SQR2, SQR1
+				for (uint32_t i = 0; i < length; ++i)
+					sqr[i / 6] |= (channels[i] & 0x1Fu) << ((i % 6) * 5);
+				_regs.SQR3 = sqr[0];
+				_regs.SQR2 = sqr[1];
+				_regs.SQR1 = sqr[2];
+				_regs.CR1 = length > 1 ? (_regs.CR1 | AdcBits::CR1_SCAN) : (_regs.CR1 & ~AdcBits::CR1_SCAN);
+				_position = 0;
+			}
+
+			virtual uint32_t onGetSequenceLength() const override {
+				return ((_regs.SQR1 >> AdcBits::SQR1_L_Pos) & 0xFu) + 1;
+			}
+
+			// Режим OneShot моделируется как Circular: количество запросов ограничивает сам канал DMA
+			virtual void onSetDmaMode(Adc::DmaMode mode) override {
+				uint32_t cr2 = _regs.CR2 & ~(AdcBits::CR2_DMA | AdcBits::CR2_DDS);
+				if (mode != Adc::DmaMode::Disabled)
+					cr2 |= AdcBits::CR2_DMA;
+				if (mode == Adc::DmaMode::Circular)
+					cr2 |= AdcBits::CR2_DDS;
+				_regs.CR2 = cr2;
+			}
+
+			virtual void onStart() override {
+				_position = 0;
+				_regs.SR = _regs.SR & ~(AdcBits::SR_EOC | AdcBits::SR_OVR);
+				if (((_regs.CR2 >> AdcBits::CR2_EXTEN_Pos) & 3u) != 0) {
+					_armed = true; // Ожидание внешнего запуска
+					return;
+				}
+				_regs.CR2 = _regs.CR2 | AdcBits::CR2_SWSTART;
+				_running = true;
+			}
+
+			virtual void onStop() override {
+				_running = false;
+				_armed = false;
+				_regs.CR2 = _regs.CR2 & ~AdcBits::CR2_SWSTART;
+			}
+
+			virtual Adc::sample_t onReadData() override {
+				_regs.SR = _regs.SR & ~AdcBits::SR_EOC;
+				return static_cast<Adc::sample_t>(_regs.DR);
+			}
+
+			virtual address_t onGetDataAddress() const override { return _baseAddress + AdcBits::DR_Offset; }
+
+			// Возвращает канал с индексом index в последовательности
+			Adc::channel_number_t sequenceChannel(uint32_t index) const {
+				const uint32_t reg = index < 6 ? _regs.SQR3 : index < 12 ? _regs.SQR2 : _regs.SQR1;
+				const Adc::channel_number_t channel = (reg >> ((index % 6) * 5)) & 0x1Fu;
+				return channel < ChannelsCount ? channel : 0;
+			}
+
+		private:
+			// Обработчики доступа к регистрам со стороны шины (чтение DR сбрасывает EOC, как при чтении процессором)
+			static uint32_t busRead(void* context, address_t offset, uint32_t) {
+				SimAdc& self = *static_cast<SimAdc*>(context);
+				if (offset == AdcBits::DR_Offset)
+					return self.onReadData();
+				return reinterpret_cast<const __IO uint32_t*>(&self._regs)[offset / 4];
+			}
+
+			static void busWrite(void* context, address_t offset, uint32_t value, uint32_t) {
+				SimAdc& self = *static_cast<SimAdc*>(context);
+				if (offset == AdcBits::DR_Offset)
+					return; // Регистр только для чтения
+				reinterpret_cast<__IO uint32_t*>(&self._regs)[offset / 4] = value;
+				if (offset == 0x08 && (value & AdcBits::CR2_SWSTART) != 0)
+					self.onStart();
+			}
+
+			AdcRegisters _ownRegisters;              // Собственный блок регистров
+			AdcRegisters& _regs;                     // Используемый блок регистров
+			uint32_t _inputs[ChannelsCount] = {};    // Значения на входах каналов
+			AnalogSource_t _source;                  // Источник сигнала
+			DmaRequest_t _dmaRequest;                // Обработчик запросов DMA
+			Dma::channel_number_t _dmaChannel = 0;   // Канал DMA для запросов
+			address_t _baseAddress = 0;              // Адрес АЦП на шине
+			uint32_t _position = 0;                  // Индекс следующего канала в последовательности
+			uint64_t _conversions = 0;               // Количество выполненных преобразований
+			bool _running = false;                   // Выполняются преобразования
+			bool _armed = false;                     // Ожидается внешний запуск
+			bool _clockEnabled = false;              // Тактирование АЦП включено
+			ErrorPolicy _errors;                     // Политика ошибок
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef SIM_BUS_HPP_
+#define SIM_BUS_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include "Delegate.hpp"
+
+namespace BasePeripheral {
+	namespace Sim {
+		typedef uint32_t address_t; // 32-битный адрес на симулированной шине
+
+		typedef Delegate<uint32_t(address_t offset, uint32_t size)> BusReadHandler_t;               // Чтение регистра устройства
+		typedef Delegate<void(address_t offset, uint32_t value, uint32_t size)> BusWriteHandler_t;  // Запись регистра устройства
+
+		// Симулированная 32-битная шина: отображает адреса контроллера на память хоста или на регистры устройств.
+		// Области памяти (mapMemory) обслуживаются прямым доступом к буферу хоста (это может быть и отображенный
+		// через mmap файл), области устройств (mapDevice) - обработчиками чтения/записи, что позволяет моделировать
+		// регистры с побочными эффектами (например, BSRR).
+		class SimBus {
+		public:
+			static constexpr uint32_t MaxRegions = 16; // Максимальное количество отображенных областей
+
+			// Отображает буфер хоста на диапазон адресов шины
+			bool mapMemory(address_t base, void* host, uint32_t size) {
+				Region* region = allocate(base, size);
+				if (region == nullptr)
+					return false;
+				region->host = static_cast<uint8_t*>(host);
+				return true;
+			}
+
+			// Отображает регистры устройства на диапазон адресов шины
+			bool mapDevice(address_t base, uint32_t size, BusReadHandler_t read, BusWriteHandler_t write) {
+				Region* region = allocate(base, size);
+				if (region == nullptr)
+					return false;
+				region->read = read;
+				region->write = write;
+				return true;
+			}
+
+			// Удаляет отображение области, начинающейся с указанного адреса
+			void unmap(address_t base) {
+				for (Region& region : _regions) {
+					if (region.size != 0 && region.base == base)
+						region = Region();
+				}
+			}
+
+			// Возвращает указатель на память хоста для диапазона [addr, addr + size) или nullptr,
+			// если диапазон не целиком лежит в одной области памяти
+			uint8_t* translate(address_t addr, uint32_t size) const {
+				const Region* region = find(addr, size);
+				if (region == nullptr || region->host == nullptr)
+					return nullptr;
+				return region->host + (addr - region->base);
+			}
+
+			// Возвращает true, если диапазон целиком отображен на одну область
+			bool isMapped(address_t addr, uint32_t size = 1) const {
+				return find(addr, size) != nullptr;
+			}
+
+			// Чтение значения шириной size (1, 2 или 4 байта). Чтение неотображенного адреса возвращает 0
+			uint32_t read(address_t addr, uint32_t size) const {
+				const Region* region = find(addr, size);
+				if (region == nullptr)
+					return 0;
+				if (region->host == nullptr)
+					return region->read ? region->read(addr - region->base, size) : 0;
+				uint32_t value = 0;
+				std::memcpy(&value, region->host + (addr - region->base), size);
+				return value;
+			}
+
+			// Запись значения шириной size (1, 2 или 4 байта). Запись по неотображенному адресу игнорируется
+			void write(address_t addr, uint32_t value, uint32_t size) {
+				const Region* region = find(addr, size);
+				if (region == nullptr)
+					return;
+				if (region->host == nullptr) {
+					if (region->write)
+						region->write(addr - region->base, value, size);
+					return;
+				}
+				std::memcpy(region->host + (addr - region->base), &value, size);
+			}
+
+		private:
+			// Отображенная область шины
+			struct Region {
+				address_t base = 0;        // Начальный адрес
+				uint32_t size = 0;         // Размер (0 - свободная запись таблицы)
+				uint8_t* host = nullptr;   // Память хоста (для областей памяти)
+				BusReadHandler_t read;     // Обработчик чтения (для устройств)
+				BusWriteHandler_t write;   // Обработчик записи (для устройств)
+			};
+
+			// Находит свободную запись таблицы, если диапазон не пересекается с уже отображенными
+			Region* allocate(address_t base, uint32_t size) {
+				if (size == 0 || static_cast<uint64_t>(base) + size > 0x100000000ull)
+					return nullptr;
+				Region* freeRegion = nullptr;
+				for (Region& region : _regions) {
+					if (region.size == 0) {
+						if (freeRegion == nullptr)
+							freeRegion = &region;
+					}
+					else if (base < region.base + region.size && region.base < base + size) {
+						return nullptr;
+					}
+				}
+				if (freeRegion != nullptr) {
+					*freeRegion = Region();
+					freeRegion->base = base;
+					freeRegion->size = size;
+				}
+				return freeRegion;
+			}
+
+			// Находит область, целиком содержащую диапазон [addr, addr + size)
+			const Region* find(address_t addr, uint32_t size) const {
+				for (const Region& region : _regions) {
+					if (region.size != 0 && addr >= region.base &&
+						static_cast<uint64_t>(addr) + size <= static_cast<uint64_t>(region.base) + region.size)
+						return &region;
+				}
+				return nullptr;
+			}
+
+			Region _regions[MaxRegions]; // Таблица отображенных областей
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef SIM_CLOCK_HPP_
+#define SIM_CLOCK_HPP_
+
+#include <cstdint>
+
+namespace BasePeripheral {
+	namespace Sim {
+		typedef uint64_t tick_t; // Тип данных для отсчетов симулированного времени
+
+		// Симулированные часы: счетчик тактов с заданной частотой.
+		// Время продвигается только явным вызовом advance, поэтому результаты симуляции детерминированы.
+		class SimClock {
+		public:
+			explicit SimClock(uint32_t frequencyHz = 72000000) : _frequencyHz(frequencyHz), _ticks(0) {}
+
+			// Возвращает текущее время в тактах
+			tick_t now() const { return _ticks; }
+
+			// Продвигает время на указанное количество тактов
+			void advance(tick_t ticks) { _ticks += ticks; }
+
+			// Сбрасывает время в ноль
+			void reset() { _ticks = 0; }
+
+			// Возвращает частоту часов
+			uint32_t frequency() const { return _frequencyHz; }
+
+			// Переводит такты в наносекунды
+			uint64_t toNanoseconds(tick_t ticks) const {
+				return ticks * 1000000000ull / _frequencyHz;
+			}
+
+		private:
+			uint32_t _frequencyHz; // Частота часов в Гц
+			tick_t _ticks;         // Текущее время в тактах
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,494 @@
+#ifndef SIM_DMA_HPP_
+#define SIM_DMA_HPP_
+
+#include "BaseDma.hpp"
+#include "SimBus.hpp"
+#include "DmaKernels.hpp"
+
+namespace BasePeripheral {
+	namespace Sim {
+		// Регистры канала симулированного DMA (в стиле STM32)
+		struct DmaChannelRegisters {
+			__IO uint32_t CCR;      // 0x00 Управляющий регистр канала
+			__IO uint32_t CNDTR;    // 0x04 Количество элементов данных (16 бит)
+			__IO uint32_t CPAR;     // 0x08 Адрес периферии (источника для память-память)
+			__IO uint32_t CMAR;     // 0x0C Адрес памяти (назначения для память-память)
+			uint32_t reserved;      // 0x10 Зарезервировано
+		};
+
+		// Раскладка регистров симулированного контроллера DMA с ChannelsCount каналами
+		template <uint32_t ChannelsCount>
+		struct DmaRegisters {
+			__IO uint32_t ISR;                      // 0x00 Флаги прерываний (4 бита на канал)
+			__IO uint32_t IFCR;                     // 0x04 Сброс флагов прерываний, только запись
+			DmaChannelRegisters CH[ChannelsCount];  // 0x08 Регистры каналов
+		};
+
+		// Биты управляющего регистра канала, не входящие в ChannelImage
+		namespace DmaCcr {
+			constexpr uint32_t EN = 1u << 0;   // Канал включен
+			constexpr uint32_t TCIE = 1u << 1; // Прерывание по завершению передачи
+			constexpr uint32_t HTIE = 1u << 2; // Прерывание по передаче половины данных
+			constexpr uint32_t TEIE = 1u << 3; // Прерывание по ошибке передачи
+		}
+
+		// Флаги канала в регистре ISR (сдвигаются на 4 * номер канала)
+		namespace DmaFlag {
+			constexpr uint32_t GIF = 1u << 0;  // Общий флаг прерывания канала
+			constexpr uint32_t TCIF = 1u << 1; // Передача завершена
+			constexpr uint32_t HTIF = 1u << 2; // Передана половина данных
+			constexpr uint32_t TEIF = 1u << 3; // Ошибка передачи
+			constexpr uint32_t All = 0xFu;     // Все флаги канала
+		}
+
+		typedef Delegate<void(Dma::channel_number_t channel, uint32_t flags)> DmaInterruptHandler_t; // Обработчик прерывания канала
+
+		// Симулированный контроллер DMA с моделью регистров ISR/IFCR/CCR/CNDTR/CPAR/CMAR.
+		// Управляющий регистр канала хранит образ ChannelImage, поэтому применение дескриптора канала -
+		// одна запись в CCR. При включении канала запоминается значение CNDTR для перезагрузки в циклическом режиме.
+		// Передачи выполняются через подключенную шину SimBus (см. connect): канал память-память выполняет
+		// передачу сразу при включении (или по вызовам step в отложенном режиме), каналы с периферией -
+		// по запросам (serviceRequest) или пакетно (run).
+		// Цепочки дескрипторов обходятся "аппаратно": следующий узел загружается в регистры канала по завершении
+		// текущего без прерываний, TCIF выставляется один раз после последнего узла.
+		// ErrorPolicy - политика обработки ошибок (NullErrorPolicy, CountingErrorPolicy, RecordingErrorPolicy<N>).
+		template <uint32_t ChannelsCount = 7, bool ShadowCache = false, typename ErrorPolicy = CountingErrorPolicy>
+		class SimDma : public Dma::BaseDma<ChannelsCount, ShadowCache> {
+			typedef Dma::BaseDma<ChannelsCount, ShadowCache> Base;
+
+		public:
+			typedef DmaRegisters<ChannelsCount> Registers_t;
+
+			// Конструктор. registers - внешний блок регистров (например, в отображенном файле),
+			// при nullptr используется собственный блок
+			explicit SimDma(Registers_t* registers = nullptr)
+				: _ownRegisters(), _regs(registers != nullptr ? *registers : _ownRegisters) {}
+
+			SimDma(const SimDma&) = delete;
+			SimDma& operator=(const SimDma&) = delete;
+
+			// Блок регистров контроллера
+			Registers_t& registers() { return _regs; }
+			const Registers_t& registers() const { return _regs; }
+
+			// Отображает регистры контроллера на шину по адресу base
+			bool attach(SimBus& bus, address_t base) {
+				return bus.mapDevice(base, sizeof(Registers_t),
+					BusReadHandler_t(&SimDma::busRead, this), BusWriteHandler_t(&SimDma::busWrite, this));
+			}
+
+			// Подключает шину, через которую выполняются передачи данных
+			void connect(SimBus& bus) { _bus = &bus; }
+
+			// Выполняет до maxItems элементов передачи включенного канала и возвращает количество переданных элементов.
+			// Источник и приемник определяются направлением: для PeriphToMemory и MemoryToMemory источник - CPAR,
+			// для MemoryToPeriph - CMAR. Флаги HTIF/TCIF выставляются при передаче половины и всего блока,
+			// в циклическом режиме после завершения блока CNDTR перезагружается и передача продолжается.
+			// Обращение к неотображенному адресу выставляет TEIF и выключает канал.
+			uint32_t run(Dma::channel_number_t channel, uint32_t maxItems = UINT32_MAX) {
+				if (channel >= ChannelsCount || _bus == nullptr)
+					return 0;
+				uint32_t transferred = 0;
+				while (transferred < maxItems && isChannelEnabled(channel)) {
+					DmaChannelRegisters& ch = _regs.CH[channel];
+					const uint32_t remaining = ch.CNDTR;
+					if (remaining == 0) {
+						if (!nextChainNode(channel))
+							break;
+						continue;
+					}
+					const uint32_t reload = _reload[channel] >= remaining ? _reload[channel] : remaining;
+					const uint32_t index = reload - remaining;
+					const uint32_t half = reload / 2;
+
+					// Пересылка блоками до границы половины или конца передачи, чтобы прерывания шли по порядку
+					uint32_t count = remaining;
+					if (index < half)
+						count = half - index;
+					if (count > maxItems - transferred)
+						count = maxItems - transferred;
+
+					if (!transferItems(channel, index, count)) {
+						ch.CCR = ch.CCR & ~DmaCcr::EN;
+						raiseInterrupt(channel, DmaFlag::TEIF);
+						break;
+					}
+					transferred += count;
+					ch.CNDTR = remaining - count;
+
+					if (_chainNode[channel] != nullptr) {
+						// В цепочке прерывания выставляются только по завершении последнего узла
+						if (ch.CNDTR == 0)
+							nextChainNode(channel);
+						continue;
+					}
+					if (half != 0 && index < half && index + count >= half)
+						raiseInterrupt(channel, DmaFlag::HTIF);
+					if (ch.CNDTR == 0) {
+						if ((ch.CCR & (1u << Dma::ChannelImage::CircPos)) != 0)
+							ch.CNDTR = reload;
+						raiseInterrupt(channel, DmaFlag::TCIF);
+					}
+				}
+				return transferred;
+			}
+
+			// Обслуживает один запрос периферии: передает один элемент данных. Возвращает true, если элемент передан
+			bool serviceRequest(Dma::channel_number_t channel) {
+				return run(channel, 1) == 1;
+			}
+
+			// Задает режим отложенной передачи память-память: при включении канал не выполняет передачу сразу,
+			// а продвигается вызовами run или step (модель контроллера, работающего параллельно с процессором)
+			void setDeferredMemoryToMemory(bool deferred) { _deferredMemoryToMemory = deferred; }
+
+			// Продвигает каждый включенный канал память-память не более чем на maxItems элементов.
+			// Возвращает суммарное количество переданных элементов
+			uint32_t step(uint32_t maxItems) {
+				uint32_t transferred = 0;
+				for (Dma::channel_number_t channel = 0; channel < ChannelsCount; ++channel)
+					if ((_regs.CH[channel].CCR & (1u << Dma::ChannelImage::Mem2MemPos)) != 0)
+						transferred += run(channel, maxItems);
+				return transferred;
+			}
+
+			// Задает обработчик прерываний каналов (аналог вектора прерывания). Если обработчик не задан,
+			// прерывание обслуживается методом handleInterrupt базового класса
+			void setInterruptHandler(DmaInterruptHandler_t handler) { _interruptHandler = handler; }
+
+			// Возвращает true, если канал включен
+			bool isChannelEnabled(Dma::channel_number_t channel) const {
+				return channel < ChannelsCount && (_regs.CH[channel].CCR & DmaCcr::EN) != 0;
+			}
+
+			// Разрешает прерывания канала (маска из битов DmaCcr::TCIE/HTIE/TEIE)
+			void enableInterrupts(Dma::channel_number_t channel, uint32_t ccrBits) {
+				if (channel < ChannelsCount)
+					_regs.CH[channel].CCR = _regs.CH[channel].CCR | (ccrBits & (DmaCcr::TCIE | DmaCcr::HTIE | DmaCcr::TEIE));
+			}
+
+			// Запрещает прерывания канала (маска из битов DmaCcr::TCIE/HTIE/TEIE)
+			void disableInterrupts(Dma::channel_number_t channel, uint32_t ccrBits) {
+				if (channel < ChannelsCount)
+					_regs.CH[channel].CCR = _regs.CH[channel].CCR & ~(ccrBits & (DmaCcr::TCIE | DmaCcr::HTIE | DmaCcr::TEIE));
+			}
+
+			// Возвращает флаги канала из ISR
+			uint32_t getFlags(Dma::channel_number_t channel) const {
+				return channel < ChannelsCount ? (_regs.ISR >> (channel * 4)) & DmaFlag::All : 0;
+			}
+
+			// Сбрасывает флаги канала
+			void clearFlags(Dma::channel_number_t channel, uint32_t flags) {
+				if (channel < ChannelsCount)
+					_regs.ISR = _regs.ISR & ~((flags & DmaFlag::All) << (channel * 4));
+			}
+
+			// Устанавливает флаги канала (DmaFlag::TCIF/HTIF/TEIF) и вызывает обработчик прерывания,
+			// если соответствующее прерывание разрешено в CCR
+			void raiseInterrupt(Dma::channel_number_t channel, uint32_t flags) {
+				if (channel >= ChannelsCount)
+					return;
+				flags &= DmaFlag::TCIF | DmaFlag::HTIF | DmaFlag::TEIF;
+				if (flags == 0)
+					return;
+				_regs.ISR = _regs.ISR | ((flags | DmaFlag::GIF) << (channel * 4));
+
+				const uint32_t ccr = _regs.CH[channel].CCR;
+				const uint32_t enabled = ((flags & DmaFlag::TCIF) && (ccr & DmaCcr::TCIE) ? DmaFlag::TCIF : 0u) |
+					((flags & DmaFlag::HTIF) && (ccr & DmaCcr::HTIE) ? DmaFlag::HTIF : 0u) |
+					((flags & DmaFlag::TEIF) && (ccr & DmaCcr::TEIE) ? DmaFlag::TEIF : 0u);
+				if (enabled == 0)
+					return;
+				if (_interruptHandler)
+					_interruptHandler(channel, enabled);
+				else
+					this->handleInterrupt(channel);
+			}
+
+			// Значение CNDTR, запомненное при включении канала (для перезагрузки в циклическом режиме)
+			uint32_t reloadCount(Dma::channel_number_t channel) const {
+				return channel < ChannelsCount ? _reload[channel] : 0;
+			}
+
+			// Политика ошибок и статистика ошибок
+			ErrorPolicy& errors() { return _errors; }
+			uint32_t errorCount() const { return _errors.count(); }
+			error_t lastError() const { return _errors.last().error; }
+
+			virtual bool isEnabled() const override { return _clockEnabled; }
+
+		protected:
+			static constexpr uint32_t CountMask = 0xFFFFu; // Разрядность регистра CNDTR
+
+			virtual void onEnableClock() override { _clockEnabled = true; }
+			virtual void onDisableClock() override { _clockEnabled = false; }
+
+			virtual void onError(error_t error) override {
+				_errors.report(ErrorEvent(ErrorSource::Dma, error));
+			}
+
+			virtual void onErrorEvent(const ErrorEvent& event) override {
+				_errors.report(event);
+			}
+
+			virtual bool onSetSettings(Dma::channel_number_t channel, const Dma::Settings& settings) override {
+				DmaChannelRegisters& ch = _regs.CH[channel];
+				ch.CCR = (ch.CCR & ~Dma::ChannelImage::ConfigMask) | settings.toImage().control;
+				ch.CPAR = settings.getPeriphOrMemToMemSrc().getAddr();
+				ch.CMAR = settings.getMemoryOrMemToMemDst().getAddr();
+				return true;
+			}
+
+			virtual Dma::Settings onGetSettings(Dma::channel_number_t channel) const override {
+				const DmaChannelRegisters& ch = _regs.CH[channel];
+				Dma::ChannelImage image;
+				image.control = ch.CCR;
+				return Dma::Settings::fromImage(image, ch.CPAR, ch.CMAR);
+			}
+
+			virtual bool onApplyChannelImage(Dma::channel_number_t channel, const Dma::ChannelImage& image,
+				Dma::address_t periphOrSrcAddr, Dma::address_t memoryOrDstAddr) override {
+				DmaChannelRegisters& ch = _regs.CH[channel];
+				ch.CCR = (ch.CCR & ~Dma::ChannelImage::ConfigMask) | image.control;
+				ch.CPAR = periphOrSrcAddr;
+				ch.CMAR = memoryOrDstAddr;
+				return true;
+			}
+
+			virtual bool onApplyChannelFields(Dma::channel_number_t channel, const Dma::ChannelImage& image,
+				Dma::address_t periphOrSrcAddr, Dma::address_t memoryOrDstAddr, uint32_t fields) override {
+				DmaChannelRegisters& ch = _regs.CH[channel];
+				if ((fields & Dma::ChannelField::Control) != 0)
+					ch.CCR = (ch.CCR & ~Dma::ChannelImage::ConfigMask) | image.control;
+				if ((fields & Dma::ChannelField::PeriphOrSrcAddr) != 0)
+					ch.CPAR = periphOrSrcAddr;
+				if ((fields & Dma::ChannelField::MemoryOrDstAddr) != 0)
+					ch.CMAR = memoryOrDstAddr;
+				return true;
+			}
+
+			virtual void onSetDirection(Dma::channel_number_t channel, Dma::Direction direction) override {
+				modifyImage(channel, [&](Dma::Settings& settings) { settings.setDirection(direction); });
+			}
+
+			virtual void onSetMode(Dma::channel_number_t channel, Dma::Mode mode) override {
+				modifyImage(channel, [&](Dma::Settings& settings) { settings.setMode(mode); });
+			}
+
+			virtual void onSetPriority(Dma::channel_number_t channel, Dma::Priority priority) override {
+				modifyImage(channel, [&](Dma::Settings& settings) { settings.setPriority(priority); });
+			}
+
+			virtual void onSetMemorySettings(Dma::channel_number_t channel, const Dma::MemorySettings& src, const Dma::MemorySettings& dst) override {
+				onSetSettings(channel, onGetSettings(channel).setPeriphOrMemToMemSrc(src).setMemoryOrMemToMemDst(dst));
+			}
+
+			virtual void onSetDataCount(Dma::channel_number_t channel, uint32_t count) override {
+				_regs.CH[channel].CNDTR = count & CountMask;
+			}
+
+			virtual uint32_t onGetDataCount(Dma::channel_number_t channel) const override {
+				return _regs.CH[channel].CNDTR;
+			}
+
+			virtual void onEnableChannel(Dma::channel_number_t channel) override {
+				_reload[channel] = _regs.CH[channel].CNDTR;
+				_regs.CH[channel].CCR = _regs.CH[channel].CCR | DmaCcr::EN;
+				startMemoryToMemory(channel);
+			}
+
+			virtual void onDisableChannel(Dma::channel_number_t channel) override {
+				_regs.CH[channel].CCR = _regs.CH[channel].CCR & ~DmaCcr::EN;
+				_chainNode[channel] = nullptr;
+			}
+
+			virtual void onSetEvents(Dma::channel_number_t channel, uint32_t events) override {
+				const uint32_t interrupts = ((events & Dma::Event::HalfTransfer) ? DmaCcr::HTIE : 0u) |
+					((events & Dma::Event::TransferComplete) ? DmaCcr::TCIE : 0u) |
+					((events & Dma::Event::TransferError) ? DmaCcr::TEIE : 0u);
+				_regs.CH[channel].CCR = (_regs.CH[channel].CCR & ~(DmaCcr::TCIE | DmaCcr::HTIE | DmaCcr::TEIE)) | interrupts;
+			}
+
+			virtual uint32_t onGetEvents(Dma::channel_number_t channel) const override {
+				const uint32_t flags = _regs.ISR >> (channel * 4);
+				const uint32_t ccr = _regs.CH[channel].CCR;
+				return ((flags & DmaFlag::HTIF) && (ccr & DmaCcr::HTIE) ? Dma::Event::HalfTransfer : 0u) |
+					((flags & DmaFlag::TCIF) && (ccr & DmaCcr::TCIE) ? Dma::Event::TransferComplete : 0u) |
+					((flags & DmaFlag::TEIF) && (ccr & DmaCcr::TEIE) ? Dma::Event::TransferError : 0u);
+			}
+
+			virtual void onClearEvents(Dma::channel_number_t channel, uint32_t events) override {
+				const uint32_t flags = ((events & Dma::Event::HalfTransfer) ? DmaFlag::HTIF : 0u) |
+					((events & Dma::Event::TransferComplete) ? DmaFlag::TCIF : 0u) |
+					((events & Dma::Event::TransferError) ? DmaFlag::TEIF : 0u);
+				clearFlags(channel, flags);
+				if ((getFlags(channel) & (DmaFlag::TCIF | DmaFlag::HTIF | DmaFlag::TEIF)) == 0)
+					clearFlags(channel, DmaFlag::GIF);
+			}
+
+			virtual bool onSubmitChain(Dma::channel_number_t channel, const Dma::Descriptor* head) override {
+				onDisableChannel(channel);
+				loadDescriptor(channel, *head);
+				_chainNode[channel] = head;
+				this->markHardwareChain(channel);
+				_regs.CH[channel].CCR = _regs.CH[channel].CCR | DmaCcr::EN;
+				startMemoryToMemory(channel);
+				return true;
+			}
+
+			// Загружает узел цепочки в регистры канала, сохраняя направление, режим, приоритет и бит включения
+			void loadDescriptor(Dma::channel_number_t channel, const Dma::Descriptor& descriptor) {
+				DmaChannelRegisters& ch = _regs.CH[channel];
+				Dma::Settings settings = onGetSettings(channel);
+				if (settings.getDirection() == Dma::Direction::MemoryToPeriph)
+					settings.setPeriphOrMemToMemSrc(descriptor.dstSettings()).setMemoryOrMemToMemDst(descriptor.srcSettings());
+				else
+					settings.setPeriphOrMemToMemSrc(descriptor.srcSettings()).setMemoryOrMemToMemDst(descriptor.dstSettings());
+				ch.CCR = (ch.CCR & ~Dma::ChannelImage::ConfigMask) | settings.toImage().control;
+				ch.CPAR = settings.getPeriphOrMemToMemSrc().getAddr();
+				ch.CMAR = settings.getMemoryOrMemToMemDst().getAddr();
+				ch.CNDTR = descriptor.getCount() & CountMask;
+				_reload[channel] = ch.CNDTR;
+			}
+
+			// Переходит к следующему узлу цепочки. После последнего узла выставляет TCIF и завершает цепочку:
+			// прерывание относится к завершенной цепочке, поэтому выставляется до обработчика завершения,
+			// который может запустить следующую. Возвращает true, если загружен следующий узел
+			bool nextChainNode(Dma::channel_number_t channel) {
+				const Dma::Descriptor* node = _chainNode[channel];
+				if (node == nullptr)
+					return false;
+				if (node->next != nullptr) {
+					_chainNode[channel] = node->next;
+					loadDescriptor(channel, *node->next);
+					return true;
+				}
+				_chainNode[channel] = nullptr;
+				raiseInterrupt(channel, DmaFlag::TCIF);
+				this->completeChain(channel);
+				return false;
+			}
+
+			// Изменяет поля конфигурации в CCR, не затрагивая адреса и биты EN/TCIE/HTIE/TEIE
+			template <typename Function>
+			void modifyImage(Dma::channel_number_t channel, Function&& function) {
+				DmaChannelRegisters& ch = _regs.CH[channel];
+				Dma::Settings settings = onGetSettings(channel);
+				function(settings);
+				ch.CCR = (ch.CCR & ~Dma::ChannelImage::ConfigMask) | settings.toImage().control;
+			}
+
+			// Запускает передачу память-память сразу после включения канала (такие каналы не ждут запросов),
+			// если не задан отложенный режим.
+			// В циклическом режиме передается один блок: для память-память он не имеет смысла и не должен зациклить
+			// симуляцию (по той же причине кольцевые цепочки дескрипторов допустимы только для каналов с периферией)
+			void startMemoryToMemory(Dma::channel_number_t channel) {
+				const uint32_t ccr = _regs.CH[channel].CCR;
+				if ((ccr & (1u << Dma::ChannelImage::Mem2MemPos)) != 0 && !_deferredMemoryToMemory)
+					run(channel, (ccr & (1u << Dma::ChannelImage::CircPos)) != 0 ? _regs.CH[channel].CNDTR : UINT32_MAX);
+			}
+
+			// Пересылает count элементов, начиная с элемента index текущего блока. Возвращает false при ошибке шины
+			bool transferItems(Dma::channel_number_t channel, uint32_t index, uint32_t count) {
+				const DmaChannelRegisters& ch = _regs.CH[channel];
+				const uint32_t ccr = ch.CCR;
+				const bool fromMemory = (ccr & (1u << Dma::ChannelImage::DirPos)) != 0 &&
+					(ccr & (1u << Dma::ChannelImage::Mem2MemPos)) == 0;
+
+				// Стороны передачи: периферия (CPAR, PSIZE, PINC) и память (CMAR, MSIZE, MINC)
+				const uint32_t periphAlign = (ccr >> Dma::ChannelImage::PsizePos) & 3u;
+				const uint32_t memoryAlign = (ccr >> Dma::ChannelImage::MsizePos) & 3u;
+				if (periphAlign > 2 || memoryAlign > 2)
+					return false; // Зарезервированное значение ширины данных
+				const Side periph = { ch.CPAR, 1u << periphAlign, (ccr & (1u << Dma::ChannelImage::PincPos)) != 0 };
+				const Side memory = { ch.CMAR, 1u << memoryAlign, (ccr & (1u << Dma::ChannelImage::MincPos)) != 0 };
+				const Side& src = fromMemory ? memory : periph;
+				const Side& dst = fromMemory ? periph : memory;
+
+				const address_t srcAddr = src.addr + (src.increment ? index * src.size : 0u);
+				const address_t dstAddr = dst.addr + (dst.increment ? index * dst.size : 0u);
+				const uint32_t srcSpan = src.increment ? count * src.size : src.size;
+				const uint32_t dstSpan = dst.increment ? count * dst.size : dst.size;
+				if (!_bus->isMapped(srcAddr, srcSpan) || !_bus->isMapped(dstAddr, dstSpan))
+					return false;
+
+				const uint8_t* srcHost = _bus->translate(srcAddr, srcSpan);
+				uint8_t* dstHost = _bus->translate(dstAddr, dstSpan);
+				if (srcHost != nullptr && dstHost != nullptr) {
+					// Обе стороны в памяти хоста. Перекрывающиеся области (в любую сторону) пересылаются поэлементно
+					// в прямом порядке, как контроллером: блочные ядра требуют неперекрывающихся областей
+					const bool overlap = dstHost < srcHost + srcSpan && srcHost < dstHost + dstSpan;
+					if (src.size == dst.size && src.increment && dst.increment && !overlap)
+						Kernels::copyBlock(dstHost, srcHost, srcSpan);
+					else if (src.size == dst.size && !src.increment && dst.increment && !overlap)
+						Kernels::fillBlock(dstHost, Kernels::loadItem(srcHost, src.size), dst.size, count);
+					else
+						Kernels::convertBlock(dstHost, dst.increment ? dst.size : 0u, dst.size,
+							srcHost, src.increment ? src.size : 0u, src.size, count);
+					return true;
+				}
+
+				// Хотя бы одна сторона - регистры устройства: поэлементный доступ через шину
+				for (uint32_t i = 0; i < count; ++i) {
+					const uint32_t value = _bus->read(srcAddr + (src.increment ? i * src.size : 0u), src.size);
+					_bus->write(dstAddr + (dst.increment ? i * dst.size : 0u),
+						dst.size < 4 ? value & ((1u << (dst.size * 8)) - 1u) : value, dst.size);
+				}
+				return true;
+			}
+
+			Registers_t _ownRegisters;  // Собственный блок регистров
+			Registers_t& _regs;         // Используемый блок регистров
+
+		private:
+			// Сторона передачи: адрес, ширина элемента в байтах и инкремент адреса
+			struct Side {
+				address_t addr;
+				uint32_t size;
+				bool increment;
+			};
+
+			// Обработчики доступа к регистрам со стороны шины
+			static uint32_t busRead(void* context, address_t offset, uint32_t) {
+				SimDma& self = *static_cast<SimDma*>(context);
+				if (offset == IfcrOffset)
+					return 0;
+				return reinterpret_cast<const __IO uint32_t*>(&self._regs)[offset / 4];
+			}
+
+			static void busWrite(void* context, address_t offset, uint32_t value, uint32_t) {
+				SimDma& self = *static_cast<SimDma*>(context);
+				if (offset == 0)
+					return; // ISR только для чтения
+				if (offset == IfcrOffset) {
+					self._regs.ISR = self._regs.ISR & ~value;
+					return;
+				}
+				const uint32_t channel = (offset - ChannelsOffset) / sizeof(DmaChannelRegisters);
+				const uint32_t reg = (offset - ChannelsOffset) % sizeof(DmaChannelRegisters);
+				const bool starting = reg == 0 && (value & DmaCcr::EN) && !(self._regs.CH[channel].CCR & DmaCcr::EN);
+				if (starting)
+					self._reload[channel] = self._regs.CH[channel].CNDTR; // Включение канала записью в CCR
+				if (reg == 4)
+					value &= CountMask;
+				reinterpret_cast<__IO uint32_t*>(&self._regs)[offset / 4] = value;
+				if (starting)
+					self.startMemoryToMemory(channel);
+			}
+
+			static constexpr address_t IfcrOffset = 0x04;     // Смещение IFCR
+			static constexpr address_t ChannelsOffset = 0x08; // Смещение регистров первого канала
+
+			SimBus* _bus = nullptr;                   // Шина для выполнения передач
+			DmaInterruptHandler_t _interruptHandler;  // Обработчик прерываний каналов
+			uint32_t _reload[ChannelsCount] = {};     // Значения CNDTR на момент включения каналов
+			const Dma::Descriptor* _chainNode[ChannelsCount] = {}; // Выполняемые узлы цепочек дескрипторов
+			bool _clockEnabled = false;               // Тактирование контроллера включено
+			bool _deferredMemoryToMemory = false;     // Передачи память-память выполняются вызовами run/step
+			ErrorPolicy _errors;                      // Политика ошибок
+		};
+	}
+}
+
+#endif
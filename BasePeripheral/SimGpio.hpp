@@ -0,0 +1,307 @@
+#ifndef SIM_GPIO_HPP_
+#define SIM_GPIO_HPP_
+
+#include <atomic>
+#include "BaseGpio.hpp"
+#include "SimBus.hpp"
+
+namespace BasePeripheral {
+	namespace Sim {
+		typedef std::atomic<uint32_t> sim_register_t; // Регистр симулятора: атомарные чтение, запись и fetch_or/fetch_and/fetch_xor
+
+		// Раскладка регистров симулированного порта GPIO (в стиле STM32) и блока внешних прерываний порта.
+		// Структура может располагаться как в обычной памяти, так и в отображенном через mmap файле.
+		// Регистры атомарные: запись BSRR, переключение выходов и изменение полей настроек не теряют
+		// изменений при обращении из нескольких потоков (модель атомарного доступа к регистрам порта).
+		struct GpioRegisters {
+			sim_register_t MODER;   // 0x00 Режим (2 бита на пин)
+			sim_register_t OTYPER;  // 0x04 Тип выхода (1 бит на пин)
+			sim_register_t OSPEEDR; // 0x08 Скорость выхода (2 бита на пин)
+			sim_register_t PUPDR;   // 0x0C Подтяжка (2 бита на пин)
+			sim_register_t IDR;     // 0x10 Входные данные
+			sim_register_t ODR;     // 0x14 Выходные данные
+			sim_register_t BSRR;    // 0x18 Установка (биты 0-15) / сброс (биты 16-31) выходов, только запись
+			sim_register_t LCKR;    // 0x1C Блокировка конфигурации (не моделируется)
+			sim_register_t AFR[2];  // 0x20 Альтернативные функции (не моделируются)
+			sim_register_t IMR;     // 0x28 Маска разрешенных прерываний
+			sim_register_t RTSR;    // 0x2C Прерывание по переднему фронту
+			sim_register_t FTSR;    // 0x30 Прерывание по заднему фронту
+			sim_register_t PR;      // 0x34 Флаги ожидающих прерываний
+		};
+
+		static_assert(sizeof(GpioRegisters) == 0x38, "Simulated GPIO registers must keep the hardware layout");
+		static_assert(std::atomic<uint32_t>::is_always_lock_free, "Simulated registers must be lock-free");
+
+		// Смещения регистров GPIO на шине
+		namespace GpioOffset {
+			constexpr address_t IDR = 0x10;
+			constexpr address_t ODR = 0x14;
+			constexpr address_t BSRR = 0x18;
+			constexpr address_t PR = 0x34;
+		}
+
+		// Фронт сигнала, по которому генерируется прерывание
+		enum class Edge : uint32_t {
+			None,    // Прерывание выключено
+			Rising,  // Передний фронт
+			Falling, // Задний фронт
+			Both     // Оба фронта
+		};
+
+		// Симулированный порт GPIO (до 16 пинов) с моделью регистров MODER/OTYPER/OSPEEDR/PUPDR/IDR/ODR/BSRR.
+		// Уровень на входе пина складывается из выходного значения (для пинов в режиме выхода или
+		// альтернативной функции) и внешнего уровня, задаваемого setInputLevel; изменение уровня на пине
+		// с разрешенным прерыванием вызывает обработчики прерываний порта.
+		// ErrorPolicy - политика обработки ошибок (NullErrorPolicy, CountingErrorPolicy, RecordingErrorPolicy<N>).
+		template <uint32_t IOCount = 16, bool ShadowCache = false, typename ErrorPolicy = CountingErrorPolicy>
+		class SimGpio : public Gpio::BaseGpio<IOCount, ShadowCache> {
+			static_assert(IOCount <= 16, "Simulated GPIO port supports up to 16 pins");
+
+			typedef Gpio::BaseGpio<IOCount, ShadowCache> Base;
+
+		public:
+			typedef typename Base::Mask Mask;
+			using Gpio::BaseGpio<IOCount, ShadowCache>::dispatchInterrupts;
+
+			// Конструктор. registers - внешний блок регистров (например, в отображенном файле),
+			// при nullptr используется собственный блок
+			explicit SimGpio(GpioRegisters* registers = nullptr)
+				: _ownRegisters(), _regs(registers != nullptr ? *registers : _ownRegisters) {}
+
+			SimGpio(const SimGpio&) = delete;
+			SimGpio& operator=(const SimGpio&) = delete;
+
+			// Блок регистров порта
+			GpioRegisters& registers() { return _regs; }
+			const GpioRegisters& registers() const { return _regs; }
+
+			// Отображает регистры порта на шину по адресу base
+			bool attach(SimBus& bus, address_t base) {
+				_baseAddress = base;
+				return bus.mapDevice(base, sizeof(GpioRegisters),
+					BusReadHandler_t(&SimGpio::busRead, this), BusWriteHandler_t(&SimGpio::busWrite, this));
+			}
+
+			// Задает внешний уровень на пине (действует для пинов, не работающих как выход)
+			void setInputLevel(Gpio::pin_number_t pin, bool level) {
+				if (pin >= IOCount)
+					return;
+				if (level)
+					_external.fetch_or(1u << pin);
+				else
+					_external.fetch_and(~(1u << pin));
+				updateInputs();
+			}
+
+			// Задает внешние уровни сразу для всех пинов порта
+			void setInputPort(uint32_t levels) {
+				_external.store(levels & PortMask);
+				updateInputs();
+			}
+
+			// Настраивает генерацию прерывания по фронту сигнала на пине
+			void configureInterrupt(Gpio::pin_number_t pin, Edge edge) {
+				if (pin >= IOCount)
+					return;
+				writeBit(_regs.RTSR, pin, edge == Edge::Rising || edge == Edge::Both);
+				writeBit(_regs.FTSR, pin, edge == Edge::Falling || edge == Edge::Both);
+				writeBit(_regs.IMR, pin, edge != Edge::None);
+			}
+
+			// Внедряет прерывание для пинов маски (как если бы сработал аппаратный детектор фронтов)
+			void injectInterrupt(uint32_t pending) {
+				_regs.PR.fetch_or(pending & PortMask);
+				handleInterrupt();
+			}
+
+			// Обработчик прерывания порта: сбрасывает флаги ожидания и вызывает обработчики пинов
+			void handleInterrupt() {
+				const uint32_t pending = _regs.PR.exchange(0);
+				if (pending == 0)
+					return;
+				dispatchInterrupts(Mask(pending));
+			}
+
+			// Политика ошибок и статистика ошибок
+			ErrorPolicy& errors() { return _errors; }
+			uint32_t errorCount() const { return _errors.count(); }
+			error_t lastError() const { return _errors.last().error; }
+
+			virtual bool isEnabled() const override { return _clockEnabled; }
+
+		protected:
+			static constexpr uint32_t PortMask = static_cast<uint32_t>((1ull << IOCount) - 1); // Маска пинов порта
+
+			virtual void onEnableClock() override { _clockEnabled = true; }
+			virtual void onDisableClock() override { _clockEnabled = false; }
+
+			virtual void onError(error_t error) override {
+				_errors.report(ErrorEvent(ErrorSource::Gpio, error));
+			}
+
+			virtual void onErrorEvent(const ErrorEvent& event) override {
+				_errors.report(event);
+			}
+
+			virtual bool onSetSettings(Gpio::pin_number_t pin, const Gpio::Settings& settings) override {
+				writeField(_regs.MODER, pin, static_cast<uint32_t>(settings.getMode()));
+				writeField(_regs.PUPDR, pin, static_cast<uint32_t>(settings.getPull()));
+				writeField(_regs.OSPEEDR, pin, static_cast<uint32_t>(settings.getOutputSpeed()));
+				writeBit(_regs.OTYPER, pin, settings.getOutputType() == Gpio::OutputType::OpenDrain);
+				updateInputs();
+				return true;
+			}
+
+			virtual bool onUpdateSettings(Gpio::pin_number_t pin, const Gpio::Settings& settings) override {
+				return onSetSettings(pin, settings);
+			}
+
+			virtual Gpio::Settings onGetSettings(Gpio::pin_number_t pin) const override {
+				return Gpio::Settings(onGetMode(pin), onGetPull(pin), onGetOutputType(pin), onGetOutputSpeed(pin));
+			}
+
+			virtual bool onApplyImage(const Gpio::PortImage<IOCount>& image) override {
+				typedef Gpio::PortImage<IOCount> Image;
+				if ((image.registers & Image::ModeRegister) != 0)
+					modify(_regs.MODER, image.fieldMask[0], image.mode[0]);
+				if ((image.registers & Image::PullRegister) != 0)
+					modify(_regs.PUPDR, image.fieldMask[0], image.pull[0]);
+				if ((image.registers & Image::OutputSpeedRegister) != 0)
+					modify(_regs.OSPEEDR, image.fieldMask[0], image.outputSpeed[0]);
+				if ((image.registers & Image::OutputTypeRegister) != 0)
+					modify(_regs.OTYPER, image.pins.word(0), image.outputType.word(0));
+				if ((image.registers & Image::ModeRegister) != 0)
+					updateInputs();
+				return true;
+			}
+
+			virtual void onSetPin(Gpio::pin_number_t pin) override { writeBsrr(1u << pin); }
+			virtual void onResetPin(Gpio::pin_number_t pin) override { writeBsrr(1u << (pin + 16)); }
+
+			virtual void onSetPull(Gpio::pin_number_t pin, Gpio::Pull pull) override {
+				writeField(_regs.PUPDR, pin, static_cast<uint32_t>(pull));
+			}
+			virtual void onSetMode(Gpio::pin_number_t pin, Gpio::Mode mode) override {
+				writeField(_regs.MODER, pin, static_cast<uint32_t>(mode));
+				updateInputs();
+			}
+			virtual void onSetOutputType(Gpio::pin_number_t pin, Gpio::OutputType outputType) override {
+				writeBit(_regs.OTYPER, pin, outputType == Gpio::OutputType::OpenDrain);
+			}
+			virtual void onSetOutputSpeed(Gpio::pin_number_t pin, Gpio::OutputSpeed speed) override {
+				writeField(_regs.OSPEEDR, pin, static_cast<uint32_t>(speed));
+			}
+
+			virtual void onWritePins(const Mask& mask, const Mask& values) override {
+				writeBsrr((mask.word(0) & values.word(0)) | ((mask.word(0) & ~values.word(0)) << 16));
+			}
+			// Переключение - атомарный XOR выходного регистра
+			virtual void onTogglePins(const Mask& mask) override {
+				_regs.ODR.fetch_xor(mask.word(0) & PortMask);
+				updateInputs();
+			}
+			virtual void onTogglePin(Gpio::pin_number_t pin) override {
+				_regs.ODR.fetch_xor(1u << pin);
+				updateInputs();
+			}
+			virtual Mask onReadPortInput() override { return Mask(_regs.IDR); }
+			virtual Mask onReadPortOutput() override { return Mask(_regs.ODR); }
+
+			virtual bool onGetPinOutput(Gpio::pin_number_t pin) override { return ((_regs.ODR >> pin) & 1u) != 0; }
+			virtual bool onGetPinInput(Gpio::pin_number_t pin) override { return ((_regs.IDR >> pin) & 1u) != 0; }
+
+			virtual Gpio::Mode onGetMode(Gpio::pin_number_t pin) const override { return static_cast<Gpio::Mode>(readField(_regs.MODER, pin)); }
+			virtual Gpio::Pull onGetPull(Gpio::pin_number_t pin) const override { return static_cast<Gpio::Pull>(readField(_regs.PUPDR, pin)); }
+			virtual Gpio::OutputType onGetOutputType(Gpio::pin_number_t pin) const override {
+				return ((_regs.OTYPER >> pin) & 1u) != 0 ? Gpio::OutputType::OpenDrain : Gpio::OutputType::PushPull;
+			}
+			virtual Gpio::OutputSpeed onGetOutputSpeed(Gpio::pin_number_t pin) const override {
+				return static_cast<Gpio::OutputSpeed>(readField(_regs.OSPEEDR, pin));
+			}
+
+			virtual bool validatePortAddr(uint32_t portAddr) const override { return portAddr == _baseAddress; }
+
+			// Запись в регистр BSRR: установка/сброс выходов за одну операцию (сброс имеет меньший приоритет)
+			void writeBsrr(uint32_t value) {
+				modify(_regs.ODR, (value >> 16) & PortMask, value & PortMask);
+				updateInputs();
+			}
+
+			// Пересчитывает IDR и генерирует прерывания по фронтам. IDR обновляется сравнением с обменом:
+			// при параллельных вызовах значение пересчитывается, пока не будет записано поверх последнего
+			void updateInputs() {
+				uint32_t previous = _regs.IDR.load();
+				uint32_t current;
+				do {
+					uint32_t drivenByOutput = 0;
+					const uint32_t moder = _regs.MODER.load();
+					for (uint32_t pin = 0; pin < IOCount; ++pin) {
+						const uint32_t mode = (moder >> (pin * 2)) & 3u;
+						if (mode == static_cast<uint32_t>(Gpio::Mode::Output) || mode == static_cast<uint32_t>(Gpio::Mode::AlternateFunction))
+							drivenByOutput |= 1u << pin;
+					}
+					current = ((_regs.ODR.load() & drivenByOutput) | (_external.load() & ~drivenByOutput)) & PortMask;
+				} while (!_regs.IDR.compare_exchange_weak(previous, current));
+
+				const uint32_t pending = (((current & ~previous) & _regs.RTSR) | ((previous & ~current) & _regs.FTSR)) & _regs.IMR;
+				if (pending != 0)
+					injectInterrupt(pending);
+			}
+
+		private:
+			static uint32_t readField(uint32_t reg, Gpio::pin_number_t pin) { return (reg >> (pin * 2)) & 3u; }
+
+			// Атомарно заменяет биты clear регистра значением bits (сравнение с обменом)
+			static void modify(sim_register_t& reg, uint32_t clear, uint32_t bits) {
+				uint32_t value = reg.load(std::memory_order_relaxed);
+				while (!reg.compare_exchange_weak(value, (value & ~clear) | bits)) {}
+			}
+
+			static void writeField(sim_register_t& reg, Gpio::pin_number_t pin, uint32_t value) {
+				modify(reg, 3u << (pin * 2), (value & 3u) << (pin * 2));
+			}
+
+			static void writeBit(sim_register_t& reg, Gpio::pin_number_t pin, bool value) {
+				if (value)
+					reg.fetch_or(1u << pin);
+				else
+					reg.fetch_and(~(1u << pin));
+			}
+
+			// Обработчики доступа к регистрам со стороны шины (например, от DMA)
+			static uint32_t busRead(void* context, address_t offset, uint32_t) {
+				SimGpio& self = *static_cast<SimGpio*>(context);
+				if (offset == GpioOffset::BSRR)
+					return 0;
+				return reinterpret_cast<const sim_register_t*>(&self._regs)[offset / 4].load();
+			}
+
+			static void busWrite(void* context, address_t offset, uint32_t value, uint32_t) {
+				SimGpio& self = *static_cast<SimGpio*>(context);
+				switch (offset) {
+				case GpioOffset::BSRR:
+					self.writeBsrr(value);
+					break;
+				case GpioOffset::IDR:
+					break; // Регистр только для чтения
+				case GpioOffset::PR:
+					self._regs.PR.fetch_and(~value); // Сброс флагов записью единицы
+					break;
+				default:
+					reinterpret_cast<sim_register_t*>(&self._regs)[offset / 4].store(value);
+					self.updateInputs();
+					break;
+				}
+			}
+
+			GpioRegisters _ownRegisters;   // Собственный блок регистров
+			GpioRegisters& _regs;          // Используемый блок регистров
+			std::atomic<uint32_t> _external{ 0 }; // Внешние уровни на пинах
+			address_t _baseAddress = 0;    // Адрес порта на шине
+			bool _clockEnabled = false;    // Тактирование порта включено
+			ErrorPolicy _errors;           // Политика ошибок
+		};
+	}
+}
+
+#endif
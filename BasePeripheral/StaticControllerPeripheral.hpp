@@ -0,0 +1,24 @@
+#ifndef STATIC_CONTROLLER_PERIPHERAL_HPP
+#define STATIC_CONTROLLER_PERIPHERAL_HPP
+
+#include "ControllerPeripheral.hpp"
+
+namespace BasePeripheral {
+	// Базовый класс блока периферии со статической диспетчеризацией (CRTP).
+	// Аналог ControllerPeripheral без таблицы виртуальных функций: конечный наследник Derived
+	// должен реализовать методы onEnableClock(), onDisableClock(), onError(error_t) и isEnabled() const.
+	// Если методы-обработчики объявлены в наследнике как private/protected, наследник должен
+	// объявить другом (friend) непосредственный базовый класс (StaticGpio, StaticDma и т.д.).
+	template <typename Derived>
+	class StaticControllerPeripheral {
+	protected:
+		// Невиртуальный защищенный деструктор: удаление через указатель на базовый класс не предусмотрено
+		~StaticControllerPeripheral() = default;
+
+		// Доступ к конечному наследнику
+		Derived& derived() { return static_cast<Derived&>(*this); }
+		const Derived& derived() const { return static_cast<const Derived&>(*this); }
+	};
+}
+
+#endif // !STATIC_CONTROLLER_PERIPHERAL_HPP
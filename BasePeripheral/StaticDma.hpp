@@ -0,0 +1,347 @@
+#ifndef STATIC_DMA_HPP_
+#define STATIC_DMA_HPP_
+
+#include "BaseDma.hpp"
+#include "StaticControllerPeripheral.hpp"
+
+namespace BasePeripheral {
+	namespace Dma {
+		// Вариант BaseDma со статической диспетчеризацией (CRTP).
+		// Публичный интерфейс совпадает с BaseDma, обработчики on*() вызываются у наследника Derived
+		// напрямую и могут быть встроены компилятором.
+		//
+		// Наследник должен реализовать (не виртуально) те же обработчики, что и у BaseDma:
+		// onEnableClock, onDisableClock, onError, isEnabled, onSetSettings, onSetDirection, onSetMode,
+		// onSetPriority, onSetMemorySettings, onEnableChannel, onDisableChannel, onGetSettings,
+		// onSetDataCount, onGetDataCount, onSetEvents, onGetEvents, onClearEvents. Обработчики onSubmitChain, onStartDescriptor и onApplyChannelFields имеют реализации по умолчанию
+		// и могут быть переопределены наследником.
+		template <typename Derived, uint32_t ChannelsCount> // Максимальное количество каналов в блоке DMA
+		class StaticDma : public StaticControllerPeripheral<Derived> {
+			using StaticControllerPeripheral<Derived>::derived;
+
+		public:
+			static constexpr channel_number_t ChannelMaxNumber = ChannelsCount - 1;
+
+			// Метод инициализации контроллера DMA
+			void init() {
+				derived().onEnableClock(); // Включение тактирования контроллера DMA
+			}
+
+			// Метод деинициализации контроллера DMA
+			void deInit() {
+				derived().onDisableClock(); // Отключение тактирования контроллера DMA
+			}
+
+			// Метод для инициализации канала с проверкой валидности входных данных
+			bool initChannel(channel_number_t channel, const Settings& settings = Settings()) {
+				BP_TRACE_SCOPE(DmaInitChannel, channel);
+				if (!derived().isEnabled()) {
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: контроллер DMA отключен
+					return false;
+				}
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return false;
+				}
+				return derived().onSetSettings(channel, settings); // Применение настроек к каналу
+			}
+
+			// Метод для инициализации канала, описанного дескриптором Channel<...> (номер канала и образ
+			// управляющего регистра вычислены на этапе компиляции)
+			template <typename ChannelDescriptor>
+			bool initChannel(address_t periphOrSrcAddr, address_t memoryOrDstAddr) {
+				BP_TRACE_SCOPE(DmaInitChannel, ChannelDescriptor::Number);
+				static_assert(ChannelDescriptor::Number <= ChannelMaxNumber, "Channel number is out of range");
+				if (!derived().isEnabled()) {
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: контроллер DMA отключен
+					return false;
+				}
+				return derived().onApplyChannelImage(ChannelDescriptor::Number, ChannelDescriptor::image, periphOrSrcAddr, memoryOrDstAddr);
+			}
+
+			// Метод для применения образа канала: записываются только регистры, отмеченные в fields (ChannelField)
+			bool applyChannelImage(channel_number_t channel, const ChannelImage& image, address_t periphOrSrcAddr,
+				address_t memoryOrDstAddr, uint32_t fields = ChannelField::All) {
+				if (!derived().isEnabled()) {
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: контроллер DMA отключен
+					return false;
+				}
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return false;
+				}
+				if ((fields & ChannelField::All) == 0)
+					return true;
+				return derived().onApplyChannelFields(channel, image, periphOrSrcAddr, memoryOrDstAddr, fields & ChannelField::All);
+			}
+
+			// Метод для получения текущих настроек канала
+			Settings getSettings(channel_number_t channel) const {
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return Settings();
+				}
+				return derived().onGetSettings(channel);
+			}
+
+			// Методы получения отдельных полей настроек канала
+			Direction getDirection(channel_number_t channel) const { return getSettings(channel).getDirection(); }
+			Mode getMode(channel_number_t channel) const { return getSettings(channel).getMode(); }
+			Priority getPriority(channel_number_t channel) const { return getSettings(channel).getPriority(); }
+
+			// Метод для установки направления передачи данных с проверкой валидности входных данных
+			void setDirection(channel_number_t channel, Direction direction) {
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return;
+				}
+				derived().onSetDirection(channel, direction); // Установка направления передачи данных
+			}
+
+			// Метод для установки режима передачи данных с проверкой валидности входных данных
+			void setMode(channel_number_t channel, Mode mode) {
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return;
+				}
+				derived().onSetMode(channel, mode); // Установка режима передачи данных
+			}
+
+			// Метод для установки приоритета работы канала с проверкой валидности входных данных
+			void setPriority(channel_number_t channel, Priority priority) {
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return;
+				}
+				derived().onSetPriority(channel, priority); // Установка приоритета работы канала
+			}
+
+			// Метод для установки настроек памяти с проверкой валидности входных данных
+			void setMemorySettings(channel_number_t channel, const MemorySettings& src, const MemorySettings& dst) {
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return;
+				}
+				derived().onSetMemorySettings(channel, src, dst); // Установка настроек памяти
+			}
+
+			// Метод для установки количества элементов данных для передачи по каналу
+			void setDataCount(channel_number_t channel, uint32_t count) {
+				BP_TRACE_SCOPE(DmaSetDataCount, channel);
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return;
+				}
+				derived().onSetDataCount(channel, count); // Установка количества элементов данных
+			}
+
+			// Метод для получения количества оставшихся для передачи элементов данных
+			uint32_t getDataCount(channel_number_t channel) const {
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return 0;
+				}
+				return derived().onGetDataCount(channel);
+			}
+
+			// Метод для включения передачи данных по каналу
+			bool enableChannel(channel_number_t channel) {
+				BP_TRACE_SCOPE(DmaEnableChannel, channel);
+				if (!derived().isEnabled()) {
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: контроллер DMA отключен
+					return false;
+				}
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return false;
+				}
+				derived().onEnableChannel(channel); // Включение передачи данных
+				return true;
+			}
+
+			// Метод для выключения передачи данных по каналу
+			void disableChannel(channel_number_t channel) {
+				BP_TRACE_SCOPE(DmaDisableChannel, channel);
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return;
+				}
+				derived().onDisableChannel(channel); // Выключение передачи данных
+			}
+
+			// Метод для запуска цепочки дескрипторов на канале (см. BaseDma::submitChain)
+			bool submitChain(channel_number_t channel, const Descriptor* head, ChainCallback_t onComplete = ChainCallback_t()) {
+				BP_TRACE_SCOPE(DmaSubmitChain, channel);
+				if (!derived().isEnabled()) {
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: контроллер DMA отключен
+					return false;
+				}
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return false;
+				}
+				if (head == nullptr)
+					return false;
+				if (isChainActive(channel)) {
+					raiseError(Error::ChannelBusy, channel); // Обработка ошибки: цепочка канала еще не завершена
+					return false;
+				}
+				constexpr uint32_t chainEvents = Event::TransferComplete | Event::TransferError;
+				if ((eventMasks[channel] & chainEvents) != chainEvents)
+					setEvents(channel, eventMasks[channel] | chainEvents);
+				chains[channel] = ChainState();
+				chains[channel].current = head;
+				chains[channel].onComplete = onComplete;
+				if (!derived().onSubmitChain(channel, head)) {
+					chains[channel] = ChainState();
+					return false;
+				}
+				return true;
+			}
+
+			// Метод перехода к следующему узлу цепочки (см. BaseDma::advanceChain)
+			bool advanceChain(channel_number_t channel) {
+				if (channel > ChannelMaxNumber || chains[channel].current == nullptr || chains[channel].hardware)
+					return false;
+				const Descriptor* next = chains[channel].current->next;
+				if (next == nullptr) {
+					completeChain(channel);
+					return false;
+				}
+				chains[channel].current = next;
+				return derived().onStartDescriptor(channel, *next);
+			}
+
+			// Метод остановки канала с цепочкой дескрипторов без ее завершения (например, при вытеснении передачи):
+			// выключает канал, сбрасывает необработанные флаги событий и состояние цепочки. Обработчик завершения
+			// цепочки не вызывается
+			void cancelChain(channel_number_t channel) {
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return;
+				}
+				derived().onDisableChannel(channel);
+				derived().onClearEvents(channel, Event::All);
+				chains[channel] = ChainState();
+			}
+
+			// Возвращает true, если на канале выполняется цепочка дескрипторов
+			bool isChainActive(channel_number_t channel) const {
+				return channel <= ChannelMaxNumber && chains[channel].current != nullptr;
+			}
+
+			// Метод для разрешения прерываний по событиям канала (маска из флагов Event, остальные события запрещаются)
+			void setEvents(channel_number_t channel, uint32_t events) {
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return;
+				}
+				eventMasks[channel] = events & Event::All;
+				derived().onSetEvents(channel, eventMasks[channel]); // Разрешение прерываний
+			}
+
+			// Метод для установки обработчика событий канала (вызывается из handleInterrupt)
+			void setEventHandler(channel_number_t channel, ChannelEventHandler_t handler) {
+				if (channel > ChannelMaxNumber) {
+					raiseError(Error::ChannelNumberError, channel); // Обработка ошибки: некорректный номер канала
+					return;
+				}
+				eventHandlers[channel] = handler;
+			}
+
+			// Обработчик прерывания канала (см. BaseDma::handleInterrupt)
+			void handleInterrupt(channel_number_t channel) {
+				BP_TRACE_SCOPE(DmaInterrupt, channel);
+				if (channel > ChannelMaxNumber)
+					return;
+				const uint32_t events = derived().onGetEvents(channel);
+				if (events == 0)
+					return;
+				derived().onClearEvents(channel, events);
+				if ((events & Event::TransferError) != 0)
+					failChain(channel);
+				else if ((events & Event::TransferComplete) != 0)
+					advanceChain(channel);
+				if (eventHandlers[channel])
+					eventHandlers[channel](channel, events);
+			}
+
+		protected:
+			~StaticDma() = default;
+
+			// Реализация применения образа управляющего регистра по умолчанию (через onSetSettings)
+			bool onApplyChannelImage(channel_number_t channel, const ChannelImage& image, address_t periphOrSrcAddr, address_t memoryOrDstAddr) {
+				return derived().onSetSettings(channel, image.settings(periphOrSrcAddr, memoryOrDstAddr));
+			}
+
+			// Реализация частичного применения образа по умолчанию (образ целиком)
+			bool onApplyChannelFields(channel_number_t channel, const ChannelImage& image, address_t periphOrSrcAddr,
+				address_t memoryOrDstAddr, uint32_t) {
+				return derived().onApplyChannelImage(channel, image, periphOrSrcAddr, memoryOrDstAddr);
+			}
+
+			// Реализация запуска цепочки по умолчанию: запуск первого узла, следующие узлы - из advanceChain
+			bool onSubmitChain(channel_number_t channel, const Descriptor* head) {
+				return derived().onStartDescriptor(channel, *head);
+			}
+
+			// Реализация запуска узла цепочки по умолчанию: перепрограммирование сторон и количества, включение канала
+			bool onStartDescriptor(channel_number_t channel, const Descriptor& descriptor) {
+				derived().onDisableChannel(channel);
+				if (getSettings(channel).getDirection() == Direction::MemoryToPeriph)
+					derived().onSetMemorySettings(channel, descriptor.dstSettings(), descriptor.srcSettings());
+				else
+					derived().onSetMemorySettings(channel, descriptor.srcSettings(), descriptor.dstSettings());
+				derived().onSetDataCount(channel, descriptor.getCount());
+				derived().onEnableChannel(channel);
+				return true;
+			}
+
+			// Отмечает цепочку канала как обходимую контроллером (вызывается из onSubmitChain)
+			void markHardwareChain(channel_number_t channel) {
+				chains[channel].hardware = true;
+			}
+
+			// Завершает цепочку канала и вызывает ее обработчик завершения
+			void completeChain(channel_number_t channel, ChainStatus status = ChainStatus::Complete) {
+				const ChainCallback_t onComplete = chains[channel].onComplete;
+				chains[channel] = ChainState();
+				if (onComplete)
+					onComplete(channel, status);
+			}
+
+			// Прерывает цепочку канала после ошибки передачи: выключает канал и завершает цепочку с ошибкой
+			void failChain(channel_number_t channel) {
+				if (chains[channel].current == nullptr)
+					return;
+				derived().onDisableChannel(channel);
+				completeChain(channel, ChainStatus::Error);
+			}
+
+			ChainState chains[ChannelsCount]; // Состояние цепочек дескрипторов каналов
+			ChannelEventHandler_t eventHandlers[ChannelsCount]; // Обработчики событий каналов
+			uint32_t eventMasks[ChannelsCount] = {};            // Разрешенные события каналов (setEvents)
+
+			// Обработчик события ошибки по умолчанию: передает код ошибки в onError наследника
+			// (наследник может объявить свой onErrorEvent(const ErrorEvent&), чтобы передать событие в политику ошибок)
+			void onErrorEvent(const ErrorEvent& event) {
+				derived().onError(event.error);
+			}
+
+			// Передает ошибку DMA с номером канала в onErrorEvent наследника
+			void raiseError(Error error, uint32_t index = ErrorEvent::NoIndex) {
+				derived().onErrorEvent(ErrorEvent(errorSource(error), static_cast<error_t>(error), index));
+			}
+
+			// То же для константных геттеров (см. ControllerPeripheral::raiseError)
+			void raiseError(Error error, uint32_t index = ErrorEvent::NoIndex) const {
+				const_cast<StaticDma*>(this)->raiseError(error, index);
+			}
+
+			// Счетчики операций (только при BP_TRACE)
+			BP_TRACE_COUNTERS
+		};
+	}
+}
+
+#endif
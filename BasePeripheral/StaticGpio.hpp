@@ -0,0 +1,432 @@
+#ifndef STATIC_GPIO_HPP_
+#define STATIC_GPIO_HPP_
+
+#include "BaseGpio.hpp"
+#include "StaticControllerPeripheral.hpp"
+
+namespace BasePeripheral {
+	namespace Gpio {
+		// Вариант BaseGpio со статической диспетчеризацией (CRTP).
+		// Публичный интерфейс совпадает с BaseGpio, но обработчики on*() вызываются у наследника Derived
+		// напрямую, без таблицы виртуальных функций, поэтому компилятор может встроить их в место вызова
+		// (например, setPin сводится к одной записи в регистр BSRR).
+		//
+		// Наследник должен реализовать (не виртуально) те же обработчики, что и у BaseGpio:
+		// onEnableClock, onDisableClock, onError, isEnabled, onSetSettings, onGetSettings, onUpdateSettings,
+		// onSetPin, onResetPin, onGetPinOutput, onGetPinInput, onSetPull, onSetMode, onSetOutputType, onSetOutputSpeed,
+		// onGetMode, onGetPull, onGetOutputType, onGetOutputSpeed.
+		// Теневая таблица настроек (ShadowCache) в статическом варианте не предусмотрена: при необходимости
+		// наследник хранит настройки сам.
+		// Необязательные обработчики (onWritePins, onTogglePins, onTogglePin, onApplyImage, onReadPortInput/Output)
+		// имеют реализации по умолчанию; правила параллельного доступа те же, что у BaseGpio.
+		template <typename Derived, uint32_t IOCount> // Максимальный номер пина
+		class StaticGpio : public StaticControllerPeripheral<Derived> {
+			using StaticControllerPeripheral<Derived>::derived;
+
+		public:
+			static constexpr pin_number_t PinMaxNumber = IOCount - 1;
+
+			typedef PinMask<IOCount> Mask; // Маска пинов порта
+
+			// Метод инициализации контроллера GPIO
+			void init() {
+				derived().onEnableClock(); // Включение тактирования контроллера GPIO
+			}
+
+			// Метод деинициализации контроллера GPIO
+			void deInit() {
+				derived().onDisableClock(); // Отключение тактирования контроллера GPIO
+			}
+
+			// Инициализирует пин с указанными настройками
+			bool initPin(pin_number_t pin, const Settings& settings = Settings()) {
+				BP_TRACE_SCOPE(GpioInitPin, pin);
+				if (!derived().isEnabled()) {
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: контроллер GPIO отключен
+					return false;
+				}
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return false;
+				}
+
+				return derived().onSetSettings(pin, settings);
+			}
+
+			// Инициализирует пин, описанный дескриптором Pin<...> (номер пина проверен на этапе компиляции)
+			template <typename PinDescriptor>
+			bool initPin() {
+				BP_TRACE_SCOPE(GpioInitPin, PinDescriptor::Number);
+				static_assert(PinDescriptor::Number <= PinMaxNumber, "Pin number is out of range");
+				if (!derived().isEnabled()) {
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: контроллер GPIO отключен
+					return false;
+				}
+				return derived().onSetSettings(PinDescriptor::Number, PinDescriptor::settings());
+			}
+
+			// Инициализирует группу пинов, описанную конфигурацией PortConfig<...>
+			template <typename Config>
+			bool initPins() {
+				static_assert(Config::IOCount == IOCount, "Port configuration does not match the port");
+				return applyImage(Config::image);
+			}
+
+			// Инициализирует группу пинов по заранее вычисленному образу регистров (см. PortConfig)
+			bool applyImage(const PortImage<IOCount>& image) {
+				if (!derived().isEnabled()) {
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: контроллер GPIO отключен
+					return false;
+				}
+				return derived().onApplyImage(image);
+			}
+
+			// Обновляет настройки указанного пина
+			bool updateSettings(pin_number_t pin, const Settings& settings = Settings()) {
+				if (!derived().isEnabled()) {
+					raiseError(Error::PeripheralDisabled); // Обработка ошибки: контроллер GPIO отключен
+					return false;
+				}
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return false;
+				}
+
+				return derived().onUpdateSettings(pin, settings);
+			}
+
+			// Возвращает текущие настройки указанного пина
+			Settings getSettings(pin_number_t pin) const {
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return Settings();
+				}
+
+				return derived().onGetSettings(pin);
+			}
+
+			// Возвращает режим работы указанного пина
+			Mode getMode(pin_number_t pin) const {
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return Mode();
+				}
+				return derived().onGetMode(pin);
+			}
+
+			// Возвращает подтяжку указанного пина
+			Pull getPull(pin_number_t pin) const {
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return Pull();
+				}
+				return derived().onGetPull(pin);
+			}
+
+			// Возвращает тип выходного сигнала указанного пина
+			OutputType getOutputType(pin_number_t pin) const {
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return OutputType();
+				}
+				return derived().onGetOutputType(pin);
+			}
+
+			// Возвращает скорость выходного сигнала указанного пина
+			OutputSpeed getOutputSpeed(pin_number_t pin) const {
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return OutputSpeed();
+				}
+				return derived().onGetOutputSpeed(pin);
+			}
+
+			// Устанавливает логическую единицу на указанном пине
+			void setPin(pin_number_t pin) {
+				BP_TRACE_SCOPE(GpioSetPin, pin);
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return;
+				}
+				derived().onSetPin(pin);
+			}
+
+			// Устанавливает логический ноль на указанном пине
+			void resetPin(pin_number_t pin) {
+				BP_TRACE_SCOPE(GpioResetPin, pin);
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return;
+				}
+				derived().onResetPin(pin);
+			}
+
+			// Переключает состояние указанного пина на противоположное
+			void togglePin(pin_number_t pin) {
+				BP_TRACE_SCOPE(GpioTogglePin, pin);
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return;
+				}
+				derived().onTogglePin(pin);
+			}
+
+			// Быстрый путь для пина, номер которого известен на этапе компиляции: номер проверяется static_assert,
+			// поэтому проверки во время выполнения и обработка ошибок не выполняются (setPin<3>() - одна запись в порт)
+			template <pin_number_t Pin>
+			void setPin() {
+				BP_TRACE_SCOPE(GpioSetPin, Pin);
+				static_assert(Pin <= PinMaxNumber, "Pin number is out of range");
+				derived().onSetPin(Pin);
+			}
+
+			template <pin_number_t Pin>
+			void resetPin() {
+				BP_TRACE_SCOPE(GpioResetPin, Pin);
+				static_assert(Pin <= PinMaxNumber, "Pin number is out of range");
+				derived().onResetPin(Pin);
+			}
+
+			template <pin_number_t Pin>
+			void togglePin() {
+				BP_TRACE_SCOPE(GpioTogglePin, Pin);
+				static_assert(Pin <= PinMaxNumber, "Pin number is out of range");
+				derived().onTogglePin(Pin);
+			}
+
+			template <pin_number_t Pin>
+			bool readPinInput() {
+				BP_TRACE_SCOPE(GpioReadPin, Pin);
+				static_assert(Pin <= PinMaxNumber, "Pin number is out of range");
+				return derived().onGetPinInput(Pin);
+			}
+
+			// Читает текущее входное состояние указанного пина
+			bool readPinInput(pin_number_t pin) {
+				BP_TRACE_SCOPE(GpioReadPin, pin);
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return false;
+				}
+				return derived().onGetPinInput(pin);
+			}
+
+			// Читает текущее выходное состояние указанного пина
+			bool readPinOutput(pin_number_t pin) {
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return false;
+				}
+				return derived().onGetPinOutput(pin);
+			}
+
+			// Устанавливает тип подтяжки для пина
+			void setPull(pin_number_t pin, Pull pull) {
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return;
+				}
+				derived().onSetPull(pin, pull);
+			}
+
+			// Устанавливает режим работы пина
+			void setMode(pin_number_t pin, Mode mode) {
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return;
+				}
+				derived().onSetMode(pin, mode);
+			}
+
+			// Устанавливает тип выходного сигнала пина
+			void setOutputType(pin_number_t pin, OutputType outputType) {
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return;
+				}
+				derived().onSetOutputType(pin, outputType);
+			}
+
+			// Устанавливает выходную скорость работы пина
+			void setOutputSpeed(pin_number_t pin, OutputSpeed speed) {
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return;
+				}
+				derived().onSetOutputSpeed(pin, speed);
+			}
+
+			// Групповые операции над пинами порта (см. BaseGpio)
+			//
+			// Записывает значения values в пины, отмеченные в mask (остальные пины не изменяются)
+			void writePins(const Mask& mask, const Mask& values) {
+				BP_TRACE_SCOPE(GpioWritePins, mask.word(0));
+				derived().onWritePins(mask, values & mask);
+			}
+
+			// Устанавливает логическую единицу на всех пинах маски
+			void setPins(const Mask& mask) {
+				BP_TRACE_SCOPE(GpioWritePins, mask.word(0));
+				derived().onWritePins(mask, mask);
+			}
+
+			// Устанавливает логический ноль на всех пинах маски
+			void resetPins(const Mask& mask) {
+				BP_TRACE_SCOPE(GpioWritePins, mask.word(0));
+				derived().onWritePins(mask, Mask());
+			}
+
+			// Переключает состояние всех пинов маски на противоположное
+			void togglePins(const Mask& mask) {
+				BP_TRACE_SCOPE(GpioTogglePins, mask.word(0));
+				derived().onTogglePins(mask);
+			}
+
+			// Читает входное состояние всего порта
+			Mask readPort() {
+				return derived().onReadPortInput();
+			}
+
+			// Читает выходное состояние всего порта
+			Mask readPortOutput() {
+				return derived().onReadPortOutput();
+			}
+
+			// Устанавливает внешний обработчик прерываний
+			void setInterruptCallback(ExternalInterruptCallback_t callback) {
+				interruptCallback = std::move(callback);
+			}
+
+			// Удаляет внешний обработчик прерываний
+			void clearInterruptCallback() {
+				interruptCallback = nullptr;
+			}
+
+			// Устанавливает невыделяющий обработчик прерывания для указанного пина
+			bool setPinInterruptHandler(pin_number_t pin, PinInterruptHandler_t handler) {
+				if (pin > PinMaxNumber) {
+					raiseError(Error::PinNumberError, pin); // Обработка ошибки: некорректный номер пина
+					return false;
+				}
+				pinInterruptHandlers.attach(pin, handler);
+				return true;
+			}
+
+			// Удаляет обработчик прерывания указанного пина
+			void clearPinInterruptHandler(pin_number_t pin) {
+				pinInterruptHandlers.detach(pin);
+			}
+
+		protected:
+			~StaticGpio() = default;
+
+			// Возвращает битовую маску указанного пина внутри 32-битного слова порта
+			static constexpr uint32_t getPinMask(pin_number_t pin) {
+				return static_cast<uint32_t>(1) << (pin % Mask::WordBits);
+			}
+
+			// Возвращает номер 32-битного слова порта, в котором находится указанный пин
+			static constexpr uint32_t getPinWordIndex(pin_number_t pin) {
+				return pin / Mask::WordBits;
+			}
+
+			// Реализации групповых операций по умолчанию (попиново). Наследник может скрыть их
+			// собственными методами с той же сигнатурой, например записью в регистр BSRR
+			void onWritePins(const Mask& mask, const Mask& values) {
+				mask.forEach([&](pin_number_t pin) {
+					if (values.test(pin))
+						derived().onSetPin(pin);
+					else
+						derived().onResetPin(pin);
+				});
+			}
+
+			// Реализация применения образа регистров по умолчанию (попиново через onSetSettings,
+			// образ частичной перенастройки - только измененными полями)
+			bool onApplyImage(const PortImage<IOCount>& image) {
+				if (image.registers != PortImage<IOCount>::AllRegisters) {
+					typedef PortImage<IOCount> Image;
+					image.pins.forEach([&](pin_number_t pin) {
+						const Settings settings = image.settings(pin);
+						if ((image.registers & Image::ModeRegister) != 0)
+							derived().onSetMode(pin, settings.getMode());
+						if ((image.registers & Image::PullRegister) != 0)
+							derived().onSetPull(pin, settings.getPull());
+						if ((image.registers & Image::OutputSpeedRegister) != 0)
+							derived().onSetOutputSpeed(pin, settings.getOutputSpeed());
+						if ((image.registers & Image::OutputTypeRegister) != 0)
+							derived().onSetOutputType(pin, settings.getOutputType());
+					});
+					return true;
+				}
+				bool result = true;
+				image.pins.forEach([&](pin_number_t pin) {
+					result = derived().onSetSettings(pin, image.settings(pin)) && result;
+				});
+				return result;
+			}
+
+			void onTogglePins(const Mask& mask) {
+				derived().onWritePins(mask, ~derived().onReadPortOutput() & mask);
+			}
+
+			void onTogglePin(pin_number_t pin) {
+				if (derived().onGetPinOutput(pin))
+					derived().onResetPin(pin);
+				else
+					derived().onSetPin(pin);
+			}
+
+			Mask onReadPortInput() {
+				Mask result;
+				for (pin_number_t pin = 0; pin <= PinMaxNumber; ++pin)
+					result.set(pin, derived().onGetPinInput(pin));
+				return result;
+			}
+
+			Mask onReadPortOutput() {
+				Mask result;
+				for (pin_number_t pin = 0; pin <= PinMaxNumber; ++pin)
+					result.set(pin, derived().onGetPinOutput(pin));
+				return result;
+			}
+
+			// Обработчик события ошибки по умолчанию: передает код ошибки в onError наследника
+			// (наследник может объявить свой onErrorEvent(const ErrorEvent&), чтобы передать событие в политику ошибок)
+			void onErrorEvent(const ErrorEvent& event) {
+				derived().onError(event.error);
+			}
+
+			// Передает ошибку GPIO с номером пина в onErrorEvent наследника
+			void raiseError(Error error, uint32_t index = ErrorEvent::NoIndex) {
+				derived().onErrorEvent(ErrorEvent(errorSource(error), static_cast<error_t>(error), index));
+			}
+
+			// То же для константных геттеров (см. ControllerPeripheral::raiseError)
+			void raiseError(Error error, uint32_t index = ErrorEvent::NoIndex) const {
+				const_cast<StaticGpio*>(this)->raiseError(error, index);
+			}
+
+			// Диспетчеризация прерываний порта (вызывается наследником из обработчика прерывания).
+			// Для пинов маски pending вызываются обработчики из таблицы по пинам; пины без своего обработчика
+			// передаются во внешний обработчик interruptCallback, если он установлен
+			void dispatchInterrupts(const Mask& pending) {
+				BP_TRACE_SCOPE(GpioInterrupt, pending.word(0));
+				Mask unhandled = pinInterruptHandlers.dispatch(pending);
+				if (interruptCallback)
+					unhandled.forEach(interruptCallback);
+			}
+
+			//Внешний обработчик прерываний (может быть реализован как в наследнике, так и из объекта)
+			ExternalInterruptCallback_t interruptCallback;
+
+			//Таблица невыделяющих обработчиков прерываний по пинам
+			PinInterruptTable<IOCount> pinInterruptHandlers;
+
+			// Счетчики операций (только при BP_TRACE)
+			BP_TRACE_COUNTERS
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,255 @@
+#ifndef TRACE_HPP_
+#define TRACE_HPP_
+
+#include <cstdint>
+#include "SharedMacro.hpp"
+
+// Трассировка операций периферии. Включается на этапе компиляции определением BP_TRACE=1; без него макросы
+// BP_TRACE_SCOPE и BP_TRACE_COUNTERS раскрываются в пустоту, и код блоков периферии не отличается от сборки
+// без трассировки (нет ни вызовов, ни дополнительных полей). В профиле BP_FREESTANDING источник времени
+// по умолчанию (steady_clock) и экспорт в строку недоступны: время задается setClock, записи читаются
+// через forEachRecord.
+#ifndef BP_TRACE
+#define BP_TRACE 0
+#endif
+
+#ifndef BP_TRACE_BUFFER_RECORDS
+#define BP_TRACE_BUFFER_RECORDS 4096 // Записей в буфере одного потока (степень двойки)
+#endif
+
+#ifndef BP_TRACE_MAX_THREADS
+#define BP_TRACE_MAX_THREADS 16      // Максимальное количество потоков с буферами трассировки
+#endif
+
+#if BP_TRACE
+#include <atomic>
+#include "Delegate.hpp"
+#if !BP_FREESTANDING
+#include <chrono>
+#include <cstdio>
+#include <string>
+#endif
+#endif
+
+namespace BasePeripheral {
+	namespace Trace {
+		// Трассируемые операции
+		enum class Op : uint16_t {
+			GpioInitPin,
+			GpioSetPin,
+			GpioResetPin,
+			GpioTogglePin,
+			GpioReadPin,
+			GpioWritePins,
+			GpioTogglePins,
+			GpioInterrupt,
+			DmaInitChannel,
+			DmaEnableChannel,
+			DmaDisableChannel,
+			DmaSetDataCount,
+			DmaSubmitChain,
+			DmaInterrupt,
+			Count
+		};
+
+		static constexpr uint32_t OpCount = static_cast<uint32_t>(Op::Count);
+
+		// Имя операции для экспорта
+		constexpr const char* opName(Op op) {
+			constexpr const char* names[OpCount] = {
+				"Gpio.initPin", "Gpio.setPin", "Gpio.resetPin", "Gpio.togglePin", "Gpio.readPin",
+				"Gpio.writePins", "Gpio.togglePins", "Gpio.interrupt",
+				"Dma.initChannel", "Dma.enableChannel", "Dma.disableChannel", "Dma.setDataCount",
+				"Dma.submitChain", "Dma.interrupt"
+			};
+			return static_cast<uint32_t>(op) < OpCount ? names[static_cast<uint32_t>(op)] : "unknown";
+		}
+
+		// Фаза записи трассировки
+		enum class Phase : uint8_t {
+			Begin, // Начало операции (или вход в прерывание)
+			End    // Конец операции (или выход из прерывания)
+		};
+
+		// Двоичная запись трассировки (16 байт)
+		struct Record {
+			uint64_t timestamp; // Отметка времени, нс
+			uint32_t arg;       // Номер пина или канала (или маска пинов)
+			Op op;              // Операция
+			Phase phase;        // Фаза
+			uint8_t reserved;
+		};
+
+#if BP_TRACE
+		typedef Delegate<uint64_t()> TraceClock_t; // Источник времени трассировки, нс
+
+		// Счетчики операций блока периферии: количество вызовов и суммарное время выполнения
+		struct Counters {
+			std::atomic<uint32_t> calls[OpCount] = {};
+			std::atomic<uint64_t> nanoseconds[OpCount] = {};
+
+			uint32_t getCalls(Op op) const { return calls[static_cast<uint32_t>(op)].load(std::memory_order_relaxed); }
+			uint64_t getNanoseconds(Op op) const { return nanoseconds[static_cast<uint32_t>(op)].load(std::memory_order_relaxed); }
+
+			void reset() {
+				for (uint32_t i = 0; i < OpCount; ++i) {
+					calls[i].store(0, std::memory_order_relaxed);
+					nanoseconds[i].store(0, std::memory_order_relaxed);
+				}
+			}
+		};
+
+		// Кольцевой буфер записей одного потока. Пишет поток-владелец и прерывания, вытесняющие его на том же ядре
+		// (без блокировок): ячейка резервируется атомарным увеличением счетчика до записи, поэтому запись
+		// из прерывания посреди push не занимает ту же ячейку. При заполнении перезаписываются самые старые записи
+		struct ThreadBuffer {
+			static constexpr uint32_t Capacity = BP_TRACE_BUFFER_RECORDS;
+			static_assert((Capacity & (Capacity - 1)) == 0, "Trace buffer size must be a power of two");
+
+			std::atomic<uint64_t> written{ 0 }; // Количество записей с момента создания
+			Record records[Capacity];
+
+			void push(const Record& record) {
+				const uint64_t position = written.fetch_add(1, std::memory_order_relaxed);
+				records[position & (Capacity - 1)] = record;
+			}
+		};
+
+		namespace Detail {
+			inline ThreadBuffer buffers[BP_TRACE_MAX_THREADS];       // Буферы потоков
+			inline std::atomic<uint32_t> bufferCount{ 0 };          // Занятые буферы
+			inline TraceClock_t clock;                              // Пользовательский источник времени
+
+			inline uint64_t steadyNanoseconds() {
+#if BP_FREESTANDING
+				return 0;
+#else
+				return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+			}
+
+			// Буфер текущего потока (выделяется при первой записи; nullptr, если буферы закончились)
+			inline ThreadBuffer* threadBuffer() {
+				thread_local ThreadBuffer* buffer = [] {
+					const uint32_t index = bufferCount.fetch_add(1, std::memory_order_relaxed);
+					if (index < BP_TRACE_MAX_THREADS)
+						return &buffers[index];
+					RG_LOG(Warning, "Trace: no free thread buffer, records of this thread are dropped");
+					return static_cast<ThreadBuffer*>(nullptr);
+				}();
+				return buffer;
+			}
+		}
+
+		// Устанавливает источник времени (например, счетчик тактов); по умолчанию - steady_clock
+		// (в профиле BP_FREESTANDING источника по умолчанию нет, отметки времени равны нулю)
+		inline void setClock(TraceClock_t clock) { Detail::clock = clock; }
+
+		inline uint64_t now() { return Detail::clock ? Detail::clock() : Detail::steadyNanoseconds(); }
+
+		// Добавляет запись в буфер текущего потока
+		inline void record(Op op, Phase phase, uint32_t arg, uint64_t timestamp) {
+			if (ThreadBuffer* buffer = Detail::threadBuffer())
+				buffer->push(Record{ timestamp, arg, op, phase, 0 });
+		}
+
+		// Область трассировки операции: запись начала при создании, запись конца и обновление счетчиков при разрушении
+		class Scope {
+		public:
+			Scope(Counters& counters, Op op, uint32_t arg) : _counters(counters), _op(op), _arg(arg), _start(now()) {
+				record(op, Phase::Begin, arg, _start);
+			}
+
+			~Scope() {
+				const uint64_t end = now();
+				record(_op, Phase::End, _arg, end);
+				_counters.calls[static_cast<uint32_t>(_op)].fetch_add(1, std::memory_order_relaxed);
+				_counters.nanoseconds[static_cast<uint32_t>(_op)].fetch_add(end - _start, std::memory_order_relaxed);
+			}
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+
+		private:
+			Counters& _counters;
+			Op _op;
+			uint32_t _arg;
+			uint64_t _start;
+		};
+
+		// Очищает буферы всех потоков (потоки не должны писать во время очистки)
+		inline void clear() {
+			const uint32_t count = Detail::bufferCount.load(std::memory_order_acquire);
+			for (uint32_t i = 0; i < count && i < BP_TRACE_MAX_THREADS; ++i)
+				Detail::buffers[i].written.store(0, std::memory_order_relaxed);
+		}
+
+		// Передает все записи в visitor(uint32_t thread, const Record&) по потокам, от старых к новым
+		// (потоки не должны писать во время обхода)
+		template <typename Visitor>
+		void forEachRecord(Visitor&& visitor) {
+			const uint32_t count = Detail::bufferCount.load(std::memory_order_acquire);
+			for (uint32_t thread = 0; thread < count && thread < BP_TRACE_MAX_THREADS; ++thread) {
+				const ThreadBuffer& buffer = Detail::buffers[thread];
+				const uint64_t written = buffer.written.load(std::memory_order_acquire);
+				const uint64_t first = written > ThreadBuffer::Capacity ? written - ThreadBuffer::Capacity : 0;
+				for (uint64_t position = first; position < written; ++position)
+					visitor(thread, buffer.records[position & (ThreadBuffer::Capacity - 1)]);
+			}
+		}
+
+#if !BP_FREESTANDING
+		// Экспортирует записи в формате Chrome Trace Event JSON (открывается в chrome://tracing и Perfetto UI).
+		// Текст передается частями в writer(const char* data, size_t size), например для записи в файл
+		template <typename Writer>
+		void exportChromeTrace(Writer&& writer) {
+			char line[160];
+			const char header[] = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+			writer(header, sizeof(header) - 1);
+			bool first = true;
+			forEachRecord([&](uint32_t thread, const Record& record) {
+				const Op op = record.op;
+				const int length = std::snprintf(line, sizeof(line),
+					"%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%llu.%03u,\"pid\":1,\"tid\":%u,\"args\":{\"arg\":%u}}",
+					first ? "\n" : ",\n", opName(op), op < Op::DmaInitChannel ? "gpio" : "dma",
+					record.phase == Phase::Begin ? 'B' : 'E',
+					static_cast<unsigned long long>(record.timestamp / 1000u), static_cast<unsigned>(record.timestamp % 1000u),
+					static_cast<unsigned>(thread), static_cast<unsigned>(record.arg));
+				if (length > 0)
+					writer(line, static_cast<size_t>(length) < sizeof(line) ? static_cast<size_t>(length) : sizeof(line) - 1);
+				first = false;
+			});
+			const char footer[] = "\n]}\n";
+			writer(footer, sizeof(footer) - 1);
+		}
+
+		// Экспортирует записи в строку JSON
+		inline std::string exportChromeTrace() {
+			std::string json;
+			exportChromeTrace([&](const char* data, size_t size) { json.append(data, size); });
+			return json;
+		}
+#endif
+#endif
+	}
+}
+
+#if BP_TRACE
+// Объявляет счетчики операций в блоке периферии и метод доступа к ним
+#define BP_TRACE_COUNTERS \
+	public: \
+		const ::BasePeripheral::Trace::Counters& getTraceCounters() const { return traceCounters; } \
+		void resetTraceCounters() { traceCounters.reset(); } \
+	private: \
+		::BasePeripheral::Trace::Counters traceCounters;
+
+// Трассирует операцию до конца текущей области видимости
+#define BP_TRACE_SCOPE(op, arg) \
+	const ::BasePeripheral::Trace::Scope traceScope_(traceCounters, ::BasePeripheral::Trace::Op::op, static_cast<uint32_t>(arg))
+#else
+#define BP_TRACE_COUNTERS
+#define BP_TRACE_SCOPE(op, arg) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,382 @@
+#ifndef TRANSACTION_HPP_
+#define TRANSACTION_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include "BaseDma.hpp"
+#include "BaseGpio.hpp"
+
+namespace BasePeripheral {
+	// Двоичный формат снимков конфигурации: заголовок из 4 байт (метка блока, версия формата, количество
+	// пинов или каналов, резерв), затем данные в порядке little-endian. Снимки не зависят от порядка байтов
+	// и выравнивания платформы и могут храниться во флеш-памяти как готовые профили
+	namespace SnapshotFormat {
+		static constexpr uint8_t Version = 1;     // Версия формата
+		static constexpr uint8_t GpioTag = 'G';   // Метка снимка порта GPIO
+		static constexpr uint8_t DmaTag = 'D';    // Метка снимка контроллера DMA
+		static constexpr size_t HeaderSize = 4;   // Размер заголовка
+
+		inline void storeHeader(uint8_t* out, uint8_t tag, uint32_t count) {
+			out[0] = tag;
+			out[1] = Version;
+			out[2] = static_cast<uint8_t>(count);
+			out[3] = 0;
+		}
+
+		inline bool checkHeader(const uint8_t* in, uint8_t tag, uint32_t count) {
+			return in[0] == tag && in[1] == Version && in[2] == static_cast<uint8_t>(count);
+		}
+
+		inline void store32(uint8_t* out, uint32_t value) {
+			out[0] = static_cast<uint8_t>(value);
+			out[1] = static_cast<uint8_t>(value >> 8);
+			out[2] = static_cast<uint8_t>(value >> 16);
+			out[3] = static_cast<uint8_t>(value >> 24);
+		}
+
+		inline uint32_t load32(const uint8_t* in) {
+			return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8) |
+				(static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24);
+		}
+	}
+
+	namespace Gpio {
+		// Снимок конфигурации порта: упакованные настройки пинов (байт на пин) и уровни выходов.
+		// В двоичном виде занимает HeaderSize + IOCount + IOCount / 8 байт (22 байта для 16 пинов)
+		template <uint32_t IOCount>
+		struct PortSnapshot {
+			static_assert(IOCount <= 255, "Snapshot header stores the pin count in one byte");
+
+			static constexpr size_t SerializedSize = SnapshotFormat::HeaderSize + IOCount + (IOCount + 7) / 8;
+
+			SettingsTable<IOCount> settings; // Настройки пинов
+			PinMask<IOCount> outputs;        // Уровни выходов
+
+			// Записывает снимок в out. Возвращает количество записанных байт (0, если буфер мал)
+			size_t serialize(uint8_t* out, size_t capacity) const {
+				if (capacity < SerializedSize)
+					return 0;
+				SnapshotFormat::storeHeader(out, SnapshotFormat::GpioTag, IOCount);
+				uint8_t* data = out + SnapshotFormat::HeaderSize;
+				for (pin_number_t pin = 0; pin < IOCount; ++pin)
+					data[pin] = settings.get(pin).toRaw();
+				data += IOCount;
+				for (uint32_t i = 0; i < (IOCount + 7) / 8; ++i)
+					data[i] = static_cast<uint8_t>(outputs.word(i / 4) >> ((i % 4) * 8));
+				return SerializedSize;
+			}
+
+			// Читает снимок из in. Возвращает false (снимок не изменяется), если данные не от порта этой ширины
+			// или настройки пинов содержат значения вне перечислений
+			bool deserialize(const uint8_t* in, size_t size) {
+				if (size < SerializedSize || !SnapshotFormat::checkHeader(in, SnapshotFormat::GpioTag, IOCount))
+					return false;
+				const uint8_t* data = in + SnapshotFormat::HeaderSize;
+				for (pin_number_t pin = 0; pin < IOCount; ++pin)
+					if (!Settings::isValidRaw(data[pin]))
+						return false;
+				for (pin_number_t pin = 0; pin < IOCount; ++pin)
+					settings.set(pin, Settings::fromRaw(data[pin]));
+				data += IOCount;
+				for (uint32_t word = 0; word < PinMask<IOCount>::WordsCount; ++word) {
+					uint32_t value = 0;
+					for (uint32_t byte = 0; byte < 4 && word * 4 + byte < (IOCount + 7) / 8; ++byte)
+						value |= static_cast<uint32_t>(data[word * 4 + byte]) << (byte * 8);
+					outputs.setWord(word, value);
+				}
+				return true;
+			}
+
+			bool operator==(const PortSnapshot& other) const { return settings == other.settings && outputs == other.outputs; }
+			bool operator!=(const PortSnapshot& other) const { return !(*this == other); }
+		};
+
+		// Транзакция перенастройки порта. Изменения накапливаются в целевом снимке без обращения к порту;
+		// commit вычисляет отличия от исходного состояния и применяет их: уровни выходов - одной записью
+		// (до смены режимов, чтобы пины, переводимые в режим выхода, не давали выброса), настройки - одним
+		// образом PortImage, в котором отмечены только регистры с измененными полями (одна запись на регистр).
+		// После commit исходным состоянием становится целевое, поэтому долгоживущая транзакция переключает
+		// профили (load + commit) без чтения регистров порта.
+		// Port - BaseGpio или StaticGpio (или наследник)
+		template <typename Port>
+		class PortTransaction {
+		public:
+			static constexpr uint32_t IOCount = Port::PinMaxNumber + 1;
+
+			typedef PortSnapshot<IOCount> Snapshot;
+			typedef PinMask<IOCount> Mask;
+
+			// Конструктор. Исходное состояние читается из порта
+			explicit PortTransaction(Port& port) : _port(port) { refresh(); }
+
+			PortTransaction(const PortTransaction&) = delete;
+			PortTransaction& operator=(const PortTransaction&) = delete;
+
+			// Читает текущее состояние порта (настройки через getSettings, с теневой таблицей - из ОЗУ)
+			// и отменяет подготовленные изменения
+			void refresh() {
+				_base = capture(_port);
+				_target = _base;
+			}
+
+			// Снимок текущего состояния порта
+			static Snapshot capture(Port& port) {
+				Snapshot snapshot;
+				for (pin_number_t pin = 0; pin < IOCount; ++pin)
+					snapshot.settings.set(pin, port.getSettings(pin));
+				snapshot.outputs = port.readPortOutput();
+				return snapshot;
+			}
+
+			// Подготовка изменений (пины вне диапазона игнорируются)
+			void updateSettings(pin_number_t pin, const Settings& settings) { _target.settings.set(pin, settings); }
+			void setMode(pin_number_t pin, Mode mode) { modify(pin, [&](Settings& settings) { settings.setMode(mode); }); }
+			void setPull(pin_number_t pin, Pull pull) { modify(pin, [&](Settings& settings) { settings.setPull(pull); }); }
+			void setOutputType(pin_number_t pin, OutputType outputType) {
+				modify(pin, [&](Settings& settings) { settings.setOutputType(outputType); });
+			}
+			void setOutputSpeed(pin_number_t pin, OutputSpeed speed) {
+				modify(pin, [&](Settings& settings) { settings.setOutputSpeed(speed); });
+			}
+			void writePin(pin_number_t pin, bool level) { _target.outputs.set(pin, level); }
+			void writePins(const Mask& mask, const Mask& values) { _target.outputs = (_target.outputs & ~mask) | (values & mask); }
+
+			// Загружает целевую конфигурацию целиком (профиль)
+			void load(const Snapshot& snapshot) { _target = snapshot; }
+
+			// Отменяет подготовленные изменения
+			void rollback() { _target = _base; }
+
+			// Пины, настройки или уровни выходов которых будут изменены
+			Mask changedPins() const { return _target.settings.diff(_base.settings) | (_target.outputs ^ _base.outputs); }
+
+			// Применяет подготовленные изменения. При ошибке исходное состояние перечитывается из порта
+			bool commit() {
+				const Mask outputs = _target.outputs ^ _base.outputs;
+				if (outputs.any())
+					_port.writePins(outputs, _target.outputs);
+				const PortImage<IOCount> image = PortImage<IOCount>::delta(_base.settings, _target.settings);
+				if (image.registers != 0 && !_port.applyImage(image)) {
+					const Snapshot target = _target;
+					refresh();
+					_target = target;
+					return false;
+				}
+				_base = _target;
+				return true;
+			}
+
+			const Snapshot& base() const { return _base; }     // Исходное (примененное) состояние
+			const Snapshot& target() const { return _target; } // Целевое состояние
+
+		private:
+			template <typename Function>
+			void modify(pin_number_t pin, Function&& function) {
+				if (pin >= IOCount)
+					return;
+				Settings settings = _target.settings.get(pin);
+				function(settings);
+				_target.settings.set(pin, settings);
+			}
+
+			Port& _port;      // Порт
+			Snapshot _base;   // Исходное состояние
+			Snapshot _target; // Целевое состояние
+		};
+	}
+
+	namespace Dma {
+		// Состояние канала в снимке: образ управляющего регистра, адреса сторон и количество элементов
+		struct ChannelState {
+			uint32_t control = 0;             // Образ управляющего регистра (ChannelImage)
+			address_t periphOrSrcAddr = 0;    // Адрес периферии (источника для память-память)
+			address_t memoryOrDstAddr = 0;    // Адрес памяти (приемника для память-память)
+			uint32_t count = 0;               // Количество элементов передачи
+
+			bool operator==(const ChannelState& other) const {
+				return control == other.control && periphOrSrcAddr == other.periphOrSrcAddr &&
+					memoryOrDstAddr == other.memoryOrDstAddr && count == other.count;
+			}
+			bool operator!=(const ChannelState& other) const { return !(*this == other); }
+		};
+
+		// Снимок конфигурации каналов контроллера DMA (16 байт на канал в двоичном виде)
+		template <uint32_t ChannelsCount>
+		struct ControllerSnapshot {
+			static_assert(ChannelsCount <= 255, "Snapshot header stores the channel count in one byte");
+
+			static constexpr size_t ChannelSize = 16;
+			static constexpr size_t SerializedSize = SnapshotFormat::HeaderSize + ChannelsCount * ChannelSize;
+
+			ChannelState channels[ChannelsCount];
+
+			// Записывает снимок в out. Возвращает количество записанных байт (0, если буфер мал)
+			size_t serialize(uint8_t* out, size_t capacity) const {
+				if (capacity < SerializedSize)
+					return 0;
+				SnapshotFormat::storeHeader(out, SnapshotFormat::DmaTag, ChannelsCount);
+				uint8_t* data = out + SnapshotFormat::HeaderSize;
+				for (const ChannelState& channel : channels) {
+					SnapshotFormat::store32(data, channel.control);
+					SnapshotFormat::store32(data + 4, channel.periphOrSrcAddr);
+					SnapshotFormat::store32(data + 8, channel.memoryOrDstAddr);
+					SnapshotFormat::store32(data + 12, channel.count);
+					data += ChannelSize;
+				}
+				return SerializedSize;
+			}
+
+			// Читает снимок из in. Возвращает false (снимок не изменяется), если данные не от контроллера этой ширины
+			// или образ управляющего регистра канала недопустим (см. ChannelImage::isValid)
+			bool deserialize(const uint8_t* in, size_t size) {
+				if (size < SerializedSize || !SnapshotFormat::checkHeader(in, SnapshotFormat::DmaTag, ChannelsCount))
+					return false;
+				const uint8_t* data = in + SnapshotFormat::HeaderSize;
+				for (uint32_t i = 0; i < ChannelsCount; ++i)
+					if (!ChannelImage::isValid(SnapshotFormat::load32(data + i * ChannelSize)))
+						return false;
+				for (ChannelState& channel : channels) {
+					channel.control = SnapshotFormat::load32(data);
+					channel.periphOrSrcAddr = SnapshotFormat::load32(data + 4);
+					channel.memoryOrDstAddr = SnapshotFormat::load32(data + 8);
+					channel.count = SnapshotFormat::load32(data + 12);
+					data += ChannelSize;
+				}
+				return true;
+			}
+
+			bool operator==(const ControllerSnapshot& other) const {
+				for (uint32_t i = 0; i < ChannelsCount; ++i)
+					if (channels[i] != other.channels[i])
+						return false;
+				return true;
+			}
+			bool operator!=(const ControllerSnapshot& other) const { return !(*this == other); }
+		};
+
+		// Транзакция перенастройки каналов DMA. Изменения накапливаются в целевом снимке; commit записывает
+		// для каждого канала только отличающиеся регистры: управляющий (одна запись на все поля настроек),
+		// адреса сторон и количество элементов. Перенастраиваемые каналы должны быть выключены (аппаратура
+		// игнорирует запись настроек включенного канала); состояние включения транзакцией не изменяется.
+		// Controller - BaseDma или StaticDma (или наследник)
+		template <typename Controller>
+		class ControllerTransaction {
+		public:
+			static constexpr uint32_t ChannelsCount = Controller::ChannelMaxNumber + 1;
+
+			typedef ControllerSnapshot<ChannelsCount> Snapshot;
+
+			// Конструктор. Исходное состояние читается из контроллера
+			explicit ControllerTransaction(Controller& dma) : _dma(dma) { refresh(); }
+
+			ControllerTransaction(const ControllerTransaction&) = delete;
+			ControllerTransaction& operator=(const ControllerTransaction&) = delete;
+
+			// Читает текущее состояние каналов и отменяет подготовленные изменения
+			void refresh() {
+				_base = capture(_dma);
+				_target = _base;
+			}
+
+			// Снимок текущего состояния каналов
+			static Snapshot capture(Controller& dma) {
+				Snapshot snapshot;
+				for (channel_number_t channel = 0; channel < ChannelsCount; ++channel)
+					snapshot.channels[channel] = toState(dma.getSettings(channel), dma.getDataCount(channel));
+				return snapshot;
+			}
+
+			// Подготовка изменений (каналы вне диапазона игнорируются)
+			void initChannel(channel_number_t channel, const Settings& settings) {
+				if (channel < ChannelsCount)
+					_target.channels[channel] = toState(settings, _target.channels[channel].count);
+			}
+			void setDirection(channel_number_t channel, Direction direction) {
+				modify(channel, [&](Settings& settings) { settings.setDirection(direction); });
+			}
+			void setMode(channel_number_t channel, Mode mode) { modify(channel, [&](Settings& settings) { settings.setMode(mode); }); }
+			void setPriority(channel_number_t channel, Priority priority) {
+				modify(channel, [&](Settings& settings) { settings.setPriority(priority); });
+			}
+			void setMemorySettings(channel_number_t channel, const MemorySettings& src, const MemorySettings& dst) {
+				modify(channel, [&](Settings& settings) { settings.setPeriphOrMemToMemSrc(src).setMemoryOrMemToMemDst(dst); });
+			}
+			void setDataCount(channel_number_t channel, uint32_t count) {
+				if (channel < ChannelsCount)
+					_target.channels[channel].count = count;
+			}
+
+			// Загружает целевую конфигурацию целиком (профиль)
+			void load(const Snapshot& snapshot) { _target = snapshot; }
+
+			// Отменяет подготовленные изменения
+			void rollback() { _target = _base; }
+
+			// Маска каналов (бит N - канал N), которые будут изменены
+			uint32_t changedChannels() const {
+				uint32_t mask = 0;
+				for (channel_number_t channel = 0; channel < ChannelsCount && channel < 32; ++channel)
+					mask |= _target.channels[channel] != _base.channels[channel] ? 1u << channel : 0u;
+				return mask;
+			}
+
+			// Применяет подготовленные изменения. При ошибке исходное состояние перечитывается из контроллера
+			bool commit() {
+				bool result = true;
+				for (channel_number_t channel = 0; channel < ChannelsCount; ++channel) {
+					const ChannelState& from = _base.channels[channel];
+					const ChannelState& to = _target.channels[channel];
+					const uint32_t fields = (from.control != to.control ? ChannelField::Control : 0u) |
+						(from.periphOrSrcAddr != to.periphOrSrcAddr ? ChannelField::PeriphOrSrcAddr : 0u) |
+						(from.memoryOrDstAddr != to.memoryOrDstAddr ? ChannelField::MemoryOrDstAddr : 0u);
+					if (fields != 0) {
+						ChannelImage image;
+						image.control = to.control;
+						result = _dma.applyChannelImage(channel, image, to.periphOrSrcAddr, to.memoryOrDstAddr, fields) && result;
+					}
+					if (from.count != to.count)
+						_dma.setDataCount(channel, to.count);
+				}
+				if (!result) {
+					const Snapshot target = _target;
+					refresh();
+					_target = target;
+					return false;
+				}
+				_base = _target;
+				return true;
+			}
+
+			const Snapshot& base() const { return _base; }     // Исходное (примененное) состояние
+			const Snapshot& target() const { return _target; } // Целевое состояние
+
+		private:
+			static ChannelState toState(const Settings& settings, uint32_t count) {
+				ChannelState state;
+				state.control = ChannelImage::fromSettings(settings).control;
+				state.periphOrSrcAddr = settings.getPeriphOrMemToMemSrc().getAddr();
+				state.memoryOrDstAddr = settings.getMemoryOrMemToMemDst().getAddr();
+				state.count = count;
+				return state;
+			}
+
+			template <typename Function>
+			void modify(channel_number_t channel, Function&& function) {
+				if (channel >= ChannelsCount)
+					return;
+				ChannelState& state = _target.channels[channel];
+				ChannelImage image;
+				image.control = state.control;
+				Settings settings = image.settings(state.periphOrSrcAddr, state.memoryOrDstAddr);
+				function(settings);
+				state = toState(settings, state.count);
+			}
+
+			Controller& _dma; // Контроллер DMA
+			Snapshot _base;   // Исходное состояние
+			Snapshot _target; // Целевое состояние
+		};
+	}
+}
+
+#endif
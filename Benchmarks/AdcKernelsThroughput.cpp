@@ -0,0 +1,137 @@
+// Пропускная способность ядер обработки блоков АЦП (миллионов входных отсчетов в секунду): векторная
+// реализация, выбранная при компиляции (AVX2, SSE2 или NEON), против эталонной скалярной для калибровки
+// (Q4.12 и float), разделения четырех каналов, передискретизации x16, CIC-дециматора четырех каналов
+// и FIR-дециматора Q15. Проверяется совпадение результатов векторной и скалярной реализаций
+#include <algorithm>
+#include <vector>
+#include "AdcKernels.hpp"
+#include "Bench.hpp"
+
+using namespace BasePeripheral::Adc;
+
+namespace {
+	constexpr size_t Samples = 65536;
+	constexpr uint32_t Repeats = 100;
+	constexpr uint32_t Channels = 4;
+	constexpr uint32_t Oversampling = 16;
+	constexpr uint32_t CicRatio = 8;
+	constexpr uint32_t FirTaps = 21;
+	constexpr uint32_t FirRatio = 3;
+
+#if defined(BP_ADC_KERNELS_AVX2)
+	const char* const Isa = "avx2";
+#elif defined(BP_ADC_KERNELS_SSE2)
+	const char* const Isa = "sse2";
+#elif defined(BP_ADC_KERNELS_NEON)
+	const char* const Isa = "neon";
+#else
+	const char* const Isa = "scalar";
+#endif
+
+	// Замеряет Repeats выполнений kernel над Samples входными отсчетами и печатает результат
+	template <typename Kernel>
+	void measure(const char* kernel, const char* variant, Kernel function) {
+		const double elapsed = Bench::seconds([&]() {
+			for (uint32_t i = 0; i < Repeats; ++i)
+				function();
+		});
+		char name[64];
+		std::snprintf(name, sizeof(name), "adc.%s.%s", kernel, variant);
+		Bench::report(name, "throughput", static_cast<double>(Samples) * Repeats / elapsed / 1e6, "Msamples/s");
+	}
+
+	// Эталонный FIR-дециматор Q15: прямая свертка с округлением и ограничением диапазона
+	size_t referenceFir(const sample_t* in, size_t count, const int16_t* h, sample_t* out) {
+		size_t produced = 0;
+		for (size_t i = 0; i < count; i += FirRatio) {
+			int32_t acc = 0;
+			for (uint32_t k = 0; k < FirTaps && k <= i; ++k)
+				acc += h[k] * in[i - k];
+			const int32_t value = (acc + (1 << (Kernels::FirShift - 1))) >> Kernels::FirShift;
+			out[produced++] = static_cast<sample_t>(value < 0 ? 0 : value > 0xFFFF ? 0xFFFF : value);
+		}
+		return produced;
+	}
+}
+
+int main(int argc, char** argv) {
+	Bench::init(argc, argv);
+	std::printf("ADC kernels: %s\n", Isa);
+
+	std::vector<sample_t> in(Samples);
+	uint32_t seed = 1;
+	for (sample_t& value : in) {
+		seed = seed * 1103515245u + 12345u;
+		value = static_cast<sample_t>((seed >> 16) & 0xFFFu);
+	}
+
+	std::vector<sample_t> out(Samples);
+	std::vector<sample_t> reference(Samples);
+	Kernels::calibrate(in.data(), out.data(), Samples, 37, 4500, 4095);
+	Kernels::Scalar::calibrate(in.data(), reference.data(), Samples, 37, 4500, 4095);
+	CHECK(out == reference);
+	measure("calibrate_q12", Isa, [&]() { Kernels::calibrate(in.data(), out.data(), Samples, 37, 4500, 4095); });
+	measure("calibrate_q12", "reference", [&]() { Kernels::Scalar::calibrate(in.data(), out.data(), Samples, 37, 4500, 4095); });
+
+	std::vector<float> outFloat(Samples);
+	std::vector<float> referenceFloat(Samples);
+	Kernels::calibrate(in.data(), outFloat.data(), Samples, 12.5f, 0.8f);
+	Kernels::Scalar::calibrate(in.data(), referenceFloat.data(), Samples, 12.5f, 0.8f);
+	CHECK(outFloat == referenceFloat);
+	measure("calibrate_f32", Isa, [&]() { Kernels::calibrate(in.data(), outFloat.data(), Samples, 12.5f, 0.8f); });
+	measure("calibrate_f32", "reference", [&]() { Kernels::Scalar::calibrate(in.data(), outFloat.data(), Samples, 12.5f, 0.8f); });
+
+	const size_t frames = Samples / Channels;
+	sample_t* const lanes[Channels] = { out.data(), out.data() + frames, out.data() + 2 * frames, out.data() + 3 * frames };
+	sample_t* const referenceLanes[Channels] = { reference.data(), reference.data() + frames, reference.data() + 2 * frames,
+		reference.data() + 3 * frames };
+	Kernels::deinterleave(in.data(), frames, Channels, lanes);
+	Kernels::Scalar::deinterleave(in.data(), frames, Channels, referenceLanes);
+	CHECK(out == reference);
+	measure("deinterleave4", Isa, [&]() { Kernels::deinterleave(in.data(), frames, Channels, lanes); });
+	measure("deinterleave4", "reference", [&]() { Kernels::Scalar::deinterleave(in.data(), frames, Channels, referenceLanes); });
+
+	const size_t sums = Samples / Oversampling;
+	std::vector<uint32_t> outSums(sums);
+	std::vector<uint32_t> referenceSums(sums);
+	Kernels::sumGroups(in.data(), sums, Oversampling, outSums.data());
+	Kernels::Scalar::sumGroups(in.data(), sums, Oversampling, referenceSums.data());
+	CHECK(outSums == referenceSums);
+	measure("oversample16", Isa, [&]() { Kernels::sumGroups(in.data(), sums, Oversampling, outSums.data()); });
+	measure("oversample16", "reference", [&]() { Kernels::Scalar::sumGroups(in.data(), sums, Oversampling, referenceSums.data()); });
+
+	// CIC: четыре канала одним векторным фильтром против четырех одноканальных (скалярный путь)
+	std::vector<int32_t> cicOut(Samples);
+	std::vector<int32_t> cicReference(Samples);
+	Kernels::CicDecimator<3, Channels> cic(CicRatio);
+	Kernels::CicDecimator<3, 1> cicChannels[Channels] = { Kernels::CicDecimator<3, 1>(CicRatio), Kernels::CicDecimator<3, 1>(CicRatio),
+		Kernels::CicDecimator<3, 1>(CicRatio), Kernels::CicDecimator<3, 1>(CicRatio) };
+	std::vector<sample_t> channelInput(Samples);
+	for (uint32_t channel = 0; channel < Channels; ++channel)
+		for (size_t frame = 0; frame < frames; ++frame)
+			channelInput[channel * frames + frame] = in[frame * Channels + channel];
+	const size_t cicFrames = cic.process(in.data(), frames, cicOut.data());
+	for (uint32_t channel = 0; channel < Channels; ++channel) {
+		const size_t produced = cicChannels[channel].process(channelInput.data() + channel * frames, frames, cicReference.data() + channel * frames);
+		CHECK(produced == cicFrames);
+		for (size_t frame = 0; frame < produced; ++frame)
+			CHECK(cicOut[frame * Channels + channel] == cicReference[channel * frames + frame]);
+	}
+	measure("cic3_x8_4ch", Isa, [&]() { cic.process(in.data(), frames, cicOut.data()); });
+	measure("cic3_x8_4ch", "reference", [&]() {
+		for (uint32_t channel = 0; channel < Channels; ++channel)
+			cicChannels[channel].process(channelInput.data() + channel * frames, frames, cicReference.data() + channel * frames);
+	});
+
+	int16_t taps[FirTaps];
+	for (uint32_t k = 0; k < FirTaps; ++k)
+		taps[k] = static_cast<int16_t>(1500 - 50 * static_cast<int32_t>(k));
+	Kernels::FirDecimator<int16_t, FirTaps> fir(taps, FirRatio);
+	const size_t firOut = fir.process(in.data(), Samples, out.data());
+	CHECK(firOut == referenceFir(in.data(), Samples, taps, reference.data()));
+	CHECK(std::equal(out.begin(), out.begin() + firOut, reference.begin()));
+	measure("fir21_d3_q15", Isa, [&]() { fir.reset(); fir.process(in.data(), Samples, out.data()); });
+	measure("fir21_d3_q15", "reference", [&]() { Bench::keep(referenceFir(in.data(), Samples, taps, reference.data())); });
+
+	return CHECK_RESULT();
+}
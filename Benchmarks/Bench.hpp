@@ -0,0 +1,73 @@
+#ifndef BENCH_HPP_
+#define BENCH_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include "Check.hpp"
+
+// Запрет встраивания: замеряемая функция остается отдельной (и видна в дизассемблере)
+#if defined(__GNUC__) || defined(__clang__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE
+#endif
+
+// Общие средства микробенчмарков на симуляторе. Результат печатается строкой
+// "BENCH <имя> <метрика>=<значение> <единица>" и дописывается в CSV-файл (--csv F), как у BenchRunner.
+// Нарушения корректности проверяются CHECK и дают ненулевой код завершения (CHECK_RESULT)
+namespace Bench {
+	inline const char* csvPath = nullptr;
+
+	inline void init(int argc, char** argv) {
+		for (int i = 1; i + 1 < argc; ++i)
+			if (std::strcmp(argv[i], "--csv") == 0)
+				csvPath = argv[i + 1];
+	}
+
+	inline void report(const char* name, const char* metric, double value, const char* unit) {
+		std::printf("BENCH %s %s=%.3f %s\n", name, metric, value, unit);
+		if (csvPath == nullptr)
+			return;
+		if (std::FILE* csv = std::fopen(csvPath, "a")) {
+			std::fprintf(csv, "%lld,%s,%s,%.3f,%s\n",
+				static_cast<long long>(std::chrono::duration_cast<std::chrono::seconds>(
+					std::chrono::system_clock::now().time_since_epoch()).count()),
+				name, metric, value, unit);
+			std::fclose(csv);
+		}
+	}
+
+	// Не дает оптимизатору удалить вычисление значения
+	template <typename T>
+	inline void keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r"(&value) : "memory");
+#else
+		static volatile const void* sink;
+		sink = &value;
+#endif
+	}
+
+	// Время выполнения функции, секунды
+	template <typename F>
+	inline double seconds(F&& function) {
+		const auto start = std::chrono::steady_clock::now();
+		function();
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// Среднее время одного вызова функции, наносекунды
+	template <typename F>
+	inline double nanosecondsPerCall(uint32_t iterations, F&& function) {
+		return seconds([&]() {
+			for (uint32_t i = 0; i < iterations; ++i)
+				function(i);
+		}) * 1e9 / iterations;
+	}
+}
+
+#endif
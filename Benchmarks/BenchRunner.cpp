@@ -0,0 +1,150 @@
+// Замеры для отслеживания регрессий профилей сборки:
+//   BenchRunner size    --name N [--budget B] [--csv F] -- <файл>          размер файла, байт
+//   BenchRunner startup --name N [--runs R] [--budget B] [--csv F] -- <команда...>
+//                                                                         среднее время запуска процесса, мкс
+//   BenchRunner compile --name N [--runs R] [--budget B] [--csv F] -- <компилятор> <аргументы...>
+//                                                                         среднее время компиляции, мс
+// Результат печатается строкой "BENCH <имя> <метрика>=<значение> <единица>" и дописывается в CSV-файл.
+// При превышении бюджета (0 - без ограничения) или ошибке команды возвращается ненулевой код
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <spawn.h>
+#include <sys/wait.h>
+extern char** environ;
+#endif
+
+namespace {
+	struct Options {
+		std::string metric;             // size, startup или compile
+		std::string name;               // Имя замера
+		std::string csv;                // Файл для накопления результатов
+		unsigned runs = 20;             // Количество повторов
+		double budget = 0;              // Допустимое значение (0 - без ограничения)
+		std::vector<std::string> command; // Файл или команда после "--"
+	};
+
+	bool parse(int argc, char** argv, Options& options) {
+		if (argc < 2)
+			return false;
+		options.metric = argv[1];
+		int i = 2;
+		for (; i < argc && std::strcmp(argv[i], "--") != 0; ++i) {
+			if (i + 1 >= argc)
+				return false;
+			if (std::strcmp(argv[i], "--name") == 0)
+				options.name = argv[++i];
+			else if (std::strcmp(argv[i], "--csv") == 0)
+				options.csv = argv[++i];
+			else if (std::strcmp(argv[i], "--runs") == 0)
+				options.runs = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+			else if (std::strcmp(argv[i], "--budget") == 0)
+				options.budget = std::strtod(argv[++i], nullptr);
+			else
+				return false;
+		}
+		for (++i; i < argc; ++i)
+			options.command.push_back(argv[i]);
+		return !options.name.empty() && !options.command.empty() && options.runs > 0;
+	}
+
+	// Запускает команду и ждет ее завершения. Возвращает код завершения (-1 - команда не запущена)
+	int run(const std::vector<std::string>& command) {
+		std::vector<char*> args;
+		for (const std::string& arg : command)
+			args.push_back(const_cast<char*>(arg.c_str()));
+		args.push_back(nullptr);
+#ifdef _WIN32
+		return static_cast<int>(_spawnvp(_P_WAIT, args[0], args.data()));
+#else
+		pid_t pid;
+		if (posix_spawnp(&pid, args[0], nullptr, nullptr, args.data(), environ) != 0)
+			return -1;
+		int status = 0;
+		if (waitpid(pid, &status, 0) < 0)
+			return -1;
+		return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+#endif
+	}
+
+	// Среднее время выполнения команды в секундах (отрицательное - команда завершилась с ошибкой)
+	double measure(const Options& options) {
+		if (run(options.command) != 0) // Прогрев: кэш файловой системы и загрузчика
+			return -1;
+		const auto start = std::chrono::steady_clock::now();
+		for (unsigned i = 0; i < options.runs; ++i)
+			if (run(options.command) != 0)
+				return -1;
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / options.runs;
+	}
+
+	long fileSize(const std::string& path) {
+		std::FILE* file = std::fopen(path.c_str(), "rb");
+		if (file == nullptr)
+			return -1;
+		std::fseek(file, 0, SEEK_END);
+		const long size = std::ftell(file);
+		std::fclose(file);
+		return size;
+	}
+}
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!parse(argc, argv, options)) {
+		std::fprintf(stderr, "usage: %s size|startup|compile --name N [--runs R] [--budget B] [--csv F] -- <file or command>\n", argv[0]);
+		return 2;
+	}
+
+	double value;
+	const char* unit;
+	if (options.metric == "size") {
+		value = static_cast<double>(fileSize(options.command[0]));
+		unit = "bytes";
+	}
+	else if (options.metric == "startup") {
+		value = measure(options) * 1e6;
+		unit = "us";
+	}
+	else if (options.metric == "compile") {
+		value = measure(options) * 1e3;
+		unit = "ms";
+	}
+	else {
+		std::fprintf(stderr, "unknown metric: %s\n", options.metric.c_str());
+		return 2;
+	}
+
+	if (value < 0) {
+		std::fprintf(stderr, "BENCH %s: command failed: %s\n", options.name.c_str(), options.command[0].c_str());
+		return 1;
+	}
+
+	std::printf("BENCH %s %s=%.1f %s", options.name.c_str(), options.metric.c_str(), value, unit);
+	if (options.budget > 0)
+		std::printf(" (budget %.1f)", options.budget);
+	std::printf("\n");
+
+	if (!options.csv.empty()) {
+		if (std::FILE* csv = std::fopen(options.csv.c_str(), "a")) {
+			std::fprintf(csv, "%lld,%s,%s,%.1f,%s\n",
+				static_cast<long long>(std::chrono::duration_cast<std::chrono::seconds>(
+					std::chrono::system_clock::now().time_since_epoch()).count()),
+				options.name.c_str(), options.metric.c_str(), value, unit);
+			std::fclose(csv);
+		}
+	}
+
+	if (options.budget > 0 && value > options.budget) {
+		std::fprintf(stderr, "BENCH %s exceeds budget: %.1f > %.1f %s\n", options.name.c_str(), value, options.budget, unit);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,235 @@
+// Перекрытие передач DMA с работой процессора через асинхронный слой (DmaAsync) на симуляторе. Контроллер
+// работает параллельно с процессором: передачи память-память продвигаются вызовами step, по Burst элементов
+// на канал за раунд шины. Копируется Copies блоков по CopyBytes байт:
+//   blocking   - по одной передаче, процессор ожидает завершения опросом будущего (работы не выполняет);
+//   futures    - InFlight будущих одновременно (больше, чем каналов в пуле планировщика), завершение
+//                отмечается в продолжении из прерывания, главный цикл между раундами шины выполняет работу;
+//   coroutines - то же на сопрограммах: InFlight копирующих задач (co_await copy) и задача работы процессора
+//                на кооперативном исполнителе (только при сборке в режиме C++20).
+// Печатаются пропускная способность, количество раундов шины, выполненные процессором единицы работы и
+// максимальное количество передач в работе. Проверяется совпадение данных, освобождение кадров сопрограмм и то,
+// что асинхронные варианты укладываются в меньшее количество раундов шины, выполняя работу в каждом раунде
+#include <chrono>
+#include <cstring>
+#include "Bench.hpp"
+#include "DmaAsync.hpp"
+#include "SimDma.hpp"
+
+using namespace BasePeripheral;
+using namespace BasePeripheral::Dma;
+
+namespace {
+	constexpr address_t MemoryAddress = 0x20000000u;
+	constexpr uint32_t CopyBytes = 4096;
+	constexpr uint32_t CopyWords = CopyBytes / 4;
+	constexpr uint32_t InFlight = 32;
+	constexpr uint32_t Copies = InFlight * 64;
+	constexpr uint32_t Burst = 64;
+	constexpr uint32_t ChannelMask = 0x7F;
+	constexpr uint32_t WorkSize = 200; // Условная работа процессора за один раунд
+
+	typedef Sim::SimDma<7> Controller;
+
+	uint8_t memory[InFlight * 2 * CopyBytes];
+
+	uint64_t nowNs() {
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	// Единица работы процессора
+	void work() {
+		volatile uint32_t accumulator = 0;
+		for (uint32_t i = 0; i < WorkSize; ++i)
+			accumulator = accumulator + i;
+	}
+
+	// Адреса источника и приемника слота на шине
+	address_t source(uint32_t slot) { return MemoryAddress + slot * 2 * CopyBytes; }
+	address_t destination(uint32_t slot) { return source(slot) + CopyBytes; }
+
+	// Заполняет источник слота данными копии copy
+	void fill(uint32_t slot, uint32_t copy) {
+		uint8_t* data = memory + slot * 2 * CopyBytes;
+		for (uint32_t i = 0; i < CopyBytes; ++i)
+			data[i] = static_cast<uint8_t>(i * 7 + copy);
+	}
+
+	// Проверяет, что приемник слота совпадает с источником
+	bool verify(uint32_t slot) {
+		const uint8_t* data = memory + slot * 2 * CopyBytes;
+		return std::memcmp(data, data + CopyBytes, CopyBytes) == 0;
+	}
+
+	struct Result {
+		double seconds = 0;
+		uint32_t copies = 0;
+		uint32_t rounds = 0;
+		uint64_t work = 0;
+		uint32_t maxInFlight = 0;
+		uint32_t mismatches = 0;
+	};
+
+	// Контроллер, планировщик и асинхронный слой на общей шине
+	struct Rig {
+		Sim::SimBus bus;
+		Controller dma;
+		DmaScheduler<Controller> scheduler;
+		AsyncDma<Controller> async;
+
+		Rig() : scheduler(dma, ChannelMask), async(scheduler) {
+			bus.mapMemory(MemoryAddress, memory, sizeof(memory));
+			dma.init();
+			dma.connect(bus);
+			dma.setDeferredMemoryToMemory(true);
+		}
+
+		uint32_t inFlight() const { return scheduler.active() + scheduler.queued(); }
+	};
+
+	Result runBlocking() {
+		Rig rig;
+		Result result;
+		TransferFuture future;
+		const uint64_t start = nowNs();
+		for (uint32_t copy = 0; copy < Copies; ++copy) {
+			fill(0, copy);
+			CHECK(rig.async.start(future, destination(0), source(0), CopyWords, DataAlign::Word));
+			while (!future.ready()) {
+				rig.dma.step(Burst);
+				++result.rounds;
+			}
+			result.mismatches += verify(0) ? 0 : 1;
+			++result.copies;
+		}
+		result.seconds = (nowNs() - start) / 1e9;
+		result.maxInFlight = 1;
+		return result;
+	}
+
+	// Слот передачи: продолжение из прерывания только отмечает завершение, следующую передачу запускает главный цикл
+	struct Slot {
+		TransferFuture future;
+		bool done = false;
+
+		void onDone(TransferFuture&) { done = true; }
+	};
+
+	Result runFutures() {
+		Rig rig;
+		Result result;
+		Slot slots[InFlight];
+		uint32_t started = 0;
+		const auto launch = [&](uint32_t slot) {
+			fill(slot, started++);
+			slots[slot].done = false;
+			CHECK(rig.async.start(slots[slot].future, destination(slot), source(slot), CopyWords, DataAlign::Word));
+			slots[slot].future.then(FutureContinuation_t::bind<Slot, &Slot::onDone>(&slots[slot]));
+		};
+
+		const uint64_t start = nowNs();
+		for (uint32_t slot = 0; slot < InFlight; ++slot)
+			launch(slot);
+		while (result.copies < Copies) {
+			work();
+			++result.work;
+			for (uint32_t slot = 0; slot < InFlight; ++slot) {
+				if (!slots[slot].done || !slots[slot].future.ready())
+					continue;
+				result.mismatches += verify(slot) ? 0 : 1;
+				++result.copies;
+				if (started < Copies)
+					launch(slot);
+				else
+					slots[slot].done = false;
+			}
+			const uint32_t inFlight = rig.inFlight();
+			result.maxInFlight = inFlight > result.maxInFlight ? inFlight : result.maxInFlight;
+			if (inFlight != 0) {
+				rig.dma.step(Burst);
+				++result.rounds;
+			}
+		}
+		result.seconds = (nowNs() - start) / 1e9;
+		return result;
+	}
+
+#if BP_DMA_ASYNC_COROUTINES
+	Task copier(AsyncDma<Controller>& async, uint32_t slot, Result& result) {
+		for (uint32_t copy = slot; copy < Copies; copy += InFlight) {
+			fill(slot, copy);
+			co_await async.copy(destination(slot), source(slot), CopyWords, DataAlign::Word);
+			result.mismatches += verify(slot) ? 0 : 1;
+			++result.copies;
+		}
+	}
+
+	Task worker(Executor& executor, Result& result) {
+		while (result.copies < Copies) {
+			work();
+			++result.work;
+			co_await executor.yield();
+		}
+	}
+
+	Result runCoroutines() {
+		Rig rig;
+		Result result;
+		Executor executor;
+		for (uint32_t slot = 0; slot < InFlight; ++slot)
+			CHECK(executor.spawn(copier(rig.async, slot, result)));
+		CHECK(executor.spawn(worker(executor, result)));
+
+		const uint64_t start = nowNs();
+		while (executor.live() != 0) {
+			executor.runOnce();
+			const uint32_t inFlight = rig.inFlight();
+			result.maxInFlight = inFlight > result.maxInFlight ? inFlight : result.maxInFlight;
+			if (inFlight != 0) {
+				rig.dma.step(Burst);
+				++result.rounds;
+			}
+		}
+		result.seconds = (nowNs() - start) / 1e9;
+		CHECK(Detail::framePool.count() == 0);
+		CHECK(executor.overflows() == 0);
+		return result;
+	}
+#endif
+
+	void report(const char* mode, const Result& result) {
+		CHECK(result.copies == Copies);
+		CHECK(result.mismatches == 0);
+		char name[64];
+		std::snprintf(name, sizeof(name), "dma.async.%s", mode);
+		Bench::report(name, "throughput", static_cast<double>(result.copies) * CopyBytes / result.seconds / 1e6, "MB/s");
+		Bench::report(name, "bus_rounds", result.rounds, "count");
+		Bench::report(name, "cpu_work", static_cast<double>(result.work), "units");
+		Bench::report(name, "max_in_flight", result.maxInFlight, "requests");
+	}
+}
+
+int main(int argc, char** argv) {
+	Bench::init(argc, argv);
+
+	const Result blocking = runBlocking();
+	report("blocking", blocking);
+	CHECK(blocking.work == 0);
+
+	const Result futures = runFutures();
+	report("futures", futures);
+	CHECK(futures.rounds < blocking.rounds);
+	CHECK(futures.work >= futures.rounds);
+	CHECK(futures.maxInFlight == InFlight);
+
+#if BP_DMA_ASYNC_COROUTINES
+	const Result coroutines = runCoroutines();
+	report("coroutines", coroutines);
+	CHECK(coroutines.rounds < blocking.rounds);
+	CHECK(coroutines.work >= coroutines.rounds);
+	CHECK(coroutines.maxInFlight == InFlight);
+#else
+	std::printf("dma.async.coroutines: skipped (C++20 coroutines are not available)\n");
+#endif
+	return CHECK_RESULT();
+}
@@ -0,0 +1,139 @@
+// Планировщик передач DMA на симуляторе под нагрузкой: два канала пула, поток длинных запросов низкого
+// приоритета (1000 байт каждые 500 тактов) и редкие короткие запросы высокого приоритета (50 байт каждые
+// 2000 тактов) в устройство, принимающее один элемент за такт на канал. Время симулированное (SimClock),
+// поэтому результаты детерминированы. Для режимов с очередями и с вытеснением печатаются суммарная
+// пропускная способность, задержка запросов высокого приоритета от постановки до завершения (медиана,
+// 99-й процентиль, максимум), загрузка каналов и количество вытеснений.
+// Проверяется, что переданы все элементы и что вытеснение сокращает хвост задержки высокого приоритета
+#include <algorithm>
+#include <vector>
+#include "Bench.hpp"
+#include "DmaScheduler.hpp"
+#include "SimClock.hpp"
+#include "SimDma.hpp"
+
+using namespace BasePeripheral;
+using namespace BasePeripheral::Dma;
+
+namespace {
+	constexpr Sim::address_t MemoryAddress = 0x20000000u;
+	constexpr Sim::address_t DeviceAddress = 0x40000000u;
+	constexpr uint32_t LowCount = 200;
+	constexpr uint32_t LowItems = 1000;
+	constexpr tick_t LowPeriod = 500;
+	constexpr uint32_t HighCount = 50;
+	constexpr uint32_t HighItems = 50;
+	constexpr tick_t HighPeriod = 2000;
+	constexpr tick_t HighPhase = 7;
+	constexpr uint32_t ChannelMask = 0x3;
+
+	typedef Sim::SimDma<7> Controller;
+
+	struct Device {
+		uint64_t items = 0;
+		void write(Sim::address_t, uint32_t, uint32_t) { ++items; }
+	};
+
+	struct Environment {
+		Sim::SimClock clock;
+		uint32_t completed = 0;
+
+		tick_t now() { return clock.now(); }
+		void onComplete(TransferRequest&) { ++completed; }
+	};
+
+	struct Result {
+		uint64_t items = 0;
+		tick_t elapsed = 0;
+		tick_t p50 = 0;
+		tick_t p99 = 0;
+		tick_t max = 0;
+		double utilisation[2] = {};
+		uint32_t preemptions = 0;
+	};
+
+	void prepare(TransferRequest& request, uint32_t items, Priority priority, Environment& environment) {
+		request.descriptor = Descriptor(MemoryAddress, DeviceAddress, items, DataAlign::Byte,
+			IncrementMode::Increment, IncrementMode::NoIncrement);
+		request.direction = Direction::MemoryToPeriph;
+		request.priority = priority;
+		request.onComplete = TransferCallback_t::bind<Environment, &Environment::onComplete>(&environment);
+	}
+
+	Result run(bool preemptive) {
+		static uint8_t memory[LowItems];
+		Sim::SimBus bus;
+		Device device;
+		bus.mapMemory(MemoryAddress, memory, sizeof(memory));
+		bus.mapDevice(DeviceAddress, 4, Sim::BusReadHandler_t(), Sim::BusWriteHandler_t::bind<Device, &Device::write>(&device));
+
+		Controller dma;
+		dma.init();
+		dma.connect(bus);
+		Environment environment;
+		DmaScheduler<Controller> scheduler(dma, ChannelMask, preemptive,
+			TimeSource_t::bind<Environment, &Environment::now>(&environment));
+
+		std::vector<TransferRequest> lows(LowCount);
+		std::vector<TransferRequest> highs(HighCount);
+		uint32_t low = 0;
+		uint32_t high = 0;
+		for (tick_t tick = 0; environment.completed < LowCount + HighCount && tick < 10000000; ++tick) {
+			if (tick % LowPeriod == 0 && low < LowCount) {
+				prepare(lows[low], LowItems, Priority::Low, environment);
+				scheduler.submit(lows[low++]);
+			}
+			if (tick % HighPeriod == HighPhase && high < HighCount) {
+				prepare(highs[high], HighItems, Priority::VeryHigh, environment);
+				scheduler.submit(highs[high++]);
+			}
+			// Устройство принимает один элемент за такт на каждом канале пула
+			for (channel_number_t channel = 0; channel < 2; ++channel)
+				dma.serviceRequest(channel);
+			environment.clock.advance(1);
+		}
+
+		Result result;
+		result.items = device.items;
+		result.elapsed = environment.clock.now();
+		std::vector<tick_t> latencies;
+		for (const TransferRequest& request : highs)
+			latencies.push_back(request.completeTick - request.submitTick);
+		std::sort(latencies.begin(), latencies.end());
+		result.p50 = latencies[latencies.size() / 2];
+		result.p99 = latencies[latencies.size() * 99 / 100];
+		result.max = latencies.back();
+		for (channel_number_t channel = 0; channel < 2; ++channel) {
+			result.utilisation[channel] = scheduler.utilisation(channel, result.elapsed);
+			result.preemptions += scheduler.stats(channel).preemptions;
+		}
+		CHECK(environment.completed == LowCount + HighCount);
+		CHECK(result.items == static_cast<uint64_t>(LowCount) * LowItems + static_cast<uint64_t>(HighCount) * HighItems);
+		CHECK(scheduler.queued() == 0 && scheduler.active() == 0);
+		return result;
+	}
+
+	void report(const char* mode, const Result& result) {
+		char name[64];
+		std::snprintf(name, sizeof(name), "dma.scheduler.%s", mode);
+		Bench::report(name, "throughput", static_cast<double>(result.items) / result.elapsed, "items/tick");
+		Bench::report(name, "high_p50", static_cast<double>(result.p50), "ticks");
+		Bench::report(name, "high_p99", static_cast<double>(result.p99), "ticks");
+		Bench::report(name, "high_max", static_cast<double>(result.max), "ticks");
+		Bench::report(name, "utilisation_ch0", result.utilisation[0], "ratio");
+		Bench::report(name, "utilisation_ch1", result.utilisation[1], "ratio");
+		Bench::report(name, "preemptions", result.preemptions, "count");
+	}
+}
+
+int main(int argc, char** argv) {
+	Bench::init(argc, argv);
+	const Result queued = run(false);
+	const Result preemptive = run(true);
+	report("queued", queued);
+	report("preemptive", preemptive);
+	CHECK(queued.preemptions == 0);
+	CHECK(preemptive.preemptions > 0);
+	CHECK(preemptive.p99 < queued.p99);
+	return CHECK_RESULT();
+}
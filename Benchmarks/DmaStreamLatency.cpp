@@ -0,0 +1,135 @@
+// Поток данных поверх циклического канала DMA (CircularStream) на симуляторе. Как на микроконтроллере,
+// прерывание DMA и основной цикл выполняются на одном ядре: канал периферия-память читает регистр данных
+// устройства в буфер из двух половин порциями по ChunkItems элементов, после каждой порции основной цикл
+// забирает опубликованные половины без копирования и проверяет непрерывность данных.
+//   Штатная нагрузка: задержка от прерывания, опубликовавшего половину, до ее получения потребителем
+//   (медиана, 99-й процентиль, максимум) и пропускная способность; переполнений быть не должно.
+//   Перегрузка: потребитель опрашивает поток реже, чем заполняются две половины; каждая потерянная половина
+//   должна быть учтена в переполнениях ровно один раз
+#include <algorithm>
+#include <vector>
+#include "Bench.hpp"
+#include "DmaStream.hpp"
+#include "SimDma.hpp"
+
+using namespace BasePeripheral;
+using namespace BasePeripheral::Dma;
+
+namespace {
+	constexpr Sim::address_t DataRegister = 0x40013804u;
+	constexpr Sim::address_t BufferAddress = 0x20000000u;
+	constexpr channel_number_t Channel = 1;
+	constexpr uint32_t BufferItems = 256;
+	constexpr uint32_t ChunkItems = 32;
+	constexpr uint32_t Halves = 100000;
+	constexpr uint32_t StampsCount = 64; // Больше глубины очереди потока
+
+	typedef Sim::SimDma<7> Controller;
+	typedef CircularStream<Controller, uint16_t, BufferItems> Stream;
+
+	uint64_t nowNs() {
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	// Регистр данных устройства: каждое чтение возвращает следующее значение счетчика
+	struct Device {
+		uint32_t next = 0;
+		uint32_t read(Sim::address_t, uint32_t) { return next++ & 0xFFFFu; }
+	};
+
+	// Прерывание DMA: отметка времени публикации половины, затем штатная обработка событий канала
+	struct Interrupt {
+		Controller* dma = nullptr;
+		uint32_t halves = 0;
+		uint64_t stamps[StampsCount] = {};
+
+		void onInterrupt(channel_number_t channel, uint32_t flags) {
+			if ((flags & (Sim::DmaFlag::HTIF | Sim::DmaFlag::TCIF)) != 0)
+				stamps[halves++ % StampsCount] = nowNs();
+			dma->handleInterrupt(channel);
+		}
+	};
+
+	struct Result {
+		double seconds = 0;
+		uint32_t consumedHalves = 0;
+		uint32_t overruns = 0;
+		std::vector<uint64_t> latencies;
+	};
+
+	// pollItems - количество элементов, передаваемых DMA между опросами потока
+	Result run(uint32_t pollItems) {
+		static uint16_t buffer[BufferItems];
+		Sim::SimBus bus;
+		Device device;
+		bus.mapDevice(DataRegister, 4, Sim::BusReadHandler_t::bind<Device, &Device::read>(&device), Sim::BusWriteHandler_t());
+		bus.mapMemory(BufferAddress, buffer, sizeof(buffer));
+
+		Controller dma;
+		dma.init();
+		dma.connect(bus);
+		CHECK(dma.initChannel(Channel, Settings(Direction::PeriphToMemory, Mode::Circular, Priority::High,
+			MemorySettings(DataRegister, DataAlign::HalfWord, IncrementMode::NoIncrement),
+			MemorySettings(BufferAddress, DataAlign::HalfWord, IncrementMode::Increment))));
+		Interrupt interrupt;
+		interrupt.dma = &dma;
+		dma.setInterruptHandler(Sim::DmaInterruptHandler_t::bind<Interrupt, &Interrupt::onInterrupt>(&interrupt));
+
+		Stream stream(dma, Channel, buffer);
+		CHECK(stream.start());
+		dma.enableInterrupts(Channel, Sim::DmaCcr::TCIE | Sim::DmaCcr::HTIE);
+
+		Result result;
+		result.latencies.reserve(Halves);
+		uint32_t mismatches = 0;
+		uint64_t checksum = 0;
+		const uint64_t start = nowNs();
+		for (uint64_t produced = 0; produced < static_cast<uint64_t>(Halves) * Stream::HalfItems;) {
+			produced += dma.run(Channel, pollItems);
+			Stream::Span span;
+			while (stream.acquire(span)) {
+				result.latencies.push_back(nowNs() - interrupt.stamps[span.sequence % StampsCount]);
+				uint32_t bad = 0;
+				for (uint32_t i = 0; i < span.count; ++i) {
+					checksum += span.data[i];
+					bad += span.data[i] != ((span.sequence * Stream::HalfItems + i) & 0xFFFFu) ? 1 : 0;
+				}
+				if (stream.release(span)) {
+					mismatches += bad;
+					++result.consumedHalves;
+				}
+			}
+		}
+		result.seconds = (nowNs() - start) / 1e9;
+		Bench::keep(checksum);
+		result.overruns = stream.overruns();
+		stream.stop();
+		CHECK(mismatches == 0);
+		CHECK(stream.produced() == Halves);
+		CHECK(result.consumedHalves + result.overruns == Halves);
+		return result;
+	}
+}
+
+int main(int argc, char** argv) {
+	Bench::init(argc, argv);
+
+	Result steady = run(ChunkItems);
+	CHECK(steady.overruns == 0);
+	std::sort(steady.latencies.begin(), steady.latencies.end());
+	const size_t count = steady.latencies.size();
+	if (count != 0) {
+		Bench::report("dma.stream.latency", "p50", static_cast<double>(steady.latencies[count / 2]), "ns");
+		Bench::report("dma.stream.latency", "p99", static_cast<double>(steady.latencies[count * 99 / 100]), "ns");
+		Bench::report("dma.stream.latency", "max", static_cast<double>(steady.latencies.back()), "ns");
+	}
+	Bench::report("dma.stream.throughput", "consumed", steady.consumedHalves * Stream::HalfItems / steady.seconds / 1e6, "Mitems/s");
+
+	// Опрос через 2,5 половины: очередь из двух половин переполняется
+	const Result overload = run(Stream::HalfItems * 5 / 2);
+	CHECK(overload.overruns > 0);
+	Bench::report("dma.stream.overload", "overruns", overload.overruns, "halves");
+	Bench::report("dma.stream.overload", "consumed", overload.consumedHalves, "halves");
+	return CHECK_RESULT();
+}
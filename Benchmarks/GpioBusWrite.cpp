@@ -0,0 +1,64 @@
+// Пропускная способность записи слова на параллельную шину 8 и 16 бит: попиновый цикл setPin/resetPin
+// против одного вызова writePins (одна запись в BSRR) при виртуальной и статической диспетчеризации.
+// Проверяется, что оба способа оставляют на шине одно и то же слово
+#include "Bench.hpp"
+#include "RegisterPort.hpp"
+
+using namespace BasePeripheral;
+
+namespace {
+	constexpr uint32_t Words = 2000000;
+
+	template <typename Port>
+	BENCH_NOINLINE void writePerPin(Port& port, uint32_t width, uint32_t value) {
+		for (Gpio::pin_number_t pin = 0; pin < width; ++pin) {
+			if (((value >> pin) & 1u) != 0)
+				port.setPin(pin);
+			else
+				port.resetPin(pin);
+		}
+	}
+
+	template <typename Port>
+	BENCH_NOINLINE void writeMasked(Port& port, uint32_t width, uint32_t value) {
+		const typename Port::Mask mask((1u << width) - 1u);
+		port.writePins(mask, typename Port::Mask(value));
+	}
+
+	uint32_t pattern(uint32_t i) {
+		return i * 0x9E3779B1u >> 7;
+	}
+
+	// Возвращает пропускную способность, миллионов слов в секунду
+	template <typename Port, typename Write>
+	double measure(Port& port, uint32_t width, Write write) {
+		const double elapsed = Bench::seconds([&]() {
+			for (uint32_t i = 0; i < Words; ++i)
+				write(port, width, pattern(i));
+		});
+		const uint32_t busMask = (1u << width) - 1u;
+		CHECK((port.regs.ODR & busMask) == (pattern(Words - 1) & busMask));
+		return Words / elapsed / 1e6;
+	}
+
+	template <typename Port>
+	void run(const char* dispatch) {
+		for (uint32_t width : { 8u, 16u }) {
+			Port port;
+			port.init();
+			char name[64];
+			std::snprintf(name, sizeof(name), "gpio.bus_write.%s.w%u.per_pin", dispatch, static_cast<unsigned>(width));
+			Bench::report(name, "throughput", measure(port, width, writePerPin<Port>), "Mwords/s");
+			std::snprintf(name, sizeof(name), "gpio.bus_write.%s.w%u.write_pins", dispatch, static_cast<unsigned>(width));
+			Bench::report(name, "throughput", measure(port, width, writeMasked<Port>), "Mwords/s");
+			CHECK(port.errors == 0);
+		}
+	}
+}
+
+int main(int argc, char** argv) {
+	Bench::init(argc, argv);
+	run<Bench::VirtualRegisterPort<>>("virtual");
+	run<Bench::StaticRegisterPort<>>("static");
+	return CHECK_RESULT();
+}
@@ -0,0 +1,156 @@
+// Сжатие захвата логического анализатора (EdgeCompressor) на типичной нагрузке отладки протоколов: порт из 16 входов
+// опрашивается с частотой SampleRate, на входах ШИМ 1 кГц, UART 9600 бод (пакет из FrameBytes байт каждые
+// FramePeriodMs мс) и кнопка с дребезгом, остальные входы неподвижны. Выборки передаются компрессору половинами
+// циклического буфера по HalfSamples выборок, как из LogicCapture. Печатаются поток сырых выборок и записей
+// (байт в секунду), длительность захвата, помещающегося в RamBudget байт ОЗУ, без сжатия и со сжатием,
+// и пропускная способность компрессора (векторного поиска изменений и скалярного цикла для сравнения).
+// Проверяется совпадение записей со скалярным эталоном и утверждение "секунды вместо миллисекунд": без сжатия
+// в бюджет помещаются десятки миллисекунд, со сжатием - не меньше секунды
+#include <algorithm>
+#include <vector>
+#include "Bench.hpp"
+#include "GpioCapture.hpp"
+
+using namespace BasePeripheral::Gpio;
+
+namespace {
+	typedef uint16_t Sample;
+	typedef EdgeRecord<Sample> Record;
+
+	constexpr uint32_t SampleRate = 1000000; // Выборок в секунду
+	constexpr uint32_t Seconds = 2;
+	constexpr uint32_t Samples = SampleRate * Seconds;
+	constexpr uint32_t HalfSamples = 512;
+	constexpr uint32_t RamBudget = 64 * 1024;
+	constexpr uint32_t PwmPeriod = SampleRate / 1000;
+	constexpr uint32_t Baud = 9600;
+	constexpr uint32_t FrameBytes = 16;
+	constexpr uint32_t FramePeriodMs = 50;
+	constexpr Sample StaticLevels = 0xA500; // Неподвижные входы 8-15
+
+#if defined(BP_GPIO_CAPTURE_AVX2)
+	const char* const Isa = "avx2";
+#elif defined(BP_GPIO_CAPTURE_SSE2)
+	const char* const Isa = "sse2";
+#elif defined(BP_GPIO_CAPTURE_NEON)
+	const char* const Isa = "neon";
+#else
+	const char* const Isa = "scalar";
+#endif
+
+	// Уровень линии UART в момент t: пакеты из FrameBytes байт 8N1 в начале каждого периода, между ними - покой
+	bool uartLevel(uint32_t t) {
+		const uint64_t bit = static_cast<uint64_t>(t % (SampleRate / 1000 * FramePeriodMs)) * Baud / SampleRate;
+		if (bit >= FrameBytes * 10)
+			return true;
+		const uint32_t position = static_cast<uint32_t>(bit % 10);
+		if (position == 0)
+			return false; // Стартовый бит
+		if (position == 9)
+			return true;  // Стоповый бит
+		const uint32_t byte = static_cast<uint32_t>(bit / 10) * 37 + 0x55;
+		return ((byte >> (position - 1)) & 1u) != 0;
+	}
+
+	// Кнопка: нажатие в 0,5 с и отпускание в 1,5 с, каждое с пятью отскоками по 100 мкс
+	bool buttonLevel(uint32_t t) {
+		const uint32_t press = SampleRate / 2;
+		const uint32_t release = SampleRate * 3 / 2;
+		const uint32_t edge = t >= release ? release : press;
+		bool pressed = t >= press && t < release;
+		if (t >= edge && t - edge < 1000)
+			pressed ^= ((t - edge) / 100) % 2 == 1;
+		return !pressed;
+	}
+
+	Sample sampleAt(uint32_t t) {
+		Sample sample = StaticLevels;
+		sample |= t % PwmPeriod < PwmPeriod / 4 ? 0x01u : 0u;
+		sample |= uartLevel(t) ? 0x02u : 0u;
+		sample |= buttonLevel(t) ? 0x04u : 0u;
+		return sample;
+	}
+
+	// Скалярное сжатие для сравнения: каждая выборка сравнивается с предыдущей
+	struct ScalarCompressor {
+		Sample levels = 0;
+		uint32_t time = 0;
+		bool primed = false;
+
+		template <typename Sink>
+		BENCH_NOINLINE uint32_t process(const Sample* samples, size_t count, Sink&& sink) {
+			uint32_t records = 0;
+			for (size_t i = 0; i < count; ++i, ++time) {
+				if (!primed) {
+					levels = samples[i];
+					primed = true;
+					continue;
+				}
+				if (samples[i] != levels) {
+					sink(Record{ time, static_cast<Sample>(samples[i] ^ levels), samples[i] });
+					levels = samples[i];
+					++records;
+				}
+			}
+			return records;
+		}
+	};
+
+	bool sameRecord(const Record& a, const Record& b) {
+		return a.timestamp == b.timestamp && a.changed == b.changed && a.levels == b.levels;
+	}
+}
+
+int main(int argc, char** argv) {
+	Bench::init(argc, argv);
+
+	std::vector<Sample> samples(Samples);
+	for (uint32_t t = 0; t < Samples; ++t)
+		samples[t] = sampleAt(t);
+
+	std::vector<Record> records;
+	std::vector<Record> expected;
+	records.reserve(Samples / 16);
+	expected.reserve(Samples / 16);
+
+	EdgeCompressor<Sample> compressor;
+	compressor.reset();
+	const double vectorSeconds = Bench::seconds([&]() {
+		for (uint32_t offset = 0; offset < Samples; offset += HalfSamples)
+			compressor.process(samples.data() + offset, std::min(HalfSamples, Samples - offset),
+				[&](const Record& record) { records.push_back(record); });
+	});
+	ScalarCompressor scalar;
+	const double scalarSeconds = Bench::seconds([&]() {
+		for (uint32_t offset = 0; offset < Samples; offset += HalfSamples)
+			scalar.process(samples.data() + offset, std::min(HalfSamples, Samples - offset),
+				[&](const Record& record) { expected.push_back(record); });
+	});
+
+	CHECK(records.size() == expected.size());
+	uint32_t mismatches = 0;
+	for (size_t i = 0; i < records.size() && i < expected.size(); ++i)
+		mismatches += sameRecord(records[i], expected[i]) ? 0 : 1;
+	CHECK(mismatches == 0);
+	CHECK(compressor.records() == records.size());
+	CHECK(compressor.time() == Samples);
+
+	const double rawRate = static_cast<double>(SampleRate) * sizeof(Sample);
+	const double recordRate = static_cast<double>(records.size()) * sizeof(Record) / Seconds;
+	const double rawCapture = RamBudget / rawRate;
+	const double compressedCapture = RamBudget / recordRate;
+	Bench::report("gpio.capture.stream", "raw", rawRate, "bytes/s");
+	Bench::report("gpio.capture.stream", "compressed", recordRate, "bytes/s");
+	Bench::report("gpio.capture.stream", "edges", static_cast<double>(records.size()) / Seconds, "records/s");
+	Bench::report("gpio.capture.budget", "raw", rawCapture * 1e3, "ms");
+	Bench::report("gpio.capture.budget", "compressed", compressedCapture, "s");
+	// Секунды вместо миллисекунд
+	CHECK(rawCapture < 0.1);
+	CHECK(compressedCapture >= 1.0);
+
+	char name[64];
+	std::snprintf(name, sizeof(name), "gpio.capture.compress.%s", Isa);
+	Bench::report(name, "throughput", Samples / vectorSeconds / 1e6, "Msamples/s");
+	Bench::report("gpio.capture.compress.reference", "throughput", Samples / scalarSeconds / 1e6, "Msamples/s");
+	return CHECK_RESULT();
+}
@@ -0,0 +1,64 @@
+// Стоимость setPin при виртуальной (BaseGpio) и статической (StaticGpio) диспетчеризации на одинаковом
+// порту с регистрами в памяти: время вызова и результат (регистр BSRR). Функции Dispatch::* не встраиваются,
+// их код можно сравнить в листинге GpioDispatch.s (цель GpioDispatchAsm, компиляторы GCC и Clang):
+// виртуальный путь - проверка номера пина и косвенный вызов, статический - проверка и запись в BSRR,
+// setPin<Pin> - только запись в BSRR
+#include "Bench.hpp"
+#include "RegisterPort.hpp"
+
+using namespace BasePeripheral;
+
+namespace Dispatch {
+	typedef Bench::VirtualRegisterPort<> VirtualPort;
+	typedef Bench::StaticRegisterPort<> StaticPort;
+
+	BENCH_NOINLINE void virtualSetPin(Gpio::BaseGpio<16>& port, Gpio::pin_number_t pin) {
+		port.setPin(pin);
+	}
+
+	BENCH_NOINLINE void staticSetPin(StaticPort& port, Gpio::pin_number_t pin) {
+		port.setPin(pin);
+	}
+
+	BENCH_NOINLINE void staticSetPinConstant(StaticPort& port) {
+		port.setPin<3>();
+	}
+}
+
+namespace {
+	constexpr uint32_t Iterations = 20000000;
+}
+
+int main(int argc, char** argv) {
+	Bench::init(argc, argv);
+
+	Dispatch::VirtualPort virtualPort;
+	Dispatch::StaticPort staticPort;
+	Dispatch::StaticPort constantPort;
+	virtualPort.init();
+	staticPort.init();
+	constantPort.init();
+
+	const double virtualTime = Bench::nanosecondsPerCall(Iterations, [&](uint32_t i) {
+		Dispatch::virtualSetPin(virtualPort, static_cast<Gpio::pin_number_t>(i & 15));
+	});
+	const double staticTime = Bench::nanosecondsPerCall(Iterations, [&](uint32_t i) {
+		Dispatch::staticSetPin(staticPort, static_cast<Gpio::pin_number_t>(i & 15));
+	});
+	const double constantTime = Bench::nanosecondsPerCall(Iterations, [&](uint32_t) {
+		Dispatch::staticSetPinConstant(constantPort);
+	});
+
+	// Оба варианта выполняют одинаковые записи в регистры и одинаково обрабатывают ошибочный номер пина
+	CHECK(virtualPort.regs.BSRR == staticPort.regs.BSRR);
+	CHECK(virtualPort.regs.ODR == 0xFFFFu && staticPort.regs.ODR == 0xFFFFu);
+	CHECK(constantPort.regs.BSRR == (1u << 3));
+	Dispatch::virtualSetPin(virtualPort, 16);
+	Dispatch::staticSetPin(staticPort, 16);
+	CHECK(virtualPort.errors == 1 && staticPort.errors == 1);
+
+	Bench::report("gpio.set_pin.virtual", "latency", virtualTime, "ns");
+	Bench::report("gpio.set_pin.static", "latency", staticTime, "ns");
+	Bench::report("gpio.set_pin.static_constant", "latency", constantTime, "ns");
+	return CHECK_RESULT();
+}
@@ -0,0 +1,181 @@
+// Время в контексте прерывания при пачках фронтов на входах порта GPIO (дребезг кнопок, помехи) на симуляторе:
+// прямая обработка, при которой обработчик пина читает уровень и вызывает обработчик приложения на каждый фронт,
+// против конвейера событий (EventPipeline), который в прерывании только отмечает пин, а события с подавлением
+// дребезга передает приложению пакетами из главного цикла. В каждом раунде на PinsCount пинах чередуются пачки
+// из PressEdges фронтов (уровень меняется) и GlitchEdges фронтов (уровень возвращается), затем время продвигается
+// за пределы подавления дребезга и главный цикл обрабатывает события. Печатается время в прерывании на фронт
+// (и для сравнения - с пустым обработчиком, т.е. стоимость самого симулятора), время отложенной обработки,
+// количество вызовов обработчика приложения и счетчики объединенных и отброшенных фронтов.
+// Проверяется, что конвейер передает ровно одно событие на каждую пачку, изменившую уровень
+#include <chrono>
+#include "Bench.hpp"
+#include "GpioEventPipeline.hpp"
+#include "SimClock.hpp"
+#include "SimGpio.hpp"
+
+using namespace BasePeripheral;
+
+namespace {
+	constexpr Gpio::pin_number_t PinsCount = 4;
+	constexpr uint32_t Rounds = 20000;
+	constexpr uint32_t PressEdges = 9;  // Нечетное количество фронтов: уровень меняется
+	constexpr uint32_t GlitchEdges = 4; // Четное количество фронтов: уровень возвращается
+	constexpr Gpio::event_time_t Debounce = 50;
+	constexpr uint32_t HandlerWork = 64; // Условная работа обработчика приложения на одно событие
+
+	typedef Sim::SimGpio<16> Port;
+	typedef Gpio::EventPipeline<16> Pipeline;
+
+	uint64_t nowNs() {
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	// Обработчик приложения
+	struct Application {
+		volatile uint32_t state = 0;
+		uint32_t calls = 0;
+
+		void onEvent(Gpio::pin_number_t pin, bool level) {
+			++calls;
+			for (uint32_t i = 0; i < HandlerWork; ++i)
+				state = state + pin + (level ? 1 : 0);
+		}
+	};
+
+	// Прямая обработка в прерывании: уровень пина и обработчик приложения на каждый фронт
+	struct Direct {
+		Port* port = nullptr;
+		Application* application = nullptr;
+
+		void onInterrupt(Gpio::pin_number_t pin) { application->onEvent(pin, port->readPinInput(pin)); }
+	};
+
+	struct Empty {
+		void onInterrupt(Gpio::pin_number_t) {}
+	};
+
+	struct Result {
+		uint64_t edges = 0;
+		uint64_t isrNs = 0;
+		uint64_t deferredNs = 0;
+	};
+
+	uint32_t burstEdges(uint32_t round, Gpio::pin_number_t pin) {
+		return (round + pin) % 2 == 0 ? PressEdges : GlitchEdges;
+	}
+
+	// Прогон раундов. process(now) - обработка в главном цикле после установления уровней
+	template <typename Process>
+	Result run(Port& gpio, Sim::SimClock& clock, Process process) {
+		Result result;
+		bool levels[PinsCount] = {};
+		for (uint32_t round = 0; round < Rounds; ++round) {
+			// Фронты пачек разных пинов перемежаются, как при одновременном дребезге нескольких входов
+			const uint64_t start = nowNs();
+			for (uint32_t edge = 0; edge < PressEdges; ++edge) {
+				for (Gpio::pin_number_t pin = 0; pin < PinsCount; ++pin) {
+					if (edge >= burstEdges(round, pin))
+						continue;
+					levels[pin] = !levels[pin];
+					gpio.setInputLevel(pin, levels[pin]);
+					++result.edges;
+				}
+				clock.advance(1);
+			}
+			result.isrNs += nowNs() - start;
+
+			clock.advance(Debounce);
+			const uint64_t deferred = nowNs();
+			process(clock.now());
+			result.deferredNs += nowNs() - deferred;
+		}
+		return result;
+	}
+
+	void setup(Port& gpio) {
+		gpio.init();
+		for (Gpio::pin_number_t pin = 0; pin < PinsCount; ++pin) {
+			gpio.initPin(pin, Gpio::Settings().setMode(Gpio::Mode::Input));
+			gpio.configureInterrupt(pin, Sim::Edge::Both);
+		}
+	}
+
+	void report(const char* mode, const Result& result, uint32_t calls) {
+		char name[64];
+		std::snprintf(name, sizeof(name), "gpio.edge_burst.%s", mode);
+		Bench::report(name, "isr", static_cast<double>(result.isrNs) / result.edges, "ns/edge");
+		Bench::report(name, "handler_calls", calls, "count");
+	}
+}
+
+int main(int argc, char** argv) {
+	Bench::init(argc, argv);
+	const uint64_t expectedEdges = static_cast<uint64_t>(Rounds) * PinsCount / 2 * (PressEdges + GlitchEdges);
+	const uint32_t expectedEvents = Rounds * PinsCount / 2;
+
+	// Пустой обработчик: стоимость симуляции фронта и диспетчеризации прерывания
+	{
+		Port gpio;
+		setup(gpio);
+		Sim::SimClock clock;
+		Empty empty;
+		for (Gpio::pin_number_t pin = 0; pin < PinsCount; ++pin)
+			gpio.setPinInterruptHandler(pin, Gpio::PinInterruptHandler_t::bind<Empty, &Empty::onInterrupt>(&empty));
+		const Result result = run(gpio, clock, [](Gpio::event_time_t) {});
+		CHECK(result.edges == expectedEdges);
+		report("empty", result, 0);
+	}
+
+	// Прямая обработка: обработчик приложения на каждый фронт в прерывании
+	{
+		Port gpio;
+		setup(gpio);
+		Sim::SimClock clock;
+		Application application;
+		Direct direct;
+		direct.port = &gpio;
+		direct.application = &application;
+		for (Gpio::pin_number_t pin = 0; pin < PinsCount; ++pin)
+			gpio.setPinInterruptHandler(pin, Gpio::PinInterruptHandler_t::bind<Direct, &Direct::onInterrupt>(&direct));
+		const Result result = run(gpio, clock, [](Gpio::event_time_t) {});
+		CHECK(result.edges == expectedEdges);
+		CHECK(application.calls == expectedEdges);
+		report("direct", result, application.calls);
+	}
+
+	// Конвейер: в прерывании отметка пина, события с подавлением дребезга из главного цикла
+	{
+		Port gpio;
+		setup(gpio);
+		Sim::SimClock clock;
+		auto now = [&clock]() { return clock.now(); };
+		Pipeline pipeline(Gpio::EventClock_t::bind(now));
+		pipeline.reset(gpio.readPort());
+		for (Gpio::pin_number_t pin = 0; pin < PinsCount; ++pin) {
+			pipeline.setDebounce(pin, Debounce);
+			gpio.setPinInterruptHandler(pin, pipeline.handler());
+		}
+		Application application;
+		uint32_t settling = 0;
+		const Result result = run(gpio, clock, [&](Gpio::event_time_t time) {
+			pipeline.process(gpio.readPort(), time, [&](const Gpio::PinEvent& event) {
+				application.onEvent(event.pin, event.level);
+			});
+			settling += pipeline.pending() ? 1 : 0;
+		});
+		CHECK(result.edges == expectedEdges);
+		CHECK(settling == 0);
+		CHECK(pipeline.edges() == expectedEdges);
+		CHECK(pipeline.events() == expectedEvents);
+		CHECK(application.calls == expectedEvents);
+		CHECK(pipeline.coalesced() == expectedEvents * (PressEdges - 1));
+		CHECK(pipeline.dropped() == expectedEvents * GlitchEdges);
+		CHECK(pipeline.levels() == gpio.readPort());
+		report("pipeline", result, application.calls);
+		Bench::report("gpio.edge_burst.pipeline", "deferred", static_cast<double>(result.deferredNs) / result.edges, "ns/edge");
+		Bench::report("gpio.edge_burst.pipeline", "coalesced", pipeline.coalesced(), "edges");
+		Bench::report("gpio.edge_burst.pipeline", "dropped", pipeline.dropped(), "edges");
+	}
+	return CHECK_RESULT();
+}
@@ -0,0 +1,68 @@
+// Нагрузочный замер атомарных операций порта: 1..8 потоков одновременно переключают общий пин и свои пины,
+// устанавливают и сбрасывают пины и меняют режим своих пинов. Проверяется отсутствие потерянных обновлений
+// (итоговое состояние ODR и MODER), печатается производительность в миллионах операций в секунду
+#include <thread>
+#include <vector>
+#include "Bench.hpp"
+#include "SimGpio.hpp"
+
+using namespace BasePeripheral;
+
+namespace {
+	constexpr uint32_t Iterations = 200000;
+	constexpr uint32_t OperationsPerIteration = 5;
+	constexpr Gpio::pin_number_t SharedPin = 0;
+
+	typedef Sim::SimGpio<> Port;
+
+	// Один поток: общий пин переключается четное число раз (итог 0), свой пин - нечетное (итог 1),
+	// пин 9..15 устанавливается и сбрасывается (итог 0), режим своего пина меняется и в конце равен Output
+	void hammer(Port& gpio, uint32_t thread) {
+		const Gpio::pin_number_t own = static_cast<Gpio::pin_number_t>(1 + thread);
+		const Gpio::pin_number_t pulse = static_cast<Gpio::pin_number_t>(9 + thread % 7);
+		for (uint32_t i = 0; i < Iterations; ++i) {
+			gpio.togglePin(SharedPin);
+			gpio.togglePin(own);
+			gpio.setPin(pulse);
+			gpio.resetPin(pulse);
+			gpio.setMode(own, (i & 1) != 0 ? Gpio::Mode::Output : Gpio::Mode::Input);
+		}
+		gpio.togglePin(own);
+	}
+}
+
+int main(int argc, char** argv) {
+	Bench::init(argc, argv);
+
+	Port gpio;
+	gpio.init();
+	for (Gpio::pin_number_t pin = 0; pin <= Port::PinMaxNumber; ++pin)
+		gpio.initPin(pin, Gpio::Settings().setMode(Gpio::Mode::Output));
+
+	for (uint32_t threads : { 1u, 2u, 4u, 8u }) {
+		gpio.resetPins(Port::Mask::all());
+		const double elapsed = Bench::seconds([&]() {
+			std::vector<std::thread> pool;
+			for (uint32_t thread = 0; thread < threads; ++thread)
+				pool.emplace_back(hammer, std::ref(gpio), thread);
+			for (std::thread& worker : pool)
+				worker.join();
+		});
+
+		uint32_t expected = 0;
+		for (uint32_t thread = 0; thread < threads; ++thread)
+			expected |= 1u << (1 + thread);
+		const uint32_t odr = gpio.registers().ODR.load();
+		if ((odr & 0xFFFFu) != expected)
+			std::fprintf(stderr, "threads=%u: ODR=%04x, expected %04x\n", static_cast<unsigned>(threads),
+				static_cast<unsigned>(odr), static_cast<unsigned>(expected));
+		CHECK((odr & 0xFFFFu) == expected);
+		for (uint32_t thread = 0; thread < threads; ++thread)
+			CHECK(gpio.getMode(static_cast<Gpio::pin_number_t>(1 + thread)) == Gpio::Mode::Output);
+
+		char name[48];
+		std::snprintf(name, sizeof(name), "gpio.toggle_stress.t%u", static_cast<unsigned>(threads));
+		Bench::report(name, "throughput", threads * Iterations * OperationsPerIteration / elapsed / 1e6, "Mops/s");
+	}
+	return CHECK_RESULT();
+}
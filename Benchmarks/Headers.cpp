@@ -0,0 +1,41 @@
+// Единица трансляции для замера времени компиляции: все заголовки библиотеки
+#include "AdcKernels.hpp"
+#include "AdcStream.hpp"
+#include "BaseAdc.hpp"
+#include "BaseDma.hpp"
+#include "BaseGpio.hpp"
+#include "BitOps.hpp"
+#include "ControllerPeripheral.hpp"
+#include "Delegate.hpp"
+#include "DmaAsync.hpp"
+#include "DmaDescriptors.hpp"
+#include "DmaKernels.hpp"
+#include "DmaQueue.hpp"
+#include "DmaScheduler.hpp"
+#include "DmaStream.hpp"
+#include "ErrorPolicy.hpp"
+#include "GpioCapture.hpp"
+#include "GpioDescriptors.hpp"
+#include "GpioEventPipeline.hpp"
+#include "GpioWaveform.hpp"
+#include "PinInterruptTable.hpp"
+#include "PinMask.hpp"
+#include "SharedMacro.hpp"
+#include "SimAdc.hpp"
+#include "SimBus.hpp"
+#include "SimClock.hpp"
+#include "SimDma.hpp"
+#include "SimGpio.hpp"
+#include "StaticControllerPeripheral.hpp"
+#include "StaticDma.hpp"
+#include "StaticGpio.hpp"
+#include "Trace.hpp"
+#include "Transaction.hpp"
+
+#if BP_FREESTANDING && (defined(_GLIBCXX_FUNCTIONAL) || defined(_FUNCTIONAL_) || defined(_LIBCPP_FUNCTIONAL))
+#error "Freestanding profile must not depend on <functional>"
+#endif
+
+#if BP_FREESTANDING && (defined(_GLIBCXX_IOSTREAM) || defined(_IOSTREAM_) || defined(_LIBCPP_IOSTREAM))
+#error "Freestanding profile must not depend on <iostream>"
+#endif
@@ -0,0 +1,43 @@
+// Типичное приложение для замеров размера исполняемого файла и времени запуска: настройка порта и каналов
+// DMA, переключение профилей, внешний обработчик прерываний. Собирается в обоих профилях
+// (BP_FREESTANDING=0/1) из одного исходного текста
+#include "SimDma.hpp"
+#include "SimGpio.hpp"
+#include "Transaction.hpp"
+
+#if BP_FREESTANDING && (defined(_GLIBCXX_IOSTREAM) || defined(_IOSTREAM_) || defined(_LIBCPP_IOSTREAM))
+#error "Freestanding profile must not depend on <iostream>"
+#endif
+
+using namespace BasePeripheral;
+
+namespace {
+	uint32_t interrupts = 0;
+
+	void onInterrupt(Gpio::pin_number_t pin) {
+		interrupts += pin + 1;
+	}
+}
+
+int main() {
+	Sim::SimGpio<> gpio;
+	Sim::SimDma<> dma;
+	gpio.init();
+	dma.init();
+	gpio.setInterruptCallback(onInterrupt);
+
+	Gpio::PortTransaction<Sim::SimGpio<>> port(gpio);
+	for (Gpio::pin_number_t pin = 0; pin < 8; ++pin)
+		port.setMode(pin, Gpio::Mode::Output);
+	port.writePins(Gpio::PinMask<16>(0x00FFu), Gpio::PinMask<16>(0x00A5u));
+	port.commit();
+
+	Dma::ControllerTransaction<Sim::SimDma<>> channels(dma);
+	channels.initChannel(0, Dma::Settings(Dma::Direction::MemoryToPeriph, Dma::Mode::Circular, Dma::Priority::High,
+		Dma::MemorySettings(0x40020018u, Dma::DataAlign::Word), Dma::MemorySettings(0x20000000u, Dma::DataAlign::Word, Dma::IncrementMode::Increment)));
+	channels.setDataCount(0, 64);
+	channels.commit();
+
+	gpio.dispatchInterrupts(Gpio::PinMask<16>(0x0001u));
+	return gpio.readPortOutput().word(0) == 0x00A5u && dma.getDataCount(0) == 64 && interrupts == 1 ? 0 : 1;
+}
@@ -0,0 +1,163 @@
+#ifndef REGISTER_PORT_HPP_
+#define REGISTER_PORT_HPP_
+
+#include "BaseGpio.hpp"
+#include "StaticGpio.hpp"
+
+// Порт GPIO с регистрами в памяти (раскладка как у STM32: 2 бита на пин в MODER/OSPEEDR/PUPDR, 1 бит в OTYPER,
+// запись выходов через BSRR). Регистры volatile, поэтому каждое обращение выполняется, как к периферии.
+// Виртуальный и статический варианты используют одни и те же обращения к регистрам и отличаются только
+// диспетчеризацией обработчиков. Порты до 16 пинов (ширина BSRR)
+namespace Bench {
+	using namespace BasePeripheral;
+
+	struct PortRegisters {
+		volatile uint32_t MODER = 0;
+		volatile uint32_t OTYPER = 0;
+		volatile uint32_t OSPEEDR = 0;
+		volatile uint32_t PUPDR = 0;
+		volatile uint32_t IDR = 0;
+		volatile uint32_t ODR = 0;
+		volatile uint32_t BSRR = 0;
+
+		// Запись в BSRR и ее действие на ODR (в оборудовании выполняется самим портом)
+		void writeBsrr(uint32_t word) {
+			BSRR = word;
+			ODR = (ODR & ~(word >> 16)) | (word & 0xFFFFu);
+		}
+
+		void set(uint32_t mask) { writeBsrr(mask & 0xFFFFu); }
+		void reset(uint32_t mask) { writeBsrr((mask & 0xFFFFu) << 16); }
+		void write(uint32_t mask, uint32_t values) { writeBsrr((mask & values & 0xFFFFu) | ((mask & ~values & 0xFFFFu) << 16)); }
+		void toggle(uint32_t mask) { write(mask, ~ODR); }
+
+		static void setField(volatile uint32_t& reg, Gpio::pin_number_t pin, uint32_t bits, uint32_t value) {
+			const uint32_t shift = pin * bits;
+			const uint32_t mask = ((1u << bits) - 1u) << shift;
+			reg = (reg & ~mask) | ((value << shift) & mask);
+		}
+
+		static uint32_t getField(const volatile uint32_t& reg, Gpio::pin_number_t pin, uint32_t bits) {
+			return (reg >> (pin * bits)) & ((1u << bits) - 1u);
+		}
+
+		void setMode(Gpio::pin_number_t pin, Gpio::Mode mode) { setField(MODER, pin, 2, static_cast<uint32_t>(mode)); }
+		void setPull(Gpio::pin_number_t pin, Gpio::Pull pull) { setField(PUPDR, pin, 2, static_cast<uint32_t>(pull)); }
+		void setOutputType(Gpio::pin_number_t pin, Gpio::OutputType type) { setField(OTYPER, pin, 1, static_cast<uint32_t>(type)); }
+		void setOutputSpeed(Gpio::pin_number_t pin, Gpio::OutputSpeed speed) { setField(OSPEEDR, pin, 2, static_cast<uint32_t>(speed)); }
+
+		Gpio::Mode getMode(Gpio::pin_number_t pin) const { return static_cast<Gpio::Mode>(getField(MODER, pin, 2)); }
+		Gpio::Pull getPull(Gpio::pin_number_t pin) const { return static_cast<Gpio::Pull>(getField(PUPDR, pin, 2)); }
+		Gpio::OutputType getOutputType(Gpio::pin_number_t pin) const { return static_cast<Gpio::OutputType>(getField(OTYPER, pin, 1)); }
+		Gpio::OutputSpeed getOutputSpeed(Gpio::pin_number_t pin) const { return static_cast<Gpio::OutputSpeed>(getField(OSPEEDR, pin, 2)); }
+
+		void setSettings(Gpio::pin_number_t pin, const Gpio::Settings& settings) {
+			setMode(pin, settings.getMode());
+			setPull(pin, settings.getPull());
+			setOutputType(pin, settings.getOutputType());
+			setOutputSpeed(pin, settings.getOutputSpeed());
+		}
+
+		Gpio::Settings getSettings(Gpio::pin_number_t pin) const {
+			return Gpio::Settings(getMode(pin), getPull(pin), getOutputType(pin), getOutputSpeed(pin));
+		}
+	};
+
+	// Вариант с виртуальной диспетчеризацией (BaseGpio). GroupWrites - групповые операции одной записью в BSRR
+	// (иначе реализации BaseGpio по умолчанию, попиново)
+	template <uint32_t IOCount = 16, bool ShadowCache = false, bool GroupWrites = true>
+	class VirtualRegisterPort : public Gpio::BaseGpio<IOCount, ShadowCache> {
+		static_assert(IOCount <= 16, "Register port supports up to 16 pins");
+		typedef Gpio::BaseGpio<IOCount, ShadowCache> Base;
+
+	public:
+		typedef typename Base::Mask Mask;
+
+		bool isEnabled() const override { return true; }
+
+		PortRegisters regs;
+		uint32_t errors = 0;
+
+	protected:
+		void onEnableClock() override {}
+		void onDisableClock() override {}
+		void onError(error_t) override { ++errors; }
+		bool onSetSettings(Gpio::pin_number_t pin, const Gpio::Settings& settings) override { regs.setSettings(pin, settings); return true; }
+		Gpio::Settings onGetSettings(Gpio::pin_number_t pin) const override { return regs.getSettings(pin); }
+		bool onUpdateSettings(Gpio::pin_number_t pin, const Gpio::Settings& settings) override { regs.setSettings(pin, settings); return true; }
+		void onSetPin(Gpio::pin_number_t pin) override { regs.set(1u << pin); }
+		void onResetPin(Gpio::pin_number_t pin) override { regs.reset(1u << pin); }
+		void onSetPull(Gpio::pin_number_t pin, Gpio::Pull pull) override { regs.setPull(pin, pull); }
+		void onSetMode(Gpio::pin_number_t pin, Gpio::Mode mode) override { regs.setMode(pin, mode); }
+		void onSetOutputType(Gpio::pin_number_t pin, Gpio::OutputType type) override { regs.setOutputType(pin, type); }
+		void onSetOutputSpeed(Gpio::pin_number_t pin, Gpio::OutputSpeed speed) override { regs.setOutputSpeed(pin, speed); }
+		bool onGetPinOutput(Gpio::pin_number_t pin) override { return ((regs.ODR >> pin) & 1u) != 0; }
+		bool onGetPinInput(Gpio::pin_number_t pin) override { return ((regs.IDR >> pin) & 1u) != 0; }
+		Gpio::Mode onGetMode(Gpio::pin_number_t pin) const override { return regs.getMode(pin); }
+		Gpio::Pull onGetPull(Gpio::pin_number_t pin) const override { return regs.getPull(pin); }
+		Gpio::OutputType onGetOutputType(Gpio::pin_number_t pin) const override { return regs.getOutputType(pin); }
+		Gpio::OutputSpeed onGetOutputSpeed(Gpio::pin_number_t pin) const override { return regs.getOutputSpeed(pin); }
+		bool validatePortAddr(uint32_t) const override { return true; }
+
+		void onWritePins(const Mask& mask, const Mask& values) override {
+			if (GroupWrites)
+				regs.write(mask.word(0), values.word(0));
+			else
+				Base::onWritePins(mask, values);
+		}
+
+		void onTogglePins(const Mask& mask) override {
+			if (GroupWrites)
+				regs.toggle(mask.word(0));
+			else
+				Base::onTogglePins(mask);
+		}
+
+		void onTogglePin(Gpio::pin_number_t pin) override { regs.toggle(1u << pin); }
+		Mask onReadPortInput() override { return Mask(regs.IDR); }
+		Mask onReadPortOutput() override { return Mask(regs.ODR); }
+	};
+
+	// Вариант со статической диспетчеризацией (StaticGpio)
+	template <uint32_t IOCount = 16>
+	class StaticRegisterPort : public Gpio::StaticGpio<StaticRegisterPort<IOCount>, IOCount> {
+		static_assert(IOCount <= 16, "Register port supports up to 16 pins");
+		typedef Gpio::StaticGpio<StaticRegisterPort<IOCount>, IOCount> Base;
+		friend Base;
+
+	public:
+		typedef typename Base::Mask Mask;
+
+		bool isEnabled() const { return true; }
+
+		PortRegisters regs;
+		uint32_t errors = 0;
+
+	private:
+		void onEnableClock() {}
+		void onDisableClock() {}
+		void onError(error_t) { ++errors; }
+		bool onSetSettings(Gpio::pin_number_t pin, const Gpio::Settings& settings) { regs.setSettings(pin, settings); return true; }
+		Gpio::Settings onGetSettings(Gpio::pin_number_t pin) const { return regs.getSettings(pin); }
+		bool onUpdateSettings(Gpio::pin_number_t pin, const Gpio::Settings& settings) { regs.setSettings(pin, settings); return true; }
+		void onSetPin(Gpio::pin_number_t pin) { regs.set(1u << pin); }
+		void onResetPin(Gpio::pin_number_t pin) { regs.reset(1u << pin); }
+		void onSetPull(Gpio::pin_number_t pin, Gpio::Pull pull) { regs.setPull(pin, pull); }
+		void onSetMode(Gpio::pin_number_t pin, Gpio::Mode mode) { regs.setMode(pin, mode); }
+		void onSetOutputType(Gpio::pin_number_t pin, Gpio::OutputType type) { regs.setOutputType(pin, type); }
+		void onSetOutputSpeed(Gpio::pin_number_t pin, Gpio::OutputSpeed speed) { regs.setOutputSpeed(pin, speed); }
+		bool onGetPinOutput(Gpio::pin_number_t pin) { return ((regs.ODR >> pin) & 1u) != 0; }
+		bool onGetPinInput(Gpio::pin_number_t pin) { return ((regs.IDR >> pin) & 1u) != 0; }
+		Gpio::Mode onGetMode(Gpio::pin_number_t pin) const { return regs.getMode(pin); }
+		Gpio::Pull onGetPull(Gpio::pin_number_t pin) const { return regs.getPull(pin); }
+		Gpio::OutputType onGetOutputType(Gpio::pin_number_t pin) const { return regs.getOutputType(pin); }
+		Gpio::OutputSpeed onGetOutputSpeed(Gpio::pin_number_t pin) const { return regs.getOutputSpeed(pin); }
+		void onWritePins(const Mask& mask, const Mask& values) { regs.write(mask.word(0), values.word(0)); }
+		void onTogglePins(const Mask& mask) { regs.toggle(mask.word(0)); }
+		void onTogglePin(Gpio::pin_number_t pin) { regs.toggle(1u << pin); }
+		Mask onReadPortInput() { return Mask(regs.IDR); }
+		Mask onReadPortOutput() { return Mask(regs.ODR); }
+	};
+}
+
+#endif
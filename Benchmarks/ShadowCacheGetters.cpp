@@ -0,0 +1,112 @@
+// Задержка геттеров настроек GPIO и DMA с теневой таблицей (ShadowCache) и без нее на симуляторах:
+// без таблицы геттер обращается к наследнику, который читает и декодирует регистры, с таблицей - читает
+// упакованную запись в ОЗУ. Регистры симулятора находятся в ОЗУ, поэтому кроме времени печатается количество
+// обращений к обработчикам чтения регистров наследника на вызов (на реальной периферии каждое обращение
+// добавляет такты ожидания шины). Проверяется, что оба варианта возвращают одинаковые настройки и что
+// с таблицей обработчики чтения не вызываются
+#include "Bench.hpp"
+#include "SimDma.hpp"
+#include "SimGpio.hpp"
+
+using namespace BasePeripheral;
+
+namespace {
+	constexpr uint32_t Iterations = 5000000;
+
+	const Gpio::Settings PinSettings[] = {
+		Gpio::Settings(Gpio::Mode::Output, Gpio::Pull::PullUp, Gpio::OutputType::OpenDrain, Gpio::OutputSpeed::High),
+		Gpio::Settings(Gpio::Mode::AlternateFunction, Gpio::Pull::PullDown, Gpio::OutputType::PushPull, Gpio::OutputSpeed::VeryHigh),
+	};
+
+	// Симуляторы, считающие обращения к обработчикам чтения настроек
+	template <bool ShadowCache>
+	class CountingGpio : public Sim::SimGpio<16, ShadowCache> {
+		typedef Sim::SimGpio<16, ShadowCache> Base;
+
+	public:
+		mutable uint64_t reads = 0;
+
+	protected:
+		Gpio::Mode onGetMode(Gpio::pin_number_t pin) const override { ++reads; return Base::onGetMode(pin); }
+		Gpio::Pull onGetPull(Gpio::pin_number_t pin) const override { ++reads; return Base::onGetPull(pin); }
+		Gpio::OutputType onGetOutputType(Gpio::pin_number_t pin) const override { ++reads; return Base::onGetOutputType(pin); }
+		Gpio::OutputSpeed onGetOutputSpeed(Gpio::pin_number_t pin) const override { ++reads; return Base::onGetOutputSpeed(pin); }
+	};
+
+	template <bool ShadowCache>
+	class CountingDma : public Sim::SimDma<7, ShadowCache> {
+		typedef Sim::SimDma<7, ShadowCache> Base;
+
+	public:
+		mutable uint64_t reads = 0;
+
+	protected:
+		Dma::Settings onGetSettings(Dma::channel_number_t channel) const override { ++reads; return Base::onGetSettings(channel); }
+	};
+
+	// Замеряет задержку вызова и количество обращений к обработчикам чтения на вызов
+	template <typename Controller, typename Getter>
+	void measure(const char* name, const char* variant, const Controller& controller, Getter getter) {
+		const uint64_t reads = controller.reads;
+		const double latency = Bench::nanosecondsPerCall(Iterations, getter);
+		const double readsPerCall = static_cast<double>(controller.reads - reads) / Iterations;
+		char metric[64];
+		std::snprintf(metric, sizeof(metric), "%s.%s", name, variant);
+		Bench::report(metric, "latency", latency, "ns");
+		Bench::report(metric, "hardware_reads", readsPerCall, "per_call");
+		if (std::strcmp(variant, "shadow") == 0)
+			CHECK(readsPerCall == 0);
+	}
+
+	template <bool ShadowCache>
+	void runGpio(const char* variant) {
+		CountingGpio<ShadowCache> gpio;
+		gpio.init();
+		for (Gpio::pin_number_t pin = 0; pin < 16; ++pin)
+			gpio.initPin(pin, PinSettings[pin & 1]);
+		const Gpio::BaseGpio<16, ShadowCache>& port = gpio;
+		for (Gpio::pin_number_t pin = 0; pin < 16; ++pin) {
+			CHECK(port.getSettings(pin) == PinSettings[pin & 1]);
+			CHECK(port.getMode(pin) == PinSettings[pin & 1].getMode());
+		}
+
+		measure("gpio.get_settings", variant, gpio, [&](uint32_t i) {
+			Bench::keep(port.getSettings(static_cast<Gpio::pin_number_t>(i & 15)));
+		});
+		measure("gpio.get_mode", variant, gpio, [&](uint32_t i) {
+			Bench::keep(port.getMode(static_cast<Gpio::pin_number_t>(i & 15)));
+		});
+	}
+
+	template <bool ShadowCache>
+	void runDma(const char* variant) {
+		const Dma::Settings settings(Dma::Direction::PeriphToMemory, Dma::Mode::Circular, Dma::Priority::High,
+			Dma::MemorySettings(0x40013804u, Dma::DataAlign::HalfWord, Dma::IncrementMode::NoIncrement),
+			Dma::MemorySettings(0x20000000u, Dma::DataAlign::HalfWord, Dma::IncrementMode::Increment));
+		CountingDma<ShadowCache> controller;
+		controller.init();
+		for (Dma::channel_number_t channel = 0; channel < 7; ++channel)
+			controller.initChannel(channel, settings);
+		const Dma::BaseDma<7, ShadowCache>& dma = controller;
+		for (Dma::channel_number_t channel = 0; channel < 7; ++channel) {
+			CHECK(dma.getSettings(channel) == settings);
+			CHECK(dma.getPriority(channel) == Dma::Priority::High);
+		}
+
+		measure("dma.get_settings", variant, controller, [&](uint32_t i) {
+			Bench::keep(dma.getSettings(static_cast<Dma::channel_number_t>(i % 7)));
+		});
+		measure("dma.get_priority", variant, controller, [&](uint32_t i) {
+			Bench::keep(dma.getPriority(static_cast<Dma::channel_number_t>(i % 7)));
+		});
+	}
+}
+
+int main(int argc, char** argv) {
+	Bench::init(argc, argv);
+	runGpio<false>("hardware");
+	runGpio<true>("shadow");
+	runDma<false>("hardware");
+	runDma<true>("shadow");
+	return CHECK_RESULT();
+}
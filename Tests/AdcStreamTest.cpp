@@ -0,0 +1,162 @@
+// Непрерывное сканирование АЦП с передачей блоков через циклический канал DMA (ScanStream) на симуляторе:
+// SimAdc запрашивает обслуживание канала SimDma после каждого преобразования, канал забирает DR через SimBus.
+// Значение на входе канала кодирует номер канала и номер кадра, поэтому по каждому результату блока проверяется,
+// что он получен от канала своей позиции в последовательности и в своем кадре. Проверяются порядок блоков
+// (последовательные номера, чередование половин буфера при многократном обороте), преобразования порциями,
+// не кратными кадру, учет переполнений при редком опросе (перезаписываемые блоки не передаются) и продолжение
+// потока после них, отказ запуска при длине последовательности, отличной от Channels, и остановка
+#include "AdcStream.hpp"
+#include "Check.hpp"
+#include "SimAdc.hpp"
+#include "SimDma.hpp"
+
+using namespace BasePeripheral;
+using namespace BasePeripheral::Adc;
+
+namespace {
+	constexpr Sim::address_t AdcAddress = 0x40012000u;
+	constexpr Sim::address_t BufferAddress = 0x20000000u;
+	constexpr Dma::channel_number_t DmaChannel = 4;
+	constexpr uint32_t Channels = 4;
+	constexpr uint32_t BlockFrames = 8;
+	constexpr channel_number_t Sequence[Channels] = { 5, 0, 12, 3 };
+
+	typedef Sim::SimDma<7> Controller;
+	typedef Sim::SimAdc<> Converter;
+	typedef ScanStream<Converter, Controller, Channels, BlockFrames> Stream;
+
+	// Источник сигнала: номер канала в старших битах, номер преобразования канала (кадра) - в младших
+	struct Source {
+		uint32_t frames[19] = {};
+
+		uint32_t read(channel_number_t channel) { return (channel << 8) | (frames[channel]++ & 0xFFu); }
+
+		static sample_t expected(uint32_t index, uint32_t frame) {
+			return static_cast<sample_t>((Sequence[index] << 8) | (frame & 0xFFu));
+		}
+	};
+
+	class Rig {
+	public:
+		Rig() : stream(adc, dma, DmaChannel, buffer, BufferAddress) {
+			bus.mapMemory(BufferAddress, buffer, sizeof(buffer));
+			dma.init();
+			dma.connect(bus);
+			adc.init();
+			adc.attach(bus, AdcAddress);
+			adc.setSource(Sim::AnalogSource_t::bind<Source, &Source::read>(&source));
+			adc.connectDma(Sim::DmaRequest_t::bind<Controller, &Controller::serviceRequest>(&dma), DmaChannel);
+		}
+
+		// Выполняет frames кадров преобразований порциями по chunk преобразований, опрашивая поток после каждой
+		// порции, если poll. Проверяет номер и данные каждого полученного блока. Возвращает количество блоков
+		uint32_t run(uint32_t frames, uint32_t chunk, bool poll) {
+			uint32_t blocks = 0;
+			for (uint32_t done = 0; done < frames * Channels;) {
+				const uint32_t count = chunk < frames * Channels - done ? chunk : frames * Channels - done;
+				adc.run(count);
+				done += count;
+				if (poll)
+					blocks += this->poll();
+			}
+			return blocks;
+		}
+
+		uint32_t poll() {
+			return stream.poll([&](const Stream::Block& block) {
+				if (block.sequence != nextBlock && mismatches++ == 0)
+					std::fprintf(stderr, "block %u, expected %u\n", static_cast<unsigned>(block.sequence),
+						static_cast<unsigned>(nextBlock));
+				// Блоки чередуются между половинами буфера
+				const sample_t* half = buffer + (block.sequence % 2) * Stream::BlockSamples;
+				mismatches += block.data != half ? 1 : 0;
+				for (uint32_t frame = 0; frame < Stream::Block::frames(); ++frame) {
+					for (uint32_t index = 0; index < Stream::Block::channels(); ++index) {
+						const sample_t sample = block.at(frame, index);
+						const sample_t expected = Source::expected(index, block.sequence * BlockFrames + frame);
+						if (sample != expected && mismatches++ == 0)
+							std::fprintf(stderr, "block %u, frame %u, index %u: %03x, expected %03x\n",
+								static_cast<unsigned>(block.sequence), static_cast<unsigned>(frame),
+								static_cast<unsigned>(index), static_cast<unsigned>(sample), static_cast<unsigned>(expected));
+					}
+				}
+				nextBlock = block.sequence + 1;
+			});
+		}
+
+		Sim::SimBus bus;
+		Controller dma;
+		Converter adc;
+		Source source;
+		sample_t buffer[Stream::BufferSamples] = {};
+		Stream stream;
+		uint32_t nextBlock = 0;
+		uint32_t mismatches = 0;
+	};
+
+	// Штатная работа: много оборотов буфера, опрос после каждой порции из 7 преобразований
+	void checkSteady() {
+		Rig rig;
+		CHECK(rig.adc.setSequence(Sequence, Channels));
+		CHECK(rig.stream.start());
+		CHECK(rig.adc.isRunning());
+		constexpr uint32_t Blocks = 20;
+		CHECK(rig.run(Blocks * BlockFrames, 7, true) == Blocks);
+		CHECK(rig.mismatches == 0);
+		CHECK(rig.stream.produced() == Blocks);
+		CHECK(rig.stream.overruns() == 0);
+		CHECK(rig.stream.errors() == 0);
+		CHECK(rig.adc.conversions() == Blocks * Stream::BlockSamples);
+		CHECK((rig.adc.registers().SR & Sim::AdcBits::SR_OVR) == 0); // DMA забирает каждый результат
+
+		// Частично заполненный блок не передается; после остановки преобразования не выполняются
+		rig.run(BlockFrames / 2, Channels, true);
+		CHECK(rig.poll() == 0);
+		rig.stream.stop();
+		CHECK(!rig.adc.isRunning());
+		CHECK(rig.adc.run(Channels) == 0);
+		CHECK(rig.dma.errorCount() == 0);
+	}
+
+	// Редкий опрос: за два блока без опроса теряется старший из них (DMA перешел к его половине),
+	// за три - все три (третий не помещается в очередь, два других перезаписываются)
+	void checkOverruns() {
+		Rig rig;
+		CHECK(rig.adc.setSequence(Sequence, Channels));
+		CHECK(rig.stream.start());
+		CHECK(rig.run(3 * BlockFrames, Channels, true) == 3);
+
+		rig.run(2 * BlockFrames, Channels, false);
+		rig.nextBlock = 4;
+		CHECK(rig.poll() == 1);
+		CHECK(rig.stream.overruns() == 1);
+
+		rig.run(3 * BlockFrames, Channels, false);
+		CHECK(rig.poll() == 0);
+		CHECK(rig.stream.overruns() == 4);
+
+		// Поток продолжается со следующего блока, данные которого соответствуют его номеру
+		rig.nextBlock = 8;
+		CHECK(rig.run(4 * BlockFrames, 5, true) == 4);
+		CHECK(rig.nextBlock == 12);
+		CHECK(rig.mismatches == 0);
+		CHECK(rig.stream.produced() == 12);
+		CHECK(rig.stream.overruns() == 4);
+		rig.stream.stop();
+	}
+
+	// Запуск с последовательностью другой длины отвергается
+	void checkSequenceLength() {
+		Rig rig;
+		CHECK(rig.adc.setSequence(Sequence, Channels - 1));
+		CHECK(!rig.stream.start());
+		CHECK(!rig.adc.isRunning());
+	}
+}
+
+int main() {
+	checkSteady();
+	checkOverruns();
+	checkSequenceLength();
+	return CHECK_RESULT();
+}
@@ -0,0 +1,91 @@
+// Обработчики передаются в API обратного вызова одинаково в обоих профилях сборки (BP_FREESTANDING=0/1):
+// лямбда без захвата, свободная функция, метод объекта и лямбда с захватом через Delegate::bind.
+// Собирается и выполняется в обычном профиле и в профиле без среды выполнения
+#include "Check.hpp"
+#include "ErrorPolicy.hpp"
+#include "GpioEventPipeline.hpp"
+#include "SimDma.hpp"
+#include "SimGpio.hpp"
+
+using namespace BasePeripheral;
+
+namespace {
+	uint32_t externalCalls = 0;
+
+	void onExternal(Gpio::pin_number_t) {
+		++externalCalls;
+	}
+
+	struct Counter {
+		uint32_t calls = 0;
+		void onPin(Gpio::pin_number_t) { ++calls; }
+	};
+}
+
+int main() {
+	Sim::SimGpio<> gpio;
+	gpio.init();
+
+	// Внешний обработчик прерываний: лямбда без захвата, свободная функция, лямбда с захватом
+	// (через делегат: в профиле без среды выполнения обработчик не владеет захваченным состоянием)
+	static uint32_t lambdaCalls = 0;
+	gpio.setInterruptCallback([](Gpio::pin_number_t) { ++lambdaCalls; });
+	gpio.dispatchInterrupts(Gpio::PinMask<16>(0x0003u));
+	CHECK(lambdaCalls == 2);
+
+	gpio.setInterruptCallback(onExternal);
+	gpio.dispatchInterrupts(Gpio::PinMask<16>(0x0001u));
+	CHECK(externalCalls == 1);
+
+	uint32_t captured = 0;
+	auto capturing = [&captured](Gpio::pin_number_t pin) { captured += pin; };
+	gpio.setInterruptCallback(Gpio::PinInterruptHandler_t::bind(capturing));
+	gpio.dispatchInterrupts(Gpio::PinMask<16>(0x0010u));
+	CHECK(captured == 4);
+	gpio.clearInterruptCallback();
+
+	// Обработчики пинов: лямбда без захвата и метод объекта
+	static uint32_t pinCalls = 0;
+	CHECK(gpio.setPinInterruptHandler(5, [](Gpio::pin_number_t) { ++pinCalls; }));
+	Counter counter;
+	CHECK(gpio.setPinInterruptHandler(6, Gpio::PinInterruptHandler_t::bind<Counter, &Counter::onPin>(&counter)));
+	gpio.dispatchInterrupts(Gpio::PinMask<16>(0x0060u));
+	CHECK(pinCalls == 1);
+	CHECK(counter.calls == 1);
+
+	// Обработчики DMA: событие канала и завершение цепочки
+	uint8_t src[16] = { 1, 2, 3, 4 };
+	uint8_t dst[16] = {};
+	Sim::SimBus bus;
+	bus.mapMemory(0x20000000u, src, sizeof(src));
+	bus.mapMemory(0x20001000u, dst, sizeof(dst));
+	Sim::SimDma<> dma;
+	dma.init();
+	dma.connect(bus);
+	dma.initChannel(0, Dma::Settings(Dma::Direction::MemoryToMemory));
+	static uint32_t channelEvents = 0;
+	static uint32_t chainsDone = 0;
+	dma.setEventHandler(0, [](Dma::channel_number_t, uint32_t events) {
+		if ((events & Dma::Event::TransferComplete) != 0)
+			++channelEvents;
+	});
+	static const Dma::Descriptor node(0x20000000u, 0x20001000u, 16);
+	CHECK(dma.submitChain(0, &node, [](Dma::channel_number_t, Dma::ChainStatus status) {
+		if (status == Dma::ChainStatus::Complete)
+			++chainsDone;
+	}));
+	CHECK(chainsDone == 1);
+	CHECK(channelEvents == 1);
+	CHECK(dst[3] == 4);
+
+	// Источники времени
+	Gpio::EventPipeline<16> pipeline([]() -> Gpio::event_time_t { return 42; });
+	pipeline.latchPin(1);
+	CHECK(pipeline.nextDeadline() == 0);
+	RecordingErrorPolicy<4> errors([]() -> uint64_t { return 7; });
+	errors.report(ErrorEvent(ErrorSource::Gpio, 1, 3));
+	ErrorEvent event;
+	CHECK(errors.pop(event) && event.timestamp == 7);
+
+	return CHECK_RESULT();
+}
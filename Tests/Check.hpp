@@ -0,0 +1,21 @@
+#ifndef CHECK_HPP_
+#define CHECK_HPP_
+
+#include <cstdio>
+
+// Минимальная проверка для регрессионных тестов: нарушение печатается, тест продолжается,
+// код завершения main - количество нарушений (CHECK_RESULT)
+namespace Check {
+	inline int failures = 0;
+
+	inline void fail(const char* file, int line, const char* expression) {
+		std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+		++failures;
+	}
+}
+
+#define CHECK(x) do { if (!(x)) ::Check::fail(__FILE__, __LINE__, #x); } while (0)
+
+#define CHECK_RESULT() (::Check::failures == 0 ? 0 : 1)
+
+#endif
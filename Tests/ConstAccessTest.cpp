@@ -0,0 +1,139 @@
+// Геттеры настроек доступны через константные ссылки (с теневой таблицей и без нее), ошибки номера пина
+// или канала из константных геттеров передаются обработчику ошибок, а переопределение getSettings
+// с квалификатором const в наследнике переопределяет виртуальный метод базового класса. Номер пина или канала
+// сохраняется в событии ошибки без усечения
+#include "Check.hpp"
+#include "SimDma.hpp"
+#include "SimGpio.hpp"
+#include "StaticDma.hpp"
+#include "StaticGpio.hpp"
+
+using namespace BasePeripheral;
+
+namespace {
+	// Наследник, переопределяющий getSettings (сигнатура базового класса до появления теневой таблицы)
+	class CountingGpio : public Sim::SimGpio<16, true> {
+	public:
+		Gpio::Settings getSettings(Gpio::pin_number_t pin) const override {
+			++calls;
+			return Sim::SimGpio<16, true>::getSettings(pin);
+		}
+
+		mutable uint32_t calls = 0;
+	};
+
+	// Минимальные реализации статических вариантов
+	class StaticPort : public Gpio::StaticGpio<StaticPort, 16> {
+		friend class Gpio::StaticGpio<StaticPort, 16>;
+
+	public:
+		bool isEnabled() const { return true; }
+		uint32_t errors = 0;
+
+	private:
+		void onEnableClock() {}
+		void onDisableClock() {}
+		void onError(error_t) { ++errors; }
+		bool onSetSettings(Gpio::pin_number_t, const Gpio::Settings&) { return true; }
+		bool onUpdateSettings(Gpio::pin_number_t, const Gpio::Settings&) { return true; }
+		Gpio::Settings onGetSettings(Gpio::pin_number_t) const { return Gpio::Settings().setMode(Gpio::Mode::Output); }
+		Gpio::Mode onGetMode(Gpio::pin_number_t) const { return Gpio::Mode::Output; }
+		Gpio::Pull onGetPull(Gpio::pin_number_t) const { return Gpio::Pull::PullUp; }
+		Gpio::OutputType onGetOutputType(Gpio::pin_number_t) const { return Gpio::OutputType::OpenDrain; }
+		Gpio::OutputSpeed onGetOutputSpeed(Gpio::pin_number_t) const { return Gpio::OutputSpeed::High; }
+	};
+
+	class StaticController : public Dma::StaticDma<StaticController, 7> {
+		friend class Dma::StaticDma<StaticController, 7>;
+
+	public:
+		bool isEnabled() const { return true; }
+		uint32_t errors = 0;
+
+	private:
+		void onEnableClock() {}
+		void onDisableClock() {}
+		void onError(error_t) { ++errors; }
+		Dma::Settings onGetSettings(Dma::channel_number_t) const { return Dma::Settings(Dma::Direction::MemoryToPeriph); }
+		uint32_t onGetDataCount(Dma::channel_number_t channel) const { return channel + 10; }
+	};
+
+	template <typename Port>
+	void checkPort(const Port& port) {
+		CHECK(port.getSettings(2).getMode() == Gpio::Mode::Output);
+		CHECK(port.getMode(2) == Gpio::Mode::Output);
+		CHECK(port.getPull(2) == Gpio::Pull::PullUp);
+		CHECK(port.getOutputType(2) == Gpio::OutputType::OpenDrain);
+		CHECK(port.getOutputSpeed(2) == Gpio::OutputSpeed::High);
+		CHECK(port.getSettings(Port::PinMaxNumber + 1) == Gpio::Settings());
+	}
+
+	template <typename Controller>
+	void checkController(const Controller& dma) {
+		CHECK(dma.getSettings(1).getDirection() == Dma::Direction::MemoryToPeriph);
+		CHECK(dma.getDirection(1) == Dma::Direction::MemoryToPeriph);
+		CHECK(dma.getMode(1) == Dma::Mode::Normal);
+		CHECK(dma.getPriority(1) == Dma::Priority::Low);
+		CHECK(dma.getDataCount(Controller::ChannelMaxNumber + 1) == 0);
+	}
+
+	template <typename Gpio_t>
+	void configurePort(Gpio_t& gpio) {
+		gpio.init();
+		gpio.initPin(2, Gpio::Settings(Gpio::Mode::Output, Gpio::Pull::PullUp, Gpio::OutputType::OpenDrain, Gpio::OutputSpeed::High));
+	}
+
+	template <typename Dma_t>
+	void configureController(Dma_t& dma) {
+		dma.init();
+		dma.initChannel(1, Dma::Settings(Dma::Direction::MemoryToPeriph));
+	}
+}
+
+int main() {
+	Sim::SimGpio<> gpio;
+	configurePort(gpio);
+	checkPort(gpio);
+	CHECK(gpio.errors().count() == 1);
+	CHECK(gpio.errors().last().source == ErrorSource::Gpio);
+	CHECK(gpio.errors().last().index == Sim::SimGpio<>::PinMaxNumber + 1);
+
+	Sim::SimGpio<16, true> cachedGpio;
+	configurePort(cachedGpio);
+	checkPort(cachedGpio);
+	CHECK(cachedGpio.errors().count() == 1);
+
+	CountingGpio counting;
+	configurePort(counting);
+	const Gpio::BaseGpio<16, true>& base = counting;
+	CHECK(base.getSettings(2).getPull() == Gpio::Pull::PullUp);
+	CHECK(counting.calls == 1);
+
+	Sim::SimDma<> dma;
+	configureController(dma);
+	checkController(dma);
+	CHECK(dma.errors().count() == 1);
+
+	Sim::SimDma<7, true> cachedDma;
+	configureController(cachedDma);
+	checkController(cachedDma);
+	CHECK(cachedDma.errors().count() == 1);
+
+	StaticPort port;
+	checkPort(port);
+	CHECK(port.errors == 1);
+
+	StaticController controller;
+	checkController(controller);
+	CHECK(controller.getDataCount(3) == 13);
+	CHECK(controller.errors == 1);
+
+	CountingErrorPolicy policy;
+	CHECK(policy.last().index == ErrorEvent::NoIndex);
+	policy.report(ErrorEvent(ErrorSource::Adc, 5, 0x12345678u));
+	CHECK(policy.last().source == ErrorSource::Adc);
+	CHECK(policy.last().error == 5);
+	CHECK(policy.last().index == 0x12345678u);
+
+	return CHECK_RESULT();
+}
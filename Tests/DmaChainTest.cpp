@@ -0,0 +1,235 @@
+// Цепочки дескрипторов и очередь отправки на симуляторе DMA: пакет, запущенный из обработчика завершения
+// предыдущего, выполняется целиком (включая первый узел) при аппаратном и программном обходе цепочки,
+// с прерыванием TransferComplete и без него, в синхронном и отложенном режимах память-память.
+// Повторный запуск цепочки на занятом канале отклоняется, выполняемая цепочка завершается как обычно,
+// а пакет очереди, который не удалось запустить, завершается с ошибкой.
+// Ошибка передачи прерывает цепочку, выключает канал и передается владельцу: обработчику цепочки, пакету
+// очереди отправки и запросу планировщика
+#include <cstring>
+#include "Check.hpp"
+#include "DmaQueue.hpp"
+#include "DmaScheduler.hpp"
+#include "SimDma.hpp"
+
+using namespace BasePeripheral;
+using namespace BasePeripheral::Dma;
+
+namespace {
+	constexpr address_t SrcAddress = 0x20000000u;
+	constexpr address_t DstAddress = 0x20100000u;
+	constexpr address_t UnmappedAddress = 0x30000000u;
+	constexpr uint32_t BufferSize = 256;
+
+	typedef Sim::SimDma<7> HardwareDma;
+
+	// Контроллер с программным обходом цепочки (реализация onSubmitChain базового класса)
+	class SoftwareDma : public HardwareDma {
+	protected:
+		bool onSubmitChain(channel_number_t channel, const Descriptor* head) override {
+			return BaseDma<7>::onSubmitChain(channel, head);
+		}
+	};
+
+	struct Completion {
+		uint32_t batches = 0;
+		uint32_t failed = 0;
+		void onComplete(channel_number_t, ChainStatus status) {
+			++batches;
+			failed += status == ChainStatus::Error ? 1 : 0;
+		}
+	};
+
+	// Два пакета по два узла (4 x 16 байт), второй запускается из обработчика завершения первого.
+	// Возвращает количество байтов приемника, не совпадающих с источником
+	template <typename Controller>
+	uint32_t runQueue(bool deferred, bool enableTransferComplete, uint32_t& batches) {
+		uint8_t src[BufferSize];
+		uint8_t dst[BufferSize] = {};
+		for (uint32_t i = 0; i < BufferSize; ++i)
+			src[i] = static_cast<uint8_t>(i * 7 + 3);
+
+		Sim::SimBus bus;
+		bus.mapMemory(SrcAddress, src, BufferSize);
+		bus.mapMemory(DstAddress, dst, BufferSize);
+
+		Controller dma;
+		dma.init();
+		dma.connect(bus);
+		dma.setDeferredMemoryToMemory(deferred);
+		dma.initChannel(0, Settings(Direction::MemoryToMemory));
+		if (enableTransferComplete)
+			dma.setEvents(0, Event::TransferComplete);
+
+		Completion completion;
+		const ChainCallback_t onComplete = ChainCallback_t::template bind<Completion, &Completion::onComplete>(&completion);
+		SubmissionQueue<Controller, 8, 4> queue(dma, 0);
+		for (uint32_t batch = 0; batch < 2; ++batch) {
+			for (uint32_t node = 0; node < 2; ++node) {
+				const uint32_t offset = (batch * 2 + node) * 16;
+				CHECK(queue.push(SrcAddress + offset, DstAddress + offset, 4, DataAlign::Word));
+			}
+			CHECK(queue.submit(onComplete));
+		}
+		for (uint32_t i = 0; i < 1000 && !queue.empty(); ++i)
+			dma.step(3);
+		CHECK(queue.empty());
+
+		batches = completion.batches;
+		uint32_t bad = 0;
+		for (uint32_t i = 0; i < 64; ++i)
+			bad += src[i] != dst[i] ? 1 : 0;
+		for (uint32_t i = 64; i < BufferSize; ++i)
+			bad += dst[i] != 0 ? 1 : 0;
+		return bad;
+	}
+
+	template <typename Controller>
+	void checkQueue(const char* name) {
+		for (int deferred = 0; deferred < 2; ++deferred)
+			for (int transferComplete = 0; transferComplete < 2; ++transferComplete) {
+				uint32_t batches = 0;
+				const uint32_t bad = runQueue<Controller>(deferred != 0, transferComplete != 0, batches);
+				if (bad != 0 || batches != 2)
+					std::fprintf(stderr, "%s deferred=%d tc=%d: bad=%u batches=%u\n", name, deferred, transferComplete,
+						static_cast<unsigned>(bad), static_cast<unsigned>(batches));
+				CHECK(bad == 0);
+				CHECK(batches == 2);
+			}
+	}
+
+	template <typename Controller>
+	void checkBusyChannel() {
+		uint8_t src[BufferSize];
+		uint8_t dst[BufferSize] = {};
+		for (uint32_t i = 0; i < BufferSize; ++i)
+			src[i] = static_cast<uint8_t>(i + 1);
+
+		Sim::SimBus bus;
+		bus.mapMemory(SrcAddress, src, BufferSize);
+		bus.mapMemory(DstAddress, dst, BufferSize);
+
+		Controller dma;
+		dma.init();
+		dma.connect(bus);
+		dma.setDeferredMemoryToMemory(true);
+		dma.initChannel(0, Settings(Direction::MemoryToMemory));
+
+		Completion first;
+		Completion second;
+		const Descriptor running(SrcAddress, DstAddress, 32);
+		const Descriptor rejected(SrcAddress + 32, DstAddress + 32, 32);
+		CHECK(dma.submitChain(0, &running, ChainCallback_t::template bind<Completion, &Completion::onComplete>(&first)));
+		dma.step(8);
+		CHECK(!dma.submitChain(0, &rejected, ChainCallback_t::template bind<Completion, &Completion::onComplete>(&second)));
+		CHECK(dma.errorCount() == 1);
+		CHECK(dma.lastError() == static_cast<error_t>(Error::ChannelBusy));
+		CHECK(dma.isChainActive(0));
+
+		// Пакет очереди, который не удалось запустить, завершается с ошибкой и освобождает узлы
+		Completion batch;
+		SubmissionQueue<Controller, 4, 2> queue(dma, 0);
+		CHECK(queue.push(SrcAddress + 64, DstAddress + 64, 16));
+		CHECK(!queue.submit(ChainCallback_t::template bind<Completion, &Completion::onComplete>(&batch)));
+		CHECK(batch.batches == 1 && batch.failed == 1);
+		CHECK(queue.empty() && queue.pendingBatches() == 0);
+
+		for (uint32_t i = 0; i < 100 && dma.isChainActive(0); ++i)
+			dma.step(8);
+		CHECK(first.batches == 1);
+		CHECK(second.batches == 0);
+
+		// После освобождения канала очередь снова запускает пакеты
+		CHECK(queue.push(SrcAddress + 64, DstAddress + 64, 16));
+		CHECK(queue.submit(ChainCallback_t::template bind<Completion, &Completion::onComplete>(&batch)));
+		for (uint32_t i = 0; i < 100 && !queue.empty(); ++i)
+			dma.step(8);
+		CHECK(batch.batches == 2 && batch.failed == 1);
+		CHECK(std::memcmp(src + 64, dst + 64, 16) == 0);
+		CHECK(std::memcmp(src, dst, 32) == 0);
+		CHECK(dst[32] == 0);
+	}
+
+	struct RequestCompletion {
+		uint32_t completed = 0;
+		ChainStatus status = ChainStatus::Complete;
+		void onComplete(TransferRequest& request) {
+			++completed;
+			status = request.status;
+		}
+	};
+
+	template <typename Controller>
+	void checkTransferError() {
+		uint8_t src[BufferSize];
+		uint8_t dst[BufferSize] = {};
+		for (uint32_t i = 0; i < BufferSize; ++i)
+			src[i] = static_cast<uint8_t>(i + 1);
+
+		Sim::SimBus bus;
+		bus.mapMemory(SrcAddress, src, BufferSize);
+		bus.mapMemory(DstAddress, dst, BufferSize);
+
+		Controller dma;
+		dma.init();
+		dma.connect(bus);
+		dma.setDeferredMemoryToMemory(true);
+		dma.initChannel(0, Settings(Direction::MemoryToMemory));
+
+		// Цепочка: второй узел читает неотображенный адрес, третий не выполняется
+		Descriptor nodes[3] = { Descriptor(SrcAddress, DstAddress, 16), Descriptor(UnmappedAddress, DstAddress + 16, 16),
+			Descriptor(SrcAddress + 32, DstAddress + 32, 16) };
+		nodes[0].setNext(&nodes[1]);
+		nodes[1].setNext(&nodes[2]);
+		Completion chain;
+		CHECK(dma.submitChain(0, &nodes[0], ChainCallback_t::template bind<Completion, &Completion::onComplete>(&chain)));
+		for (uint32_t i = 0; i < 100 && dma.isChainActive(0); ++i)
+			dma.step(4);
+		CHECK(!dma.isChainActive(0));
+		CHECK(!dma.isChannelEnabled(0));
+		CHECK(chain.batches == 1 && chain.failed == 1);
+		CHECK(std::memcmp(src, dst, 16) == 0);
+		CHECK(dst[32] == 0);
+
+		// Очередь отправки: пакет с ошибкой завершается с ошибкой, следующий выполняется
+		Completion batches;
+		const ChainCallback_t onBatch = ChainCallback_t::template bind<Completion, &Completion::onComplete>(&batches);
+		SubmissionQueue<Controller, 4, 2> queue(dma, 0);
+		CHECK(queue.push(UnmappedAddress, DstAddress + 64, 16));
+		CHECK(queue.submit(onBatch));
+		CHECK(queue.push(SrcAddress + 64, DstAddress + 64, 16));
+		CHECK(queue.submit(onBatch));
+		for (uint32_t i = 0; i < 100 && !queue.empty(); ++i)
+			dma.step(4);
+		CHECK(queue.empty());
+		CHECK(batches.batches == 2 && batches.failed == 1);
+		CHECK(std::memcmp(src + 64, dst + 64, 16) == 0);
+
+		// Планировщик: запрос с ошибкой завершается со статусом Error и освобождает канал
+		DmaScheduler<Controller> scheduler(dma, 0x1);
+		RequestCompletion completion;
+		TransferRequest requests[2];
+		requests[0].descriptor = Descriptor(SrcAddress + 96, UnmappedAddress, 16);
+		requests[1].descriptor = Descriptor(SrcAddress + 128, DstAddress + 128, 16);
+		for (TransferRequest& request : requests) {
+			request.onComplete = TransferCallback_t::bind<RequestCompletion, &RequestCompletion::onComplete>(&completion);
+			scheduler.submit(request);
+		}
+		for (uint32_t i = 0; i < 100 && completion.completed < 2; ++i)
+			dma.step(4);
+		CHECK(completion.completed == 2);
+		CHECK(requests[0].status == ChainStatus::Error);
+		CHECK(requests[1].status == ChainStatus::Complete);
+		CHECK(scheduler.active() == 0 && scheduler.queued() == 0);
+		CHECK(std::memcmp(src + 128, dst + 128, 16) == 0);
+	}
+}
+
+int main() {
+	checkQueue<HardwareDma>("hardware walk");
+	checkQueue<SoftwareDma>("software walk");
+	checkBusyChannel<HardwareDma>();
+	checkBusyChannel<SoftwareDma>();
+	checkTransferError<HardwareDma>();
+	checkTransferError<SoftwareDma>();
+	return CHECK_RESULT();
+}
@@ -0,0 +1,58 @@
+// Пересылка память-память на симуляторе DMA при перекрытии источника и приемника в обе стороны (приемник
+// выше и ниже источника, с частичным и полным совпадением) для каждой ширины данных: результат должен совпадать
+// с поэлементной пересылкой в прямом порядке, как у контроллера, а память вне приемника - не изменяться
+#include <cstring>
+#include "Check.hpp"
+#include "SimDma.hpp"
+
+using namespace BasePeripheral;
+using namespace BasePeripheral::Dma;
+
+namespace {
+	constexpr address_t MemoryAddress = 0x20000000u;
+	constexpr uint32_t MemorySize = 512;
+	constexpr uint32_t Base = 128;
+
+	// Эталон: поэлементная пересылка в прямом порядке
+	void reference(uint8_t* memory, uint32_t dst, uint32_t src, uint32_t count, uint32_t size) {
+		for (uint32_t i = 0; i < count; ++i)
+			std::memmove(memory + dst + i * size, memory + src + i * size, size);
+	}
+}
+
+int main() {
+	Sim::SimBus bus;
+	uint8_t memory[MemorySize];
+	uint8_t expected[MemorySize];
+	bus.mapMemory(MemoryAddress, memory, MemorySize);
+	Sim::SimDma<7> dma;
+	dma.init();
+	dma.connect(bus);
+
+	for (uint32_t width = 0; width < 3; ++width) {
+		const uint32_t size = 1u << width;
+		for (int32_t shift : { -100, -17, -4, -1, 0, 1, 4, 17, 100 }) {
+			if (shift % static_cast<int32_t>(size) != 0)
+				continue;
+			const uint32_t count = 200 / size; // Больше 64 байт: проходят и векторные блоки, и хвост
+			const uint32_t src = Base;
+			const uint32_t dst = static_cast<uint32_t>(static_cast<int32_t>(Base) + shift);
+			for (uint32_t i = 0; i < MemorySize; ++i)
+				memory[i] = expected[i] = static_cast<uint8_t>(i * 13 + 5);
+			reference(expected, dst, src, count, size);
+
+			const DataAlign align = static_cast<DataAlign>(width);
+			CHECK(dma.initChannel(0, Settings(Direction::MemoryToMemory, Mode::Normal, Priority::Low,
+				MemorySettings(MemoryAddress + src, align, IncrementMode::Increment),
+				MemorySettings(MemoryAddress + dst, align, IncrementMode::Increment))));
+			dma.setDataCount(0, count);
+			CHECK(dma.enableChannel(0));
+			dma.disableChannel(0);
+			if (std::memcmp(memory, expected, MemorySize) != 0)
+				std::fprintf(stderr, "width %u shift %d: mismatch\n", static_cast<unsigned>(size), static_cast<int>(shift));
+			CHECK(std::memcmp(memory, expected, MemorySize) == 0);
+		}
+	}
+	CHECK(dma.errorCount() == 0);
+	return CHECK_RESULT();
+}
@@ -0,0 +1,275 @@
+// Захват логического анализатора: векторный поиск изменений CaptureKernels::findChange сравнивается со скалярным
+// эталоном для выборок по 8, 16 и 32 бита, разных масок, начальных позиций и длин; EdgeCompressor, получающий выборки
+// блоками произвольного размера с пропусками, сравнивается с эталонным сжатием; LogicCapture на симуляторе
+// (канал DMA читает IDR порта SimGpio в циклический буфер) проверяется на изменениях на границах половин буфера
+// и при переполнении (непрерывность отметок времени после потерянных половин).
+// Тест собирается также с -mavx2 (GpioCaptureTestAvx2), если компилятор и процессор сборки поддерживают AVX2
+#include <algorithm>
+#include <vector>
+#include "Check.hpp"
+#include "GpioCapture.hpp"
+#include "SimDma.hpp"
+#include "SimGpio.hpp"
+
+#if defined(BP_TEST_EXPECT_AVX2) && !defined(BP_GPIO_CAPTURE_AVX2)
+#error "AVX2 build of the test must use the AVX2 kernel"
+#endif
+
+using namespace BasePeripheral;
+using namespace BasePeripheral::Gpio;
+
+namespace {
+	constexpr Sim::address_t PortAddress = 0x48000000u;
+	constexpr Sim::address_t IdrAddress = PortAddress + Sim::GpioOffset::IDR;
+	constexpr Sim::address_t BufferAddress = 0x20000000u;
+	constexpr Dma::channel_number_t Channel = 3;
+
+	typedef Sim::SimDma<7> Controller;
+
+	// Генератор псевдослучайных чисел (xorshift32), воспроизводимый между запусками
+	struct Random {
+		uint32_t state = 0x12345678u;
+
+		uint32_t operator()() {
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			return state;
+		}
+	};
+
+	// Эталон findChange
+	template <typename Sample>
+	size_t findChangeReference(const Sample* samples, size_t begin, size_t count, Sample mask) {
+		for (size_t i = begin; i < count; ++i)
+			if (((samples[i] ^ samples[i - 1]) & mask) != 0)
+				return i;
+		return count;
+	}
+
+	// Эталонное сжатие: samples[i] получена в момент times[i], первая выборка задает начальные уровни
+	template <typename Sample>
+	std::vector<EdgeRecord<Sample>> compressReference(const std::vector<Sample>& samples, const std::vector<uint32_t>& times, Sample mask) {
+		std::vector<EdgeRecord<Sample>> records;
+		Sample levels = samples.empty() ? 0 : static_cast<Sample>(samples[0] & mask);
+		for (size_t i = 1; i < samples.size(); ++i) {
+			const Sample current = static_cast<Sample>(samples[i] & mask);
+			if (current != levels)
+				records.push_back(EdgeRecord<Sample>{ times[i], static_cast<Sample>(current ^ levels), current });
+			levels = current;
+		}
+		return records;
+	}
+
+	// Сравнивает записи с эталоном, печатает первое расхождение
+	template <typename Sample>
+	bool sameRecords(const char* name, const std::vector<EdgeRecord<Sample>>& actual, const std::vector<EdgeRecord<Sample>>& expected) {
+		for (size_t i = 0; i < actual.size() && i < expected.size(); ++i) {
+			const EdgeRecord<Sample>& a = actual[i];
+			const EdgeRecord<Sample>& e = expected[i];
+			if (a.timestamp != e.timestamp || a.changed != e.changed || a.levels != e.levels) {
+				std::fprintf(stderr, "%s (%u-bit): record %u: {%u, %x, %x}, expected {%u, %x, %x}\n", name,
+					static_cast<unsigned>(sizeof(Sample) * 8), static_cast<unsigned>(i),
+					static_cast<unsigned>(a.timestamp), static_cast<unsigned>(a.changed), static_cast<unsigned>(a.levels),
+					static_cast<unsigned>(e.timestamp), static_cast<unsigned>(e.changed), static_cast<unsigned>(e.levels));
+				return false;
+			}
+		}
+		if (actual.size() != expected.size()) {
+			std::fprintf(stderr, "%s (%u-bit): %u records, expected %u\n", name, static_cast<unsigned>(sizeof(Sample) * 8),
+				static_cast<unsigned>(actual.size()), static_cast<unsigned>(expected.size()));
+			return false;
+		}
+		return true;
+	}
+
+	template <typename Sample>
+	Sample allPins() { return static_cast<Sample>(~Sample(0)); }
+
+	// Поиск всех изменений от каждой начальной позиции до нескольких длин (в том числе не кратных ширине вектора)
+	// на выборках с разной плотностью изменений, часть которых лежит вне маски
+	template <typename Sample>
+	void checkFindChange() {
+		constexpr size_t Count = 300;
+		const Sample highPin = static_cast<Sample>(Sample(1) << (sizeof(Sample) * 8 - 1));
+		const Sample masks[] = { allPins<Sample>(), Sample(1), highPin, static_cast<Sample>(allPins<Sample>() / 3), Sample(0) };
+		const uint32_t densities[] = { 0, 2, 16, 128, 256 }; // Вероятность изменения выборки, 1/256
+		Random random;
+		Sample samples[Count];
+		uint32_t mismatches = 0;
+		for (uint32_t density : densities) {
+			samples[0] = static_cast<Sample>(random());
+			for (size_t i = 1; i < Count; ++i)
+				samples[i] = (random() & 0xFFu) < density ? static_cast<Sample>(samples[i - 1] ^ random()) : samples[i - 1];
+			for (Sample mask : masks) {
+				for (size_t begin = 1; begin <= 80; ++begin) {
+					for (size_t count : { begin, begin + 1, begin + 15, begin + 16, begin + 17, begin + 33, Count }) {
+						for (size_t i = begin;;) {
+							const size_t actual = CaptureKernels::findChange(samples, i, count, mask);
+							const size_t expected = findChangeReference(samples, i, count, mask);
+							if (actual != expected) {
+								if (mismatches++ == 0)
+									std::fprintf(stderr, "findChange (%u-bit): mask %x, begin %u, count %u: %u, expected %u\n",
+										static_cast<unsigned>(sizeof(Sample) * 8), static_cast<unsigned>(mask),
+										static_cast<unsigned>(i), static_cast<unsigned>(count),
+										static_cast<unsigned>(actual), static_cast<unsigned>(expected));
+								break;
+							}
+							if (expected >= count)
+								break;
+							i = expected + 1;
+						}
+					}
+				}
+			}
+		}
+
+		// Единственное изменение в каждой позиции каждого бита: внутри маски находится, вне маски - нет
+		for (size_t position = 1; position < Count; ++position) {
+			for (uint32_t bit = 0; bit < sizeof(Sample) * 8; ++bit) {
+				const Sample pin = static_cast<Sample>(Sample(1) << bit);
+				for (size_t i = 0; i < Count; ++i)
+					samples[i] = i < position ? Sample(0x5A) : static_cast<Sample>(Sample(0x5A) ^ pin);
+				mismatches += CaptureKernels::findChange(samples, 1, Count, allPins<Sample>()) != position ? 1 : 0;
+				mismatches += CaptureKernels::findChange(samples, 1, Count, static_cast<Sample>(~pin)) != Count ? 1 : 0;
+			}
+		}
+		CHECK(mismatches == 0);
+	}
+
+	// Компрессор: выборки передаются блоками случайного размера, часть блоков пропускается (skip)
+	template <typename Sample>
+	void checkCompressor() {
+		constexpr size_t Count = 5000;
+		const Sample mask = static_cast<Sample>(allPins<Sample>() ^ 0x10u);
+		Random random;
+		std::vector<Sample> samples(Count);
+		samples[0] = static_cast<Sample>(random());
+		for (size_t i = 1; i < Count; ++i)
+			samples[i] = (random() & 0x3Fu) == 0 ? static_cast<Sample>(samples[i - 1] ^ random()) :
+				(random() & 0x7u) == 0 ? static_cast<Sample>(samples[i - 1] ^ 0x10u) : samples[i - 1];
+
+		EdgeCompressor<Sample> compressor;
+		compressor.reset(mask);
+		std::vector<EdgeRecord<Sample>> records;
+		std::vector<Sample> kept;
+		std::vector<uint32_t> times;
+		uint32_t returned = 0;
+		for (size_t offset = 0; offset < Count;) {
+			const size_t block = std::min<size_t>(1 + random() % 100, Count - offset);
+			if (offset != 0 && random() % 5 == 0) {
+				compressor.skip(block);
+			}
+			else {
+				returned += compressor.process(samples.data() + offset, block, [&](const EdgeRecord<Sample>& record) {
+					records.push_back(record);
+				});
+				for (size_t i = offset; i < offset + block; ++i) {
+					kept.push_back(samples[i]);
+					times.push_back(static_cast<uint32_t>(i));
+				}
+			}
+			offset += block;
+		}
+		CHECK(sameRecords("compressor", records, compressReference(kept, times, mask)));
+		CHECK(returned == records.size());
+		CHECK(compressor.records() == records.size());
+		CHECK(compressor.time() == Count);
+		CHECK(compressor.initialLevels() == static_cast<Sample>(samples[0] & mask));
+		CHECK(compressor.levels() == static_cast<Sample>(kept.back() & mask));
+	}
+
+	// Захват на симуляторе: Halves половин буфера, после каждой половины опрос, кроме половин Gap и Gap + 1.
+	// К опросу после Gap + 2 заполнены три половины: третья не помещается в очередь потока, а две в очереди уже
+	// перезаписываются, поэтому теряются все три (три переполнения), а записи продолжаются с Gap + 3
+	// с непрерывными отметками времени
+	template <typename Sample>
+	void checkCapture() {
+		constexpr uint32_t BufferSamples = 64;
+		constexpr uint32_t Half = BufferSamples / 2;
+		constexpr uint32_t Halves = 12;
+		constexpr uint32_t Gap = 5;
+		const Sample mask = 0x7F; // Пин 7 не отслеживается
+
+		Sim::SimBus bus;
+		Sim::SimGpio<> gpio;
+		Controller dma;
+		Sample buffer[BufferSamples] = {};
+		dma.init();
+		dma.connect(bus);
+		gpio.init();
+		gpio.attach(bus, PortAddress);
+		bus.mapMemory(BufferAddress, buffer, sizeof(buffer));
+		for (pin_number_t pin = 0; pin <= Sim::SimGpio<>::PinMaxNumber; ++pin)
+			gpio.initPin(pin, Settings().setMode(Mode::Input));
+
+		// Уровни входов в момент t: изменения на последней и первой выборках половин (в том числе на стыке
+		// циклического буфера), несколько пинов одновременно, частые изменения неотслеживаемого пина
+		// и случайные изменения, в том числе внутри потерянных половин
+		Random random;
+		std::vector<uint32_t> pattern(Halves * Half);
+		uint32_t levels = 0x8001u;
+		for (uint32_t t = 0; t < Halves * Half; ++t) {
+			const uint32_t phase = t % Half;
+			if (t != 0 && (phase == 0 || phase == Half - 1))
+				levels ^= 1u << (t / Half % 4);
+			if (t % BufferSamples == 0 && t != 0)
+				levels ^= 0x0030u;
+			if (t % 5 == 0)
+				levels ^= 0x0080u;
+			if ((random() & 0xFu) == 0)
+				levels ^= 1u << (random() % 16);
+			pattern[t] = levels;
+		}
+
+		LogicCapture<Controller, BufferSamples, Sample> capture(dma, Channel, buffer, BufferAddress);
+		CHECK(capture.start(IdrAddress, mask));
+		std::vector<EdgeRecord<Sample>> records;
+		const auto sink = [&](const EdgeRecord<Sample>& record) { records.push_back(record); };
+		uint32_t inputs = gpio.registers().IDR.load();
+		for (uint32_t half = 0; half < Halves; ++half) {
+			for (uint32_t phase = 0; phase < Half; ++phase) {
+				const uint32_t t = half * Half + phase;
+				for (pin_number_t pin = 0; pin <= Sim::SimGpio<>::PinMaxNumber; ++pin)
+					if (((inputs ^ pattern[t]) >> pin & 1u) != 0)
+						gpio.setInputLevel(pin, (pattern[t] >> pin & 1u) != 0);
+				inputs = pattern[t];
+				CHECK(dma.serviceRequest(Channel));
+			}
+			if (half != Gap && half != Gap + 1)
+				capture.poll(sink);
+		}
+		capture.stop();
+
+		std::vector<Sample> kept;
+		std::vector<uint32_t> times;
+		for (uint32_t t = 0; t < Halves * Half; ++t) {
+			const uint32_t half = t / Half;
+			if (half < Gap || half > Gap + 2) {
+				kept.push_back(static_cast<Sample>(pattern[t]));
+				times.push_back(t);
+			}
+		}
+		CHECK(sameRecords("capture", records, compressReference(kept, times, mask)));
+		CHECK(capture.overruns() == 3);
+		CHECK(capture.errors() == 0);
+		CHECK(capture.compressor().time() == Halves * Half);
+		CHECK(capture.compressor().initialLevels() == static_cast<Sample>(pattern[0] & mask));
+		CHECK(capture.compressor().records() == records.size());
+		CHECK(dma.errorCount() == 0);
+	}
+
+	template <typename Sample>
+	void checkAll() {
+		checkFindChange<Sample>();
+		checkCompressor<Sample>();
+		checkCapture<Sample>();
+	}
+}
+
+int main() {
+	checkAll<uint8_t>();
+	checkAll<uint16_t>();
+	checkAll<uint32_t>();
+	return CHECK_RESULT();
+}
@@ -0,0 +1,161 @@
+// Генератор сигналов на симуляторе: буфер диаграммы передается каналом DMA (память-периферия) через SimBus
+// в BSRR порта SimGpio, по одному запросу канала на слот. После каждого слота выходы порта сравниваются
+// с уровнями, вычисленными по определению протокола (а не по скомпилированному буферу): произвольная
+// диаграмма, WS2812 (две линии, циклический режим, два прохода), параллельная шина и SPI
+#include "Check.hpp"
+#include "GpioWaveform.hpp"
+#include "SimDma.hpp"
+#include "SimGpio.hpp"
+
+using namespace BasePeripheral;
+using namespace BasePeripheral::Gpio;
+
+namespace {
+	constexpr Sim::address_t PortAddress = 0x48000000u;
+	constexpr Sim::address_t BsrrAddress = PortAddress + Sim::GpioOffset::BSRR;
+	constexpr Sim::address_t BufferAddress = 0x20000000u;
+	constexpr uint32_t BufferSlots = 1024;
+	constexpr Dma::channel_number_t Channel = 2;
+
+	typedef Sim::SimDma<7> Controller;
+
+	class Rig {
+	public:
+		Rig() : player(dma, Channel) {
+			dma.init();
+			dma.connect(bus);
+			gpio.init();
+			gpio.attach(bus, PortAddress);
+			bus.mapMemory(BufferAddress, buffer, sizeof(buffer));
+			for (pin_number_t pin = 0; pin <= Sim::SimGpio<>::PinMaxNumber; ++pin)
+				gpio.initPin(pin, Settings().setMode(Mode::Output));
+		}
+
+		// Сбрасывает выходы и запускает вывод slots слов буфера
+		bool play(uint32_t slots, bool repeat = false) {
+			bus.write(BsrrAddress, Waveform::resetWord(0xFFFFu), 4);
+			return player.play(BufferAddress, slots, BsrrAddress, repeat);
+		}
+
+		// Выводит slots слотов (один запрос канала на слот) и после каждого сравнивает выходы pins
+		// с уровнями expected(slot). Возвращает количество несовпадений
+		template <typename Expected>
+		uint32_t checkSlots(const char* name, uint32_t slots, uint32_t pins, Expected expected) {
+			uint32_t mismatches = 0;
+			for (uint32_t slot = 0; slot < slots; ++slot) {
+				CHECK(dma.serviceRequest(Channel));
+				const uint32_t odr = gpio.registers().ODR.load() & pins;
+				const uint32_t levels = expected(slot) & pins;
+				if (odr != levels && mismatches++ == 0)
+					std::fprintf(stderr, "%s: slot %u: ODR=%04x, expected %04x\n", name, static_cast<unsigned>(slot),
+						static_cast<unsigned>(odr), static_cast<unsigned>(levels));
+			}
+			return mismatches;
+		}
+
+		Sim::SimBus bus;
+		Sim::SimGpio<> gpio;
+		Controller dma;
+		WaveformPlayer<Controller> player;
+		Waveform::word_t buffer[BufferSlots] = {};
+	};
+
+	uint32_t bitOf(const uint8_t* data, uint32_t bit) {
+		return (data[bit / 8] >> (7 - bit % 8)) & 1u;
+	}
+
+	// Произвольная диаграмма: уровни пинов после слота - результат всех фронтов до этого слота включительно
+	void checkTimeline(Rig& rig) {
+		const Waveform::Edge edges[] = { { 0, 1, true }, { 3, 1, false }, { 3, 2, true }, { 5, 2, false }, { 5, 2, true },
+			{ 7, 1, true }, { 9, 15, true }, { 12, 1, false } };
+		constexpr uint32_t Slots = 16;
+		CHECK(Waveform::compile(edges, sizeof(edges) / sizeof(edges[0]), rig.buffer, Slots));
+		CHECK(rig.play(Slots));
+		CHECK(rig.checkSlots("timeline", Slots, 0xFFFFu, [&](uint32_t slot) {
+			uint32_t levels = 0;
+			for (uint32_t tick = 0; tick <= slot; ++tick)
+				for (const Waveform::Edge& edge : edges)
+					if (edge.tick == tick)
+						levels = edge.level ? levels | (1u << edge.pin) : levels & ~(1u << edge.pin);
+			return levels;
+		}) == 0);
+		CHECK(!rig.player.isPlaying());
+		CHECK(rig.player.passes() == 1);
+		CHECK(!rig.dma.serviceRequest(Channel));
+	}
+
+	// WS2812: бит - три слота (высокий; высокий для единицы; низкий), затем пауза сброса с низким уровнем
+	void checkWs2812(Rig& rig) {
+		constexpr pin_number_t FirstPin = 4;
+		constexpr uint32_t Bytes = 3;
+		const uint8_t first[Bytes] = { 0xA5, 0x0F, 0x81 };
+		const uint8_t second[Bytes] = { 0x3C, 0xFF, 0x00 };
+		const uint8_t* const lanes[] = { first, second };
+		const uint32_t slots = Waveform::Ws2812::encode(rig.buffer, lanes, 2, Bytes, FirstPin);
+		CHECK(slots == Waveform::Ws2812::bufferSlots(Bytes));
+		CHECK(rig.play(slots, true));
+		const auto expected = [&](uint32_t slot) {
+			const uint32_t bit = slot / Waveform::Ws2812::SlotsPerBit;
+			const uint32_t phase = slot % Waveform::Ws2812::SlotsPerBit;
+			uint32_t levels = 0;
+			for (uint32_t lane = 0; lane < 2; ++lane) {
+				const bool high = bit < Bytes * 8 && (phase == 0 || (phase == 1 && bitOf(lanes[lane], bit) != 0));
+				levels |= (high ? 1u : 0u) << (FirstPin + lane);
+			}
+			return levels;
+		};
+		for (uint32_t pass = 0; pass < 2; ++pass)
+			CHECK(rig.checkSlots("ws2812", slots, 0x3u << FirstPin, expected) == 0);
+		CHECK(rig.player.isPlaying());
+		CHECK(rig.player.passes() == 2);
+		rig.player.stop();
+		CHECK(!rig.player.isPlaying());
+	}
+
+	// Параллельная шина: данные вместе со спадом WR, затем подъем WR при неизменных данных
+	void checkParallelBus(Rig& rig) {
+		constexpr pin_number_t WrPin = 8;
+		const uint16_t words[] = { 0xAB, 0x12, 0xFF, 0x00 };
+		const uint32_t slots = Waveform::ParallelBus::encode(rig.buffer, words, 4, 0, 8, WrPin);
+		CHECK(slots == Waveform::ParallelBus::bufferSlots(4));
+		CHECK(Waveform::ParallelBus::encode(rig.buffer + slots, words, 4, 0, 8, 3) == 0);
+		CHECK(rig.play(slots));
+		CHECK(rig.checkSlots("parallel bus", slots, 0x1FFu, [&](uint32_t slot) {
+			const uint32_t wr = slot % Waveform::ParallelBus::SlotsPerWord == 1 ? 1u << WrPin : 0u;
+			return words[slot / Waveform::ParallelBus::SlotsPerWord] | wr;
+		}) == 0);
+		CHECK(!rig.player.isPlaying());
+	}
+
+	// SPI, режим 0: MOSI выставляется вместе со спадом SCK, затем подъем SCK; в последнем слоте SCK низкий
+	void checkSpi(Rig& rig) {
+		constexpr pin_number_t SckPin = 10;
+		constexpr pin_number_t MosiPin = 11;
+		constexpr uint32_t Bytes = 2;
+		const uint8_t data[Bytes] = { 0xC3, 0x5A };
+		const uint32_t slots = Waveform::Spi::encode(rig.buffer, data, Bytes, SckPin, MosiPin);
+		CHECK(slots == Waveform::Spi::bufferSlots(Bytes));
+		CHECK(rig.play(slots));
+		CHECK(rig.checkSlots("spi", slots, (1u << SckPin) | (1u << MosiPin), [&](uint32_t slot) {
+			const uint32_t bit = slot / Waveform::Spi::SlotsPerBit;
+			if (bit == Bytes * 8)
+				return bitOf(data, bit - 1) << MosiPin;
+			const uint32_t sck = slot % Waveform::Spi::SlotsPerBit == 1 ? 1u << SckPin : 0u;
+			return (bitOf(data, bit) << MosiPin) | sck;
+		}) == 0);
+		CHECK(!rig.player.isPlaying());
+	}
+}
+
+int main() {
+	Rig rig;
+	checkTimeline(rig);
+	checkWs2812(rig);
+	checkParallelBus(rig);
+	checkSpi(rig);
+
+	const Waveform::Edge outside{ BufferSlots, 0, true };
+	CHECK(!Waveform::compile(&outside, 1, rig.buffer, BufferSlots));
+	CHECK(rig.gpio.errors().count() == 0);
+	return CHECK_RESULT();
+}
@@ -0,0 +1,257 @@
+// Трассировка (сборка с BP_TRACE=1) на симуляторе: операции GPIO и DMA, в том числе вложенные (прерывание
+// канала DMA внутри enableChannel при передаче память-память, прерывание пина внутри изменения уровня входа),
+// и операции второго потока. Проверяются счетчики вызовов и времени блоков периферии (источник времени -
+// счетчик, увеличивающийся на единицу при каждом чтении) и экспорт Chrome Trace JSON: каждая запись начала
+// закрывается записью конца с тем же именем и категорией в порядке вложенности своего потока, категория
+// соответствует имени, отметки времени потока не убывают. При переполнении кольцевого буфера потока экспорт
+// содержит только последние записи, и в них начала по-прежнему закрыты
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Check.hpp"
+#include "SimDma.hpp"
+#include "SimGpio.hpp"
+#include "Trace.hpp"
+
+#if !BP_TRACE
+#error "Trace test must be built with BP_TRACE=1"
+#endif
+
+using namespace BasePeripheral;
+
+namespace {
+	constexpr Dma::address_t SrcAddress = 0x20000000u;
+	constexpr Dma::address_t DstAddress = 0x20100000u;
+	constexpr uint32_t BufferSize = 256;
+	constexpr Gpio::pin_number_t InputPin = 8;
+
+	typedef Sim::SimGpio<16> Port;
+	typedef Sim::SimDma<7> Controller;
+
+	struct Event {
+		std::string name;
+		std::string category;
+		char phase = 0;
+		double timestamp = 0;
+		uint32_t thread = 0;
+	};
+
+	// Значение поля key объекта события JSON: строка без кавычек или число в виде текста
+	std::string field(const std::string& line, const char* key) {
+		const std::string pattern = std::string("\"") + key + "\":";
+		const size_t start = line.find(pattern);
+		if (start == std::string::npos)
+			return std::string();
+		size_t position = start + pattern.size();
+		if (line[position] == '"') {
+			const size_t end = line.find('"', position + 1);
+			return end == std::string::npos ? std::string() : line.substr(position + 1, end - position - 1);
+		}
+		const size_t end = line.find_first_of(",}", position);
+		return line.substr(position, end - position);
+	}
+
+	// Разбирает экспорт: по одному объекту события в строке между заголовком и окончанием
+	bool parse(const std::string& json, std::vector<Event>& events) {
+		const std::string header = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+		const std::string footer = "\n]}\n";
+		if (json.compare(0, header.size(), header) != 0 || json.size() < header.size() + footer.size() ||
+			json.compare(json.size() - footer.size(), footer.size(), footer) != 0)
+			return false;
+		size_t position = header.size();
+		while (position < json.size() - footer.size()) {
+			const size_t end = json.find('\n', position + 1);
+			const std::string line = json.substr(position + 1, end - position - 1);
+			position = end;
+			if (line.empty())
+				continue;
+			Event event;
+			event.name = field(line, "name");
+			event.category = field(line, "cat");
+			const std::string phase = field(line, "ph");
+			event.phase = phase.size() == 1 ? phase[0] : 0;
+			event.timestamp = std::strtod(field(line, "ts").c_str(), nullptr);
+			event.thread = static_cast<uint32_t>(std::strtoul(field(line, "tid").c_str(), nullptr, 10));
+			if (event.name.empty() || (event.phase != 'B' && event.phase != 'E'))
+				return false;
+			events.push_back(event);
+		}
+		return true;
+	}
+
+	// Проверяет парность и вложенность записей. Возвращает количество несоответствий
+	uint32_t checkPairs(const std::vector<Event>& events) {
+		struct Thread {
+			std::vector<const Event*> open;
+			double last = 0;
+		};
+		std::vector<Thread> threads;
+		uint32_t mismatches = 0;
+		const auto fail = [&](const Event& event, const char* reason) {
+			if (mismatches++ == 0)
+				std::fprintf(stderr, "%s %c (%s) tid %u: %s\n", event.name.c_str(), event.phase, event.category.c_str(),
+					static_cast<unsigned>(event.thread), reason);
+		};
+		for (const Event& event : events) {
+			if (event.thread >= threads.size())
+				threads.resize(event.thread + 1);
+			Thread& thread = threads[event.thread];
+			const bool gpio = event.name.compare(0, 5, "Gpio.") == 0;
+			const bool dma = event.name.compare(0, 4, "Dma.") == 0;
+			if (!(gpio && event.category == "gpio") && !(dma && event.category == "dma"))
+				fail(event, "category does not match name");
+			if (event.timestamp < thread.last)
+				fail(event, "timestamp decreases");
+			thread.last = event.timestamp;
+			if (event.phase == 'B') {
+				thread.open.push_back(&event);
+			}
+			else if (thread.open.empty()) {
+				fail(event, "end without begin");
+			}
+			else {
+				const Event& begin = *thread.open.back();
+				if (begin.name != event.name || begin.category != event.category)
+					fail(event, "end does not match innermost begin");
+				thread.open.pop_back();
+			}
+		}
+		for (const Thread& thread : threads)
+			for (const Event* event : thread.open)
+				fail(*event, "begin without end");
+		return mismatches;
+	}
+
+	// Источник времени: каждое чтение - следующая наносекунда
+	std::atomic<uint64_t> ticks{ 0 };
+	auto tick = []() { return ticks.fetch_add(1, std::memory_order_relaxed) + 1; };
+
+	struct Counter {
+		uint32_t calls = 0;
+		void onInterrupt(Gpio::pin_number_t) { ++calls; }
+		void onComplete(Dma::channel_number_t, Dma::ChainStatus status) { calls += status == Dma::ChainStatus::Complete ? 1 : 0; }
+	};
+
+	template <typename Peripheral>
+	uint32_t calls(const Peripheral& peripheral, Trace::Op op) { return peripheral.getTraceCounters().getCalls(op); }
+
+	void checkOperations() {
+		Trace::clear();
+		Port gpio;
+		gpio.init();
+		for (Gpio::pin_number_t pin = 0; pin < 4; ++pin)
+			CHECK(gpio.initPin(pin, Gpio::Settings().setMode(Gpio::Mode::Output)));
+		CHECK(gpio.initPin(InputPin, Gpio::Settings().setMode(Gpio::Mode::Input)));
+		Counter edges;
+		gpio.configureInterrupt(InputPin, Sim::Edge::Both);
+		gpio.setPinInterruptHandler(InputPin, Gpio::PinInterruptHandler_t::bind<Counter, &Counter::onInterrupt>(&edges));
+		for (uint32_t i = 0; i < 10; ++i) {
+			gpio.setPin(0);
+			gpio.resetPin(0);
+			gpio.togglePin(1);
+		}
+		gpio.writePins(Port::Mask().set(2).set(3), Port::Mask().set(2));
+		gpio.togglePins(Port::Mask().set(2).set(3));
+		for (uint32_t i = 0; i < 4; ++i) {
+			gpio.setInputLevel(InputPin, i % 2 == 0);
+			CHECK(gpio.readPinInput(InputPin) == (i % 2 == 0));
+		}
+
+		uint8_t src[BufferSize];
+		uint8_t dst[BufferSize] = {};
+		for (uint32_t i = 0; i < BufferSize; ++i)
+			src[i] = static_cast<uint8_t>(i ^ 0x5A);
+		Sim::SimBus bus;
+		bus.mapMemory(SrcAddress, src, BufferSize);
+		bus.mapMemory(DstAddress, dst, BufferSize);
+		Controller dma;
+		dma.init();
+		dma.connect(bus);
+		CHECK(dma.initChannel(0, Dma::Settings(Dma::Direction::MemoryToMemory, Dma::Mode::Normal, Dma::Priority::Low,
+			Dma::MemorySettings(SrcAddress, Dma::DataAlign::Word, Dma::IncrementMode::Increment),
+			Dma::MemorySettings(DstAddress, Dma::DataAlign::Word, Dma::IncrementMode::Increment))));
+		dma.setEvents(0, Dma::Event::TransferComplete);
+		dma.setDataCount(0, 16);
+		CHECK(dma.enableChannel(0)); // Передача и прерывание внутри enableChannel
+		dma.disableChannel(0);
+		Counter chains;
+		const Dma::Descriptor nodes[2] = { Dma::Descriptor(SrcAddress + 64, DstAddress + 64, 32, Dma::DataAlign::Byte),
+			Dma::Descriptor(SrcAddress + 96, DstAddress + 96, 32, Dma::DataAlign::Byte) };
+		const_cast<Dma::Descriptor&>(nodes[0]).next = &nodes[1];
+		CHECK(dma.initChannel(1, Dma::Settings(Dma::Direction::MemoryToMemory)));
+		CHECK(dma.submitChain(1, nodes, Dma::ChainCallback_t::bind<Counter, &Counter::onComplete>(&chains)));
+		CHECK(chains.calls == 1);
+		CHECK(std::memcmp(src, dst, 128) == 0);
+
+		// Второй поток: свой порт и свой буфер трассировки
+		Port other;
+		std::thread worker([&other]() {
+			other.init();
+			other.initPin(5, Gpio::Settings().setMode(Gpio::Mode::Output));
+			for (uint32_t i = 0; i < 25; ++i)
+				other.togglePin(5);
+		});
+		worker.join();
+
+		using Trace::Op;
+		CHECK(calls(gpio, Op::GpioInitPin) == 5);
+		CHECK(calls(gpio, Op::GpioSetPin) == 10);
+		CHECK(calls(gpio, Op::GpioResetPin) == 10);
+		CHECK(calls(gpio, Op::GpioTogglePin) == 10);
+		CHECK(calls(gpio, Op::GpioWritePins) == 1);
+		CHECK(calls(gpio, Op::GpioTogglePins) == 1);
+		CHECK(calls(gpio, Op::GpioReadPin) == 4);
+		CHECK(calls(gpio, Op::GpioInterrupt) == edges.calls);
+		CHECK(edges.calls == 4);
+		CHECK(calls(dma, Op::DmaInitChannel) == 2);
+		CHECK(calls(dma, Op::DmaSetDataCount) == 1);
+		CHECK(calls(dma, Op::DmaEnableChannel) >= 1);
+		CHECK(calls(dma, Op::DmaSubmitChain) == 1);
+		CHECK(calls(dma, Op::DmaInterrupt) >= 2);
+		CHECK(calls(other, Op::GpioTogglePin) == 25);
+		CHECK(calls(other, Op::GpioInitPin) == 1);
+		// Каждая область читает время дважды, вложенных областей у setPin нет
+		CHECK(gpio.getTraceCounters().getNanoseconds(Op::GpioSetPin) == 10);
+		CHECK(dma.getTraceCounters().getNanoseconds(Op::DmaEnableChannel) > calls(dma, Op::DmaEnableChannel));
+
+		uint32_t total = 0;
+		for (uint32_t op = 0; op < Trace::OpCount; ++op)
+			total += calls(gpio, static_cast<Op>(op)) + calls(dma, static_cast<Op>(op)) + calls(other, static_cast<Op>(op));
+		std::vector<Event> events;
+		CHECK(parse(Trace::exportChromeTrace(), events));
+		CHECK(events.size() == 2 * total);
+		CHECK(checkPairs(events) == 0);
+		bool second = false;
+		for (const Event& event : events)
+			second = second || event.thread != events.front().thread;
+		CHECK(second);
+
+		gpio.resetTraceCounters();
+		CHECK(calls(gpio, Op::GpioSetPin) == 0);
+	}
+
+	// Переполнение буфера потока: экспортируются последние Capacity записей
+	void checkOverflow() {
+		Trace::clear();
+		Port gpio;
+		gpio.init();
+		gpio.initPin(0, Gpio::Settings().setMode(Gpio::Mode::Output));
+		const uint32_t operations = Trace::ThreadBuffer::Capacity; // Вдвое больше записей, чем помещается
+		for (uint32_t i = 0; i < operations; ++i)
+			gpio.togglePin(0);
+		std::vector<Event> events;
+		CHECK(parse(Trace::exportChromeTrace(), events));
+		CHECK(events.size() == Trace::ThreadBuffer::Capacity);
+		CHECK(checkPairs(events) == 0);
+		CHECK(calls(gpio, Trace::Op::GpioTogglePin) == operations);
+	}
+}
+
+int main() {
+	Trace::setClock(Trace::TraceClock_t::bind(tick));
+	checkOperations();
+	checkOverflow();
+	return CHECK_RESULT();
+}
@@ -0,0 +1,357 @@
+// Транзакции перенастройки порта и каналов DMA на симуляторе: наследники SimGpio и SimDma учитывают записи
+// в каждый регистр (по обработчикам записи драйвера) и их порядок. Проверяется, что commit записывает только
+// регистры с изменившимися полями и не больше одного раза, уровни выходов - до режимов, повторный commit
+// ничего не записывает, а регистры после commit совпадают с целевым снимком. Снимки проходят цикл
+// serialize/deserialize без изменений; данные с чужой меткой, версией, количеством пинов или каналов, усеченные
+// или с недопустимыми значениями полей отвергаются, и снимок при этом не изменяется
+#include <cstring>
+#include <vector>
+#include "Check.hpp"
+#include "SimDma.hpp"
+#include "SimGpio.hpp"
+#include "Transaction.hpp"
+
+using namespace BasePeripheral;
+
+namespace {
+	// Регистры порта, запись в которые учитывается
+	enum GpioRegister { MODER, OTYPER, OSPEEDR, PUPDR, ODR, BSRR, GpioRegistersCount };
+
+	// Порт, учитывающий записи в регистры
+	class CountingGpio : public Sim::SimGpio<> {
+		typedef Sim::SimGpio<> Base;
+
+	public:
+		uint32_t writes[GpioRegistersCount] = {};
+		std::vector<GpioRegister> order;
+
+		void resetCounters() {
+			std::memset(writes, 0, sizeof(writes));
+			order.clear();
+		}
+
+	protected:
+		void record(GpioRegister reg) {
+			++writes[reg];
+			order.push_back(reg);
+		}
+
+		virtual bool onSetSettings(Gpio::pin_number_t pin, const Gpio::Settings& settings) override {
+			record(MODER);
+			record(PUPDR);
+			record(OSPEEDR);
+			record(OTYPER);
+			return Base::onSetSettings(pin, settings);
+		}
+		virtual bool onUpdateSettings(Gpio::pin_number_t pin, const Gpio::Settings& settings) override {
+			return onSetSettings(pin, settings);
+		}
+		virtual bool onApplyImage(const Gpio::PortImage<16>& image) override {
+			typedef Gpio::PortImage<16> Image;
+			if ((image.registers & Image::ModeRegister) != 0)
+				record(MODER);
+			if ((image.registers & Image::PullRegister) != 0)
+				record(PUPDR);
+			if ((image.registers & Image::OutputSpeedRegister) != 0)
+				record(OSPEEDR);
+			if ((image.registers & Image::OutputTypeRegister) != 0)
+				record(OTYPER);
+			return Base::onApplyImage(image);
+		}
+		virtual void onSetPin(Gpio::pin_number_t pin) override { record(BSRR); Base::onSetPin(pin); }
+		virtual void onResetPin(Gpio::pin_number_t pin) override { record(BSRR); Base::onResetPin(pin); }
+		virtual void onSetPull(Gpio::pin_number_t pin, Gpio::Pull pull) override { record(PUPDR); Base::onSetPull(pin, pull); }
+		virtual void onSetMode(Gpio::pin_number_t pin, Gpio::Mode mode) override { record(MODER); Base::onSetMode(pin, mode); }
+		virtual void onSetOutputType(Gpio::pin_number_t pin, Gpio::OutputType outputType) override {
+			record(OTYPER);
+			Base::onSetOutputType(pin, outputType);
+		}
+		virtual void onSetOutputSpeed(Gpio::pin_number_t pin, Gpio::OutputSpeed speed) override {
+			record(OSPEEDR);
+			Base::onSetOutputSpeed(pin, speed);
+		}
+		virtual void onWritePins(const Mask& mask, const Mask& values) override { record(BSRR); Base::onWritePins(mask, values); }
+		virtual void onTogglePins(const Mask& mask) override { record(ODR); Base::onTogglePins(mask); }
+		virtual void onTogglePin(Gpio::pin_number_t pin) override { record(ODR); Base::onTogglePin(pin); }
+	};
+
+	// Регистры канала DMA, запись в которые учитывается
+	enum DmaRegister { CCR, CNDTR, CPAR, CMAR, DmaRegistersCount };
+
+	// Контроллер DMA, учитывающий записи в регистры каналов
+	class CountingDma : public Sim::SimDma<7> {
+		typedef Sim::SimDma<7> Base;
+
+	public:
+		static constexpr uint32_t ChannelsCount = ChannelMaxNumber + 1;
+
+		uint32_t writes[ChannelsCount][DmaRegistersCount] = {};
+
+		void resetCounters() { std::memset(writes, 0, sizeof(writes)); }
+
+		uint32_t total() const {
+			uint32_t sum = 0;
+			for (const auto& channel : writes)
+				for (uint32_t count : channel)
+					sum += count;
+			return sum;
+		}
+
+	protected:
+		virtual bool onSetSettings(Dma::channel_number_t channel, const Dma::Settings& settings) override {
+			++writes[channel][CCR];
+			++writes[channel][CPAR];
+			++writes[channel][CMAR];
+			return Base::onSetSettings(channel, settings);
+		}
+		virtual bool onApplyChannelImage(Dma::channel_number_t channel, const Dma::ChannelImage& image,
+			Dma::address_t periphOrSrcAddr, Dma::address_t memoryOrDstAddr) override {
+			++writes[channel][CCR];
+			++writes[channel][CPAR];
+			++writes[channel][CMAR];
+			return Base::onApplyChannelImage(channel, image, periphOrSrcAddr, memoryOrDstAddr);
+		}
+		virtual bool onApplyChannelFields(Dma::channel_number_t channel, const Dma::ChannelImage& image,
+			Dma::address_t periphOrSrcAddr, Dma::address_t memoryOrDstAddr, uint32_t fields) override {
+			writes[channel][CCR] += (fields & Dma::ChannelField::Control) != 0 ? 1 : 0;
+			writes[channel][CPAR] += (fields & Dma::ChannelField::PeriphOrSrcAddr) != 0 ? 1 : 0;
+			writes[channel][CMAR] += (fields & Dma::ChannelField::MemoryOrDstAddr) != 0 ? 1 : 0;
+			return Base::onApplyChannelFields(channel, image, periphOrSrcAddr, memoryOrDstAddr, fields);
+		}
+		virtual void onSetDirection(Dma::channel_number_t channel, Dma::Direction direction) override {
+			++writes[channel][CCR];
+			Base::onSetDirection(channel, direction);
+		}
+		virtual void onSetMode(Dma::channel_number_t channel, Dma::Mode mode) override {
+			++writes[channel][CCR];
+			Base::onSetMode(channel, mode);
+		}
+		virtual void onSetPriority(Dma::channel_number_t channel, Dma::Priority priority) override {
+			++writes[channel][CCR];
+			Base::onSetPriority(channel, priority);
+		}
+		virtual void onSetMemorySettings(Dma::channel_number_t channel, const Dma::MemorySettings& src,
+			const Dma::MemorySettings& dst) override {
+			++writes[channel][CCR];
+			Base::onSetMemorySettings(channel, src, dst);
+		}
+		virtual void onSetDataCount(Dma::channel_number_t channel, uint32_t count) override {
+			++writes[channel][CNDTR];
+			Base::onSetDataCount(channel, count);
+		}
+	};
+
+	typedef Gpio::PortTransaction<CountingGpio> PortTransaction;
+	typedef Dma::ControllerTransaction<CountingDma> ControllerTransaction;
+
+	bool sameWrites(const uint32_t* writes, const uint32_t* expected, uint32_t count) {
+		return std::memcmp(writes, expected, count * sizeof(uint32_t)) == 0;
+	}
+
+	void checkPortCommit() {
+		CountingGpio gpio;
+		gpio.init();
+		for (Gpio::pin_number_t pin = 0; pin <= CountingGpio::PinMaxNumber; ++pin)
+			gpio.initPin(pin, Gpio::Settings(pin < 8 ? Gpio::Mode::Output : Gpio::Mode::Input));
+		gpio.resetCounters();
+
+		PortTransaction transaction(gpio);
+		CHECK(gpio.order.empty());
+
+		// Пин 9 переводится в режим выхода с высоким уровнем, у пина 2 меняется скорость, у пина 12 - подтяжка,
+		// у пина 4 уровень выхода и режим возвращаются к исходным (изменения нет)
+		transaction.writePin(9, true);
+		transaction.setMode(9, Gpio::Mode::Output);
+		transaction.setOutputSpeed(2, Gpio::OutputSpeed::VeryHigh);
+		transaction.setPull(12, Gpio::Pull::PullUp);
+		transaction.writePin(4, true);
+		transaction.writePin(4, false);
+		transaction.setMode(4, Gpio::Mode::Analog);
+		transaction.setMode(4, Gpio::Mode::Output);
+		CHECK(transaction.changedPins() == (PortTransaction::Mask().set(2).set(9).set(12)));
+		CHECK(transaction.commit());
+		{
+			uint32_t expected[GpioRegistersCount] = {};
+			expected[MODER] = expected[OSPEEDR] = expected[PUPDR] = expected[BSRR] = 1;
+			CHECK(sameWrites(gpio.writes, expected, GpioRegistersCount));
+			CHECK(!gpio.order.empty() && gpio.order.front() == BSRR); // Выходы до режимов
+		}
+		CHECK(PortTransaction::capture(gpio) == transaction.target());
+		CHECK(gpio.getMode(9) == Gpio::Mode::Output && gpio.readPinOutput(9));
+
+		// Повторный commit без изменений ничего не записывает
+		gpio.resetCounters();
+		CHECK(transaction.commit());
+		CHECK(gpio.order.empty());
+
+		// Переключение профилей: меняется только тип выхода одного пина
+		const PortTransaction::Snapshot first = transaction.base();
+		PortTransaction::Snapshot second = first;
+		second.settings.set(5, second.settings.get(5).setOutputType(Gpio::OutputType::OpenDrain));
+		transaction.load(second);
+		CHECK(transaction.commit());
+		{
+			uint32_t expected[GpioRegistersCount] = {};
+			expected[OTYPER] = 1;
+			CHECK(sameWrites(gpio.writes, expected, GpioRegistersCount));
+		}
+		gpio.resetCounters();
+		transaction.load(first);
+		CHECK(transaction.commit());
+		CHECK(gpio.order.size() == 1 && gpio.writes[OTYPER] == 1);
+		CHECK(PortTransaction::capture(gpio) == first);
+
+		// Отмена подготовленных изменений
+		gpio.resetCounters();
+		transaction.setMode(0, Gpio::Mode::Input);
+		transaction.rollback();
+		CHECK(transaction.commit());
+		CHECK(gpio.order.empty());
+	}
+
+	void checkControllerCommit() {
+		using namespace Dma;
+		CountingDma dma;
+		dma.init();
+		const Settings first(Direction::PeriphToMemory, Mode::Circular, Priority::Low,
+			MemorySettings(0x40013804u, DataAlign::HalfWord, IncrementMode::NoIncrement),
+			MemorySettings(0x20000000u, DataAlign::HalfWord, IncrementMode::Increment));
+		const Settings second(Direction::MemoryToMemory, Mode::Normal, Priority::Medium,
+			MemorySettings(0x20001000u, DataAlign::Word, IncrementMode::Increment),
+			MemorySettings(0x20002000u, DataAlign::Word, IncrementMode::Increment));
+		CHECK(dma.initChannel(1, first));
+		CHECK(dma.initChannel(2, second));
+		dma.setDataCount(2, 16);
+		dma.resetCounters();
+
+		ControllerTransaction transaction(dma);
+		CHECK(dma.total() == 0);
+
+		// Канал 1: приоритет (только CCR); канал 2: адрес приемника (только CMAR) и количество элементов
+		transaction.setPriority(1, Priority::High);
+		transaction.setMemorySettings(2, second.getPeriphOrMemToMemSrc(),
+			MemorySettings(0x20003000u, DataAlign::Word, IncrementMode::Increment));
+		transaction.setDataCount(2, 77);
+		transaction.setMode(3, Mode::Circular);
+		transaction.setMode(3, Mode::Normal);
+		CHECK(transaction.changedChannels() == ((1u << 1) | (1u << 2)));
+		CHECK(transaction.commit());
+		{
+			uint32_t expected[CountingDma::ChannelsCount][DmaRegistersCount] = {};
+			expected[1][CCR] = 1;
+			expected[2][CMAR] = 1;
+			expected[2][CNDTR] = 1;
+			CHECK(sameWrites(&dma.writes[0][0], &expected[0][0], CountingDma::ChannelsCount * DmaRegistersCount));
+		}
+		CHECK(ControllerTransaction::capture(dma) == transaction.target());
+		CHECK(dma.getSettings(1).getPriority() == Priority::High);
+		CHECK(dma.getSettings(2).getMemoryOrMemToMemDst().getAddr() == 0x20003000u);
+		CHECK(dma.getDataCount(2) == 77);
+
+		dma.resetCounters();
+		CHECK(transaction.commit());
+		CHECK(dma.total() == 0);
+
+		// Переключение профилей: меняется только адрес источника канала 2
+		const ControllerTransaction::Snapshot profile = transaction.base();
+		ControllerTransaction::Snapshot other = profile;
+		other.channels[2].periphOrSrcAddr = 0x20004000u;
+		transaction.load(other);
+		CHECK(transaction.commit());
+		CHECK(dma.total() == 1 && dma.writes[2][CPAR] == 1);
+		CHECK(ControllerTransaction::capture(dma) == other);
+	}
+
+	// Снимок порта: цикл serialize/deserialize и отказ от недопустимых данных
+	void checkPortSnapshot() {
+		typedef Gpio::PortSnapshot<16> Snapshot;
+		Snapshot snapshot;
+		for (Gpio::pin_number_t pin = 0; pin < 16; ++pin)
+			snapshot.settings.set(pin, Gpio::Settings(static_cast<Gpio::Mode>(pin % 4), static_cast<Gpio::Pull>(pin % 3),
+				static_cast<Gpio::OutputType>(pin % 2), static_cast<Gpio::OutputSpeed>((pin / 4) % 4)));
+		snapshot.outputs = Snapshot().outputs.set(1).set(7).set(8).set(15);
+
+		uint8_t data[Snapshot::SerializedSize + 1];
+		CHECK(Snapshot::SerializedSize == 22);
+		CHECK(snapshot.serialize(data, Snapshot::SerializedSize - 1) == 0);
+		CHECK(snapshot.serialize(data, sizeof(data)) == Snapshot::SerializedSize);
+		Snapshot restored;
+		CHECK(restored.deserialize(data, Snapshot::SerializedSize));
+		CHECK(restored == snapshot);
+
+		// Искаженные копии: метка, версия, количество пинов, размер, подтяжка 3, тип выхода 2
+		const auto rejected = [&](size_t offset, uint8_t value, size_t size) {
+			uint8_t corrupted[sizeof(data)];
+			std::memcpy(corrupted, data, sizeof(data));
+			corrupted[offset] = value;
+			Snapshot target;
+			const Snapshot before = target;
+			return !target.deserialize(corrupted, size) && target == before;
+		};
+		CHECK(rejected(0, SnapshotFormat::DmaTag, Snapshot::SerializedSize));
+		CHECK(rejected(1, SnapshotFormat::Version + 1, Snapshot::SerializedSize));
+		CHECK(rejected(2, 8, Snapshot::SerializedSize));
+		CHECK(rejected(0, SnapshotFormat::GpioTag, Snapshot::SerializedSize - 1));
+		CHECK(rejected(SnapshotFormat::HeaderSize + 3, static_cast<uint8_t>(3u << Gpio::Settings::PullPos), Snapshot::SerializedSize));
+		CHECK(rejected(SnapshotFormat::HeaderSize + 15, static_cast<uint8_t>(2u << Gpio::Settings::OutputTypePos),
+			Snapshot::SerializedSize));
+		CHECK(!rejected(SnapshotFormat::HeaderSize + 15, static_cast<uint8_t>(3u << Gpio::Settings::ModePos), Snapshot::SerializedSize));
+	}
+
+	// Снимок каналов DMA: цикл serialize/deserialize и отказ от недопустимых данных
+	void checkControllerSnapshot() {
+		using namespace Dma;
+		typedef ControllerSnapshot<7> Snapshot;
+		Snapshot snapshot;
+		for (uint32_t channel = 0; channel < 7; ++channel) {
+			const Settings settings(static_cast<Direction>(channel % 3), static_cast<Mode>(channel % 2),
+				static_cast<Priority>(channel % 4),
+				MemorySettings(0x40000000u + channel * 0x400u, static_cast<DataAlign>(channel % 3), IncrementMode::NoIncrement),
+				MemorySettings(0x20000000u + channel * 0x100u, static_cast<DataAlign>((channel + 1) % 3), IncrementMode::Increment));
+			snapshot.channels[channel].control = ChannelImage::fromSettings(settings).control;
+			snapshot.channels[channel].periphOrSrcAddr = settings.getPeriphOrMemToMemSrc().getAddr();
+			snapshot.channels[channel].memoryOrDstAddr = settings.getMemoryOrMemToMemDst().getAddr();
+			snapshot.channels[channel].count = 100 + channel;
+			CHECK(ChannelImage::isValid(snapshot.channels[channel].control));
+		}
+
+		uint8_t data[Snapshot::SerializedSize];
+		CHECK(snapshot.serialize(data, sizeof(data) - 1) == 0);
+		CHECK(snapshot.serialize(data, sizeof(data)) == Snapshot::SerializedSize);
+		Snapshot restored;
+		CHECK(restored.deserialize(data, sizeof(data)));
+		CHECK(restored == snapshot);
+
+		// Искаженные копии: метка, версия, количество каналов, размер и управляющий регистр канала 3
+		const size_t control = SnapshotFormat::HeaderSize + 3 * Snapshot::ChannelSize;
+		const auto rejected = [&](size_t offset, uint32_t value, size_t size, bool word) {
+			uint8_t corrupted[sizeof(data)];
+			std::memcpy(corrupted, data, sizeof(data));
+			if (word)
+				SnapshotFormat::store32(corrupted + offset, value);
+			else
+				corrupted[offset] = static_cast<uint8_t>(value);
+			Snapshot target;
+			const Snapshot before = target;
+			return !target.deserialize(corrupted, size) && target == before;
+		};
+		const uint32_t valid = snapshot.channels[3].control;
+		CHECK(rejected(0, SnapshotFormat::GpioTag, sizeof(data), false));
+		CHECK(rejected(1, 0, sizeof(data), false));
+		CHECK(rejected(2, 6, sizeof(data), false));
+		CHECK(rejected(0, SnapshotFormat::DmaTag, sizeof(data) - 1, false));
+		CHECK(rejected(control, valid | (3u << ChannelImage::PsizePos), sizeof(data), true));
+		CHECK(rejected(control, valid | (3u << ChannelImage::MsizePos), sizeof(data), true));
+		CHECK(rejected(control, valid | (1u << ChannelImage::DirPos) | (1u << ChannelImage::Mem2MemPos), sizeof(data), true));
+		CHECK(rejected(control, valid | Sim::DmaCcr::EN, sizeof(data), true));
+		CHECK(!rejected(control, valid | (3u << ChannelImage::PlPos), sizeof(data), true));
+	}
+}
+
+int main() {
+	checkPortCommit();
+	checkControllerCommit();
+	checkPortSnapshot();
+	checkControllerSnapshot();
+	return CHECK_RESULT();
+}